@@ -1,5 +1,5 @@
-import { useState, useEffect } from 'react'
-import { MapContainer, TileLayer, Marker, Popup } from 'react-leaflet'
+import { useState, useEffect, useRef } from 'react'
+import { MapContainer, TileLayer, Marker, Popup, useMapEvents } from 'react-leaflet'
 import 'leaflet/dist/leaflet.css' // <--- MUST BE HERE
 import L from 'leaflet';
 import './App.css'; // <--- Ensure this is imported
@@ -17,37 +17,144 @@ let DefaultIcon = L.icon({
 L.Marker.prototype.options.icon = DefaultIcon;
 // --------------------------------------------
 
+// --- Binary feed decoder (server side: include/WireFormat.h) ---
+// Frame: u8 version | records; record: varint handle, varint mask, fields in mask.
+// Numbers are zig-zag varint deltas against the vessel's previous state.
+const WIRE_VERSION = 1;
+const F = { LAT: 1, LON: 2, TIME: 4, SPEED: 8, COURSE: 16, ALT: 32, SATS: 64, VALID: 128, TYPE: 256, NAME: 512 };
+const NUMERIC = [
+  [F.LAT, 'latE7'], [F.LON, 'lonE7'], [F.TIME, 'timeMs'], [F.SPEED, 'speed'],
+  [F.COURSE, 'course'], [F.ALT, 'altDm'], [F.SATS, 'sats'], [F.VALID, 'valid'],
+];
+const textDecoder = new TextDecoder();
+
+// Applies one frame to 'vessels' (handle -> state) and returns the updates in the JSON
+// feed's shape, so the rest of the app doesn't care which protocol is in use
+function decodeBinaryFrame(buffer, vessels) {
+  const bytes = new Uint8Array(buffer);
+  let pos = 0;
+  // Plain arithmetic, not bit ops: deltas can exceed 32 bits
+  const uvarint = () => {
+    let value = 0, scale = 1, b;
+    do {
+      if (pos >= bytes.length) throw new Error('Truncated frame');
+      b = bytes[pos++];
+      value += (b & 0x7f) * scale;
+      scale *= 128;
+    } while (b & 0x80);
+    return value;
+  };
+  const varint = () => { const z = uvarint(); return z % 2 ? -(z + 1) / 2 : z / 2; };
+  const string = () => {
+    const n = uvarint();
+    const s = textDecoder.decode(bytes.subarray(pos, pos + n));
+    pos += n;
+    return s;
+  };
+
+  if (bytes[pos++] !== WIRE_VERSION) throw new Error('Unknown frame version');
+  const updates = [];
+  while (pos < bytes.length) {
+    const handle = uvarint();
+    const mask = uvarint();
+    let v = vessels.get(handle);
+    if (mask & F.NAME) {
+      v = { id: string(), type: '', latE7: 0, lonE7: 0, timeMs: 0, speed: 0, course: 0, altDm: 0, sats: 0, valid: 0 };
+      vessels.set(handle, v);
+    } else if (!v) {
+      throw new Error(`Delta for unknown vessel handle ${handle}`);
+    }
+    if (mask & F.TYPE) v.type = string();
+    for (const [bit, key] of NUMERIC) {
+      if (mask & bit) v[key] += varint();
+    }
+    updates.push({
+      type: v.type, timestamp: v.timeMs / 1000, isValid: v.valid === 1, id: v.id,
+      lat: v.latE7 / 1e7, lon: v.lonE7 / 1e7, speed: v.speed / 100, course: v.course / 100,
+      sats: v.sats, alt: v.altDm / 10,
+    });
+  }
+  return updates;
+}
+
+// --- Viewport subscription: the server only sends vessels inside the (padded) map view ---
+function sendViewport(ws, bounds) {
+  if (!ws || !bounds || ws.readyState !== WebSocket.OPEN) return;
+  const b = bounds.pad(0.25); // Panning a little shows vessels that are already known
+  ws.send(JSON.stringify({ subscribe: { bbox: [b.getWest(), b.getSouth(), b.getEast(), b.getNorth()] } }));
+}
+
+function ViewportTracker({ onChange }) {
+  const map = useMapEvents({ moveend: () => onChange(map.getBounds()) });
+  useEffect(() => onChange(map.getBounds()), [map, onChange]);
+  return null;
+}
+
 function App() {
   const [fleet, setFleet] = useState({});
   const [connected, setConnected] = useState(false);
+  const wsRef = useRef(null);
+  const viewRef = useRef(null);
+  const onViewport = useRef((bounds) => {
+    viewRef.current = bounds;
+    sendViewport(wsRef.current, bounds);
+  }).current;
 
   useEffect(() => {
     const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
     // Use window.location.hostname to work inside Docker/Localhost automatically
     const ws = new WebSocket(`${protocol}//${window.location.hostname}:8080/ws`);
+    wsRef.current = ws;
+
+    ws.binaryType = 'arraybuffer';
+    // Compact binary frames unless the page is opened with ?json
+    let binary = !new URLSearchParams(window.location.search).has('json');
+    const vessels = new Map(); // Binary decoder state: handle -> last decoded values
 
-    ws.onopen = () => setConnected(true);
+    ws.onopen = () => {
+      setConnected(true);
+      ws.send(JSON.stringify({ flow: 'ack' })); // Pace the feed by our acks (below)
+      if (binary) ws.send(JSON.stringify({ protocol: 'binary' }));
+      sendViewport(ws, viewRef.current);
+    };
     ws.onclose = () => setConnected(false);
 
     ws.onmessage = (event) => {
       try {
-        const data = JSON.parse(event.data);
-        
-        // Handle case sensitivity (C++ sometimes serializes as uppercase depending on the struct)
-        const id = data.id || data.ID || data.sourceID; 
-
-        if (id) {
-          // Normalize the data so the rest of the app uses lowercase 'id'
-          const normalizedData = { ...data, id: id };
-          
-          setFleet(prev => ({
-            ...prev,
-            [id]: normalizedData
-          }));
+        let updates;
+        if (event.data instanceof ArrayBuffer) {
+          updates = decodeBinaryFrame(event.data, vessels);
         } else {
-            console.warn("Received JSON without an ID:", data);
+          // Frames are arrays of the newest update per vessel (a single object is accepted too)
+          const parsed = JSON.parse(event.data);
+          updates = Array.isArray(parsed) ? parsed : [parsed];
+        }
+
+        setFleet(prev => {
+          const next = { ...prev };
+          for (const data of updates) {
+            // Handle case sensitivity (C++ sometimes serializes as uppercase depending on the struct)
+            const id = data.id || data.ID || data.sourceID;
+
+            if (id) {
+              // Normalize the data so the rest of the app uses lowercase 'id'
+              next[id] = { ...data, id: id };
+            } else {
+              console.warn("Received JSON without an ID:", data);
+            }
+          }
+          return next;
+        });
+      } catch (e) {
+        console.error(e);
+        // Lost track of the binary delta state: fall back to JSON for this connection
+        if (binary && ws.readyState === WebSocket.OPEN) {
+          binary = false;
+          ws.send(JSON.stringify({ protocol: 'json' }));
         }
-      } catch (e) { console.error(e); }
+      }
+      // Flow control: the server only sends a few frames ahead of our acks
+      if (ws.readyState === WebSocket.OPEN) ws.send('ack');
     };
     return () => ws.close();
   }, []);
@@ -86,6 +193,7 @@ function App() {
           attribution='&copy; OpenStreetMap'
           url="https://{s}.tile.openstreetmap.org/{z}/{x}/{y}.png"
         />
+        <ViewportTracker onChange={onViewport} />
         
         {ships.map(ship => (
           <Marker key={ship.id} position={[ship.lat, ship.lon]}>
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+// 1. The Vessel Record
+// Latest known state for one MMSI, merged from position (1/2/3/18/19) and
+// static (5/19/24) reports. Fixed-size text fields keep updates allocation-free.
+struct AISVessel {
+    uint32_t mmsi = 0;
+
+    // Dynamic data
+    bool hasPosition = false;
+    char positionClass = 'A';     // 'A' (types 1/2/3) or 'B' (types 18/19)
+    int32_t latitudeE7 = 0;       // 1e-7 degrees, same units as GPSData
+    int32_t longitudeE7 = 0;
+    double speed = 0.0;           // Knots over ground
+    double course = 0.0;          // Degrees True over ground
+    int heading = 511;            // Degrees True, 511 = not available
+    int navStatus = 15;           // 15 = not defined
+    int rateOfTurn = -128;        // Raw ROT indicator, -128 = not available
+    uint64_t positionTimeMs = 0;  // Receive time of the last position
+
+    // Static and voyage data
+    bool hasStatic = false;
+    uint32_t imo = 0;
+    int shipType = 0;
+    int toBow = 0, toStern = 0, toPort = 0, toStarboard = 0; // Meters from the GPS antenna
+    double draught = 0.0;         // Meters
+    char name[21] = {};
+    char callsign[8] = {};
+    char destination[21] = {};
+    uint64_t staticTimeMs = 0;
+};
+
+// 2. The Decoder
+// Handles !AIVDM/!AIVDO payloads: 6-bit armor decoding with a lookup table,
+// multi-fragment reassembly in a fixed slot pool (bounded memory, timeouts),
+// and per-MMSI vessel records. Nothing on the decode path allocates except the
+// first time a new MMSI is seen.
+class AISDecoder {
+public:
+    static constexpr size_t MAX_PENDING = 16;          // Concurrent multi-fragment messages
+    static constexpr size_t MAX_PAYLOAD_CHARS = 360;   // 6 fragments of 60 chars (2160 bits)
+    static constexpr uint64_t DEFAULT_TIMEOUT_MS = 2000;
+
+    // What a fragment produced
+    enum class Update { None, Position, Static };
+
+    struct Stats {
+        uint64_t messages = 0;          // Complete messages decoded
+        uint64_t fragmentsDropped = 0;  // Out of order, evicted or superseded fragments
+        uint64_t timeouts = 0;          // Partial messages expired
+        uint64_t errors = 0;            // Malformed fields, bad armor or short payloads
+        uint64_t unsupported = 0;       // Valid messages of types we don't decode
+    };
+
+    explicit AISDecoder(uint64_t fragmentTimeoutMs = DEFAULT_TIMEOUT_MS)
+        : timeoutMs(fragmentTimeoutMs) {
+        vessels_.reserve(1024);
+    }
+
+    // Feeds the fields of one VDM/VDO sentence:
+    // !AIVDM,<fragCount>,<fragNum>,<seqId>,<channel>,<payload>,<fillBits>*hh
+    // On Position/Static, 'vessel' points at the updated record.
+    Update decodeFragment(std::string_view fragCount, std::string_view fragNum,
+                          std::string_view seqId, std::string_view channel,
+                          std::string_view payload, std::string_view fillBits,
+                          uint64_t nowMs, const AISVessel*& vessel);
+
+    // Convenience: checksum, tokenize and decode a whole sentence
+    Update decodeSentence(std::string_view sentence, uint64_t nowMs, const AISVessel*& vessel);
+
+    const AISVessel* find(uint32_t mmsi) const;
+    const std::unordered_map<uint32_t, AISVessel>& vessels() const { return vessels_; }
+    const Stats& stats() const { return stats_; }
+
+    // Armor character -> 6-bit value (0xFF = not a valid armor character)
+    static uint8_t armorValue(char c);
+
+private:
+    // One multi-fragment message being reassembled
+    struct Slot {
+        bool active = false;
+        int seqId = -1;
+        char channel = 0;
+        int fragCount = 0;
+        int nextFrag = 0;
+        uint64_t startedMs = 0;
+        size_t length = 0;
+        std::array<char, MAX_PAYLOAD_CHARS> chars{};
+    };
+
+    uint64_t timeoutMs;
+    std::array<Slot, MAX_PENDING> slots{};
+    std::unordered_map<uint32_t, AISVessel> vessels_;
+    Stats stats_;
+
+    void expireSlots(uint64_t nowMs);
+    Slot* findSlot(int seqId, char channel, int fragCount);
+    Slot* claimSlot();
+    Update decodePayload(std::string_view payload, int fillBits, uint64_t nowMs, const AISVessel*& vessel);
+};
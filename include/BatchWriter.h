@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "RingQueue.h"
+
+// Batch Writer Thread
+// The producer/writer split behind the capture recorder and both track loggers. push()
+// only enqueues into a bounded RingQueue (full: the item is dropped and counted, ingest
+// never waits); one writer thread pops batches and hands them to the owner's callback.
+//
+// stop() wakes the writer, which exits only once the queue is empty, so everything pushed
+// before stop() reaches the callback; then the owner's onStop runs on the writer thread.
+template <typename T>
+class BatchWriter {
+public:
+    // Writer thread. n == 0 is an idle wake-up (about every 20 ms), so time-based flushes
+    // still happen without traffic.
+    using BatchFn = std::function<void(T* items, size_t n)>;
+    using DoneFn = std::function<void()>;
+
+    BatchWriter(size_t capacity, size_t batchSize)
+        : queue(capacity, OverflowPolicy::DropNewest), batchSize(std::max<size_t>(1, batchSize)) {}
+    ~BatchWriter() { stop(); }
+
+    BatchWriter(const BatchWriter&) = delete;
+    BatchWriter& operator=(const BatchWriter&) = delete;
+
+    // No-op if already running
+    void start(BatchFn onBatch, DoneFn onStop = nullptr) {
+        if (writer.joinable()) return;
+        stopping = false;
+        writer = std::thread([this, batch = std::move(onBatch), done = std::move(onStop)] {
+            run(batch);
+            if (done) done();
+        });
+    }
+
+    // PRODUCER: any thread, never blocks. False if the queue was full.
+    bool push(T&& item) {
+        bool ok = queue.push(std::move(item));
+        if (sleeping.load()) cv.notify_one();
+        return ok;
+    }
+
+    // Delivers everything pushed so far, runs onStop, joins. Idempotent.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_one();
+        if (writer.joinable()) writer.join();
+    }
+
+    bool running() const { return writer.joinable(); }
+    typename RingQueue<T>::Stats queueStats() const { return queue.stats(); }
+
+private:
+    RingQueue<T> queue;
+    size_t batchSize;
+    std::thread writer;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> sleeping{false};
+    std::mutex mtx; // Only for sleeping on cv
+    std::condition_variable cv;
+
+    void run(const BatchFn& onBatch) {
+        std::vector<T> batch(batchSize);
+        for (;;) {
+            size_t n = queue.popN(batch.data(), batch.size());
+            onBatch(batch.data(), n);
+            if (n > 0) continue;
+
+            // Re-check after seeing stop: the last pushes may have landed after our pop
+            if (stopping && queue.empty()) break;
+            sleeping.store(true);
+            if (queue.empty()) {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait_for(lock, std::chrono::milliseconds(20), [this] { return stopping.load(); });
+            }
+            sleeping.store(false);
+        }
+    }
+};
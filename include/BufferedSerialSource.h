@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <termios.h>
+#include "NMEASource.h"
+
+// Buffered Serial Source
+// Raw-mode UART reader for high-rate GNSS/AIS receivers (4800 - 921600 baud).
+// Bytes arrive in bulk reads into a ring buffer, and VMIN/VTIME let the driver
+// collect a burst before waking us. readLine() and readChunk() are served from
+// that ring, so nothing costs one syscall per character.
+class BufferedSerialSource : public IPollableSource {
+public:
+    struct Config {
+        std::string device;
+        int baud = 4800;           // NMEA 0183 default; AIS is 38400, modern GNSS up to 921600
+        // Blocking reads return once 'vmin' bytes arrived, or 'vtimeDs' tenths of a second
+        // after the line goes quiet. Ignored when the reactor puts the port in O_NONBLOCK.
+        uint8_t vmin = 64;
+        uint8_t vtimeDs = 1;
+        size_t ringBytes = 64 * 1024;
+    };
+
+    struct Stats {
+        uint64_t bytes = 0;          // Bytes read from the port
+        uint64_t reads = 0;          // read() calls that returned data
+        uint64_t overruns = 0;       // UART/driver overruns (TIOCGICOUNT; 0 where unsupported)
+        uint64_t frameErrors = 0;
+        uint64_t parityErrors = 0;
+        uint64_t breaks = 0;
+        uint64_t ringOverflows = 0;  // Bytes dropped because the ring was full
+    };
+
+    explicit BufferedSerialSource(Config config);
+    BufferedSerialSource(std::string device, int baud) : BufferedSerialSource(Config{std::move(device), baud}) {}
+    ~BufferedSerialSource() override;
+
+    bool open() override;
+    void close() override;
+
+    std::string readLine() override;                 // One line, CR/LF stripped
+    size_t readChunk(char* buf, size_t cap) override;
+
+    int fd() const override { return serial_fd; }
+    ReadResult tryRead(char* buf, size_t cap, size_t& n) override;
+    bool hasBuffered() const override { return head != tail; }
+
+    // Refreshes the hardware error counters before returning them
+    const Stats& stats();
+
+    // Maps a numeric baud rate to its termios constant; false if the platform lacks it
+    static bool baudConstant(int baud, speed_t& out);
+
+private:
+    Config config;
+    int serial_fd = -1;
+
+    // Byte ring: head = next byte to hand out, tail = next free slot (both free-running)
+    std::unique_ptr<char[]> ring;
+    size_t mask = 0;
+    size_t head = 0;
+    size_t tail = 0;
+
+    Stats stats_;
+    bool haveBaseline = false;
+    Stats baseline;               // Hardware counters at open(), so stats start at zero
+
+    // Reads once from the port into the ring: >0 bytes, 0 EOF, -1 error (errno set)
+    ssize_t fill();
+    size_t take(char* buf, size_t cap);
+    void readHardwareCounters(Stats& out) const;
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BatchWriter.h"
+#include "RawPacket.h"
+
+// Raw Capture ("black box") file format
+//
+// A capture is a directory of segments. Each segment is an append-only data file plus a
+// sparse time index:
+//
+//   capture-<first ns>.nmeacap   "NMEACAP1" then blocks:
+//       BlockHeader | stored bytes (raw or compressed)
+//   capture-<first ns>.idx       one IndexEntry per block (first time -> file offset)
+//
+// A block holds many records: u64 receivedNs, u16 source length, u32 byte length,
+// source ID, bytes. Blocks are the unit of compression and of index granularity, so a
+// time window is found with a binary search over the index, never a scan.
+namespace CaptureFormat {
+    constexpr char FILE_MAGIC[8] = {'N', 'M', 'E', 'A', 'C', 'A', 'P', '1'};
+    constexpr uint32_t BLOCK_MAGIC = 0x314B4C42; // "BLK1"
+
+    // Block codecs (LZ4/zstd values are reserved for builds that ship those libraries)
+    enum class Codec : uint8_t { None = 0, Zlib = 1, LZ4 = 2, Zstd = 3 };
+
+#pragma pack(push, 1)
+    struct BlockHeader {
+        uint32_t magic;
+        uint8_t codec;
+        uint8_t reserved[3];
+        uint32_t rawBytes;
+        uint32_t storedBytes;
+        uint32_t records;
+        uint64_t firstNs;
+        uint64_t lastNs;
+        uint32_t crc;        // CRC-32 of the stored bytes
+    };
+    struct IndexEntry {
+        uint64_t firstNs;
+        uint64_t offset;     // Of the BlockHeader in the data file
+    };
+#pragma pack(pop)
+
+    uint32_t crc32(const void* data, size_t len);
+    bool codecAvailable(Codec codec);
+}
+
+// Capture Recorder
+// Takes every raw chunk as received (source ID, kernel timestamp, bytes) and appends it to
+// segmented capture files. record() only enqueues; a dedicated writer thread batches
+// packets into blocks, compresses them and writes, so disk latency never reaches ingest.
+class CaptureRecorder {
+public:
+    struct Config {
+        std::string directory = "capture";
+        size_t blockBytes = 64 * 1024;               // Raw bytes per block (index granularity)
+        uint64_t segmentBytes = 256ull << 20;        // Start a new segment after this many stored bytes
+        std::chrono::milliseconds flushInterval{1000}; // Write a partial block when idle this long
+        CaptureFormat::Codec codec = CaptureFormat::Codec::None;
+        size_t queueCapacity = 65536;                // Packets waiting for the writer
+    };
+
+    struct Stats {
+        uint64_t packets = 0;       // Packets written
+        uint64_t bytesIn = 0;       // Payload bytes written
+        uint64_t bytesStored = 0;   // Bytes on disk (headers + compressed blocks)
+        uint64_t blocks = 0;
+        uint64_t segments = 0;
+        uint64_t dropped = 0;       // Queue full: writer could not keep up
+        uint64_t writeErrors = 0;
+    };
+
+    explicit CaptureRecorder(Config config);
+    ~CaptureRecorder();
+
+    bool start();
+    // Writes everything queued, closes the segment
+    void stop();
+
+    // PRODUCER: any thread, never blocks
+    void record(std::string_view sourceID, uint64_t receivedNs, std::string_view bytes);
+    void record(RawPacket packet);
+
+    Stats stats() const;
+
+private:
+    Config config;
+    BatchWriter<RawPacket> writer;
+    bool started = false;
+
+    // Writer thread state
+    int datafd = -1;
+    int indexfd = -1;
+    uint64_t segmentStored = 0;
+    std::string block;                 // Raw records of the open block
+    std::string stored;                // Compression output
+    uint32_t blockRecords = 0;
+    uint64_t blockFirstNs = 0;
+    uint64_t blockLastNs = 0;
+    std::chrono::steady_clock::time_point blockStarted;
+
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesStored{0};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> segments{0};
+    std::atomic<uint64_t> writeErrors{0};
+
+    void writeBatch(RawPacket* packets, size_t n);
+    void append(const RawPacket& packet);
+    void flushBlock();
+    bool openSegment(uint64_t firstNs);
+    void closeSegment();
+    bool writeAll(int fd, const void* data, size_t len);
+};
+
+// Capture Reader: locate a time window via the index, then iterate packets
+class CaptureReader {
+public:
+    // Lists the segments of a capture directory in time order
+    static std::vector<std::string> segments(const std::string& directory);
+
+    bool open(const std::string& segmentPath);
+    void close();
+    ~CaptureReader() { close(); }
+
+    // Positions on the first block that may contain 'ns' (binary search on the index)
+    bool seek(uint64_t ns);
+    // Next packet in file order; false at the end or on a corrupt block
+    bool next(RawPacket& packet);
+
+    size_t indexEntries() const { return index.size(); }
+
+private:
+    int datafd = -1;
+    std::vector<CaptureFormat::IndexEntry> index;
+    std::string block;                 // Decoded records of the current block
+    size_t blockPos = 0;
+    uint64_t offset = 0;               // Next block header
+
+    bool loadBlock();
+};
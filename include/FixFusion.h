@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "NMEAParser.h"
+
+// Per-Epoch Fix Fusion
+// A receiver sends GGA (altitude, satellites, quality) and RMC (speed, course, date)
+// for the same instant. This stage merges everything one source reports for one UTC
+// time into a single complete GPSData, so subscribers see one event per fix instead
+// of two half-empty ones.
+//
+// An epoch is emitted as soon as both GGA and RMC have arrived, when the source moves
+// on to a newer UTC time (rollover), or when it has been pending longer than the timeout.
+// Non-fusable sentences (e.g. AIS) pass straight through.
+class FixFusion {
+public:
+    using FixCallback = std::function<void(const GPSData&)>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t sentencesIn = 0;   // Sentences accepted by add()
+        uint64_t fixesOut = 0;      // Events emitted (fused or passed through)
+        uint64_t complete = 0;      // Epochs emitted because GGA + RMC both arrived
+        uint64_t rollovers = 0;     // Epochs emitted because a newer time arrived
+        uint64_t timeouts = 0;      // Epochs emitted by poll() after the timeout
+    };
+
+    explicit FixFusion(std::chrono::milliseconds timeout = std::chrono::milliseconds(200))
+        : timeout(timeout) {}
+
+    // Where fused fixes go (usually NMEAParser::notifyListeners)
+    void onFix(FixCallback cb) { output = std::move(cb); }
+
+    // Feed one decoded sentence; 'data.ID' must already identify the source
+    void add(const GPSData& data, Clock::time_point now = Clock::now());
+
+    // Emit epochs pending longer than the timeout (call regularly from the consumer loop)
+    void poll(Clock::time_point now = Clock::now());
+
+    // Emit everything still pending (shutdown)
+    void flush();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    // Bits in Pending::seen
+    static constexpr unsigned SEEN_GGA = 1;
+    static constexpr unsigned SEEN_RMC = 2;
+
+    struct Pending {
+        GPSData fix;
+        int64_t epochMs = 0;          // UTC time of the epoch in milliseconds
+        unsigned seen = 0;            // SEEN_* bits
+        Clock::time_point started;
+        bool active = false;
+    };
+
+    std::chrono::milliseconds timeout;
+    FixCallback output;
+    std::unordered_map<std::string, Pending> pending; // Keyed by source ID
+    Stats stats_;
+
+    void emit(Pending& p);
+    static void merge(GPSData& fused, const GPSData& part, unsigned kind, unsigned seen);
+};
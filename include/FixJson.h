@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "NMEAParser.h"
+
+// Allocation-free GPSData -> JSON
+// Emits exactly what GPSDataToJson() (nlohmann to_json + dump) produces: keys in the same
+// sorted order, doubles in the same round-trip form ("10.0", "0.0001", "1e-05", NaN/inf as
+// null), the same string escapes. No DOM and no temporaries: integers go through
+// std::to_chars, doubles through the Grisu2 formatter dump() itself uses, straight into a
+// buffer that keeps its capacity, so the steady state allocates nothing.
+//
+// Strings are expected to be UTF-8 (source IDs, sentence types); invalid bytes are passed
+// through where nlohmann would throw.
+namespace FixJson {
+    // Appends one fix object to 'out'
+    void append(std::string& out, const GPSData& fix);
+
+    // One fix, in a thread-local buffer: valid until the next call on this thread
+    std::string_view write(const GPSData& fix);
+
+    // "[fix,fix,...]" in the same thread-local buffer
+    std::string_view writeArray(const GPSData* fixes, size_t count);
+}
@@ -2,6 +2,7 @@
 #include <ncurses.h>
 #include <string>
 #include <map>
+#include <mutex>
 #include "NMEAParser.h"
 
 class GPSDashboard {
@@ -9,6 +10,9 @@ private:
     // Store the latest state for every vessel ID
     std::map<std::string, GPSData> fleet;
 
+    // NCurses is not thread-safe and fixes arrive from several parser workers
+    std::mutex mtx;
+
 public:
     GPSDashboard() {
         // 1. Initialize NCurses
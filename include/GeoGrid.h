@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform lat/lon grid of points
+// Buckets IDs by fixed-size cells so "what lies inside this box" costs the cells the box
+// covers (or the occupied cells, whichever is fewer) instead of a scan over every point.
+// Not thread-safe: the owner serializes access.
+class GeoGrid {
+public:
+    // Degrees. west > east means the box crosses the antimeridian.
+    struct Box {
+        double south = -90.0, west = -180.0, north = 90.0, east = 180.0;
+        bool contains(double lat, double lon) const;
+    };
+
+    // A box from map bounds in GeoJSON order (west > east crosses the antimeridian).
+    // Longitudes may run past +-180, as a zoomed-out web map reports them, and are wrapped.
+    // Returns false for a malformed box.
+    static bool makeBox(double west, double south, double east, double north, Box& out);
+
+    explicit GeoGrid(double cellDeg = 0.5);
+
+    // Adds the point or moves it
+    void insert(uint32_t id, double lat, double lon);
+    void erase(uint32_t id);
+    void clear();
+    size_t size() const { return points.size(); }
+
+    // Appends the ID of every point inside 'box' to 'out'
+    void query(const Box& box, std::vector<uint32_t>& out) const;
+
+private:
+    struct Point {
+        uint64_t cell;
+        double lat, lon;
+    };
+
+    double cellDeg;
+    uint32_t rows, cols;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells; // Occupied cells only
+    std::unordered_map<uint32_t, Point> points;
+
+    uint32_t row(double lat) const;
+    uint32_t col(double lon) const;
+    void queryRange(const Box& box, double west, double east, std::vector<uint32_t>& out) const;
+};
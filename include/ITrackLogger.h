@@ -0,0 +1,15 @@
+#pragma once
+#include "NMEAParser.h"
+
+// Abstract Base Class for fix persistence backends (SQLiteLogger, TrackColumnStore)
+// Both take fixes from parser threads without blocking and write from their own thread.
+class ITrackLogger {
+public:
+    virtual ~ITrackLogger() = default;
+
+    // Any thread, never blocks on the disk
+    virtual void log(const GPSData& data) = 0;
+
+    // Writes everything logged so far and stops the writer (idempotent)
+    virtual void stop() = 0;
+};
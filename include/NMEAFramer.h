@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Incremental Sentence Framer
+// Turns arbitrary byte chunks (partial reads, multi-sentence datagrams, noisy serial lines)
+// into complete sentences. It is a resumable state machine: feed it whatever the source
+// returned and it emits each sentence once its terminator arrives.
+//
+// Emitted views point into the caller's chunk whenever the sentence lies entirely inside it
+// (zero copy), and into the framer's own buffer when it spans chunks. Either way the view is
+// only valid for the duration of the callback.
+class NMEAFramer {
+public:
+    // NMEA 0183: at most 82 characters including the start character and CR/LF
+    static constexpr size_t MAX_SENTENCE_BYTES = 82;
+
+    struct Stats {
+        uint64_t sentences = 0;      // Complete sentences emitted
+        uint64_t framingErrors = 0;  // Overlong, truncated or garbage-interrupted frames
+        uint64_t bytesDiscarded = 0; // Bytes dropped while resyncing
+    };
+
+    explicit NMEAFramer(size_t maxSentenceBytes = MAX_SENTENCE_BYTES)
+        : maxBody(maxSentenceBytes > 2 ? maxSentenceBytes - 2 : 1) {
+        pending.reserve(maxBody);
+    }
+
+    // Feed one chunk; 'onSentence(std::string_view)' fires for each completed sentence
+    // (start character included, CR/LF stripped)
+    template <typename Callback>
+    void feed(const char* data, size_t len, Callback&& onSentence) {
+        size_t segStart = 0; // Where the current sentence's bytes begin inside this chunk
+
+        for (size_t i = 0; i < len; ++i) {
+            char c = data[i];
+
+            // 1. HUNT: skip until a start character
+            if (!inSentence) {
+                if (c == '$' || c == '!') {
+                    startSentence();
+                    segStart = i;
+                } else if (c == '\r' || c == '\n') {
+                    inGarbage = false; // Each garbage line is one error
+                } else {
+                    stats_.bytesDiscarded++;
+                    markGarbage();
+                }
+                continue;
+            }
+
+            // 2. BODY: terminator completes the sentence
+            if (c == '\r' || c == '\n') {
+                emit(data + segStart, i - segStart, onSentence);
+                continue;
+            }
+
+            // A new start character means the previous sentence was cut short: resync on it
+            if (c == '$' || c == '!') {
+                dropSentence();
+                startSentence();
+                segStart = i;
+                continue;
+            }
+
+            // Non-printable bytes or an overlong body: drop and hunt for the next start
+            if (c < 0x20 || c > 0x7E || bodyLen == maxBody) {
+                dropSentence();
+                stats_.bytesDiscarded++;
+                continue;
+            }
+            bodyLen++;
+        }
+
+        // 3. Chunk ended mid-sentence: keep the partial bytes for the next call
+        if (inSentence) pending.insert(pending.end(), data + segStart, data + len);
+    }
+
+    template <typename Callback>
+    void feed(std::string_view chunk, Callback&& onSentence) {
+        feed(chunk.data(), chunk.size(), onSentence);
+    }
+
+    // Treat the end of a self-contained message (e.g. a UDP datagram) as a terminator,
+    // so a final sentence sent without CR/LF is not held back waiting for the next one.
+    template <typename Callback>
+    void endOfMessage(Callback&& onSentence) {
+        if (inSentence) emit(nullptr, 0, onSentence);
+        inGarbage = false;
+    }
+
+    // Forget any partial sentence (e.g. after reconnecting a source)
+    void reset() {
+        pending.clear();
+        inSentence = false;
+        inGarbage = false;
+        bodyLen = 0;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    size_t maxBody;             // Longest sentence body (max bytes minus CR/LF)
+    std::vector<char> pending;  // Partial sentence carried across chunks
+    bool inSentence = false;
+    bool inGarbage = false;
+    size_t bodyLen = 0;
+    Stats stats_;
+
+    template <typename Callback>
+    void emit(const char* tail, size_t tailLen, Callback& onSentence) {
+        if (pending.empty()) {
+            onSentence(std::string_view(tail, tailLen)); // Zero copy: view into the chunk
+        } else {
+            pending.insert(pending.end(), tail, tail + tailLen);
+            onSentence(std::string_view(pending.data(), pending.size()));
+            pending.clear();
+        }
+        stats_.sentences++;
+        inSentence = false;
+        bodyLen = 0;
+    }
+
+    void startSentence() {
+        inSentence = true;
+        inGarbage = false;
+        bodyLen = 1;
+    }
+
+    // Abandon the sentence in progress; it counts as (the start of) one framing error
+    void dropSentence() {
+        markGarbage();
+        stats_.bytesDiscarded += bodyLen;
+        pending.clear();
+        inSentence = false;
+        bodyLen = 0;
+    }
+
+    // One framing error per run of garbage, not per byte
+    void markGarbage() {
+        if (!inGarbage) stats_.framingErrors++;
+        inGarbage = true;
+    }
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+// Non-throwing NMEA field decoders.
+// Everything works directly on string_views into the sentence: no temporaries,
+// no exceptions, no locale. Each function returns false on malformed input and
+// leaves 'out' untouched.
+class NMEANumber {
+public:
+    // Decimal powers used for fixed-point scaling (10^0 .. 10^18)
+    static constexpr int64_t pow10(int n) {
+        int64_t p = 1;
+        while (n-- > 0) p *= 10;
+        return p;
+    }
+
+    // Parses "[+-]digits[.digits]" into value * 10^scale, rounding half away from zero.
+    // e.g. parseFixed("12.345", 2) -> 1235. Up to 18 significant digits.
+    static bool parseFixed(std::string_view s, int scale, int64_t& out) {
+        if (scale < 0 || scale > 18) return false;
+
+        // 1. Sign
+        bool negative = false;
+        size_t i = 0;
+        if (i < s.size() && (s[i] == '+' || s[i] == '-')) negative = (s[i++] == '-');
+
+        // 2. Digits: integer part, then up to 'scale' fraction digits
+        int64_t value = 0;
+        int digits = 0;      // Significant digits accumulated
+        int fraction = -1;   // Fraction digits consumed (-1 = no '.' yet)
+        bool roundUp = false;
+        bool any = false;
+        for (; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '.') {
+                if (fraction >= 0) return false; // Second '.'
+                fraction = 0;
+                continue;
+            }
+            if (c < '0' || c > '9') return false;
+            any = true;
+            if (fraction >= scale) {
+                // First dropped digit decides rounding, the rest are ignored
+                if (fraction == scale) roundUp = (c >= '5');
+                fraction++;
+                continue;
+            }
+            if ((value != 0 || c != '0') && ++digits > 18) return false; // Would overflow int64
+            value = value * 10 + (c - '0');
+            if (fraction >= 0) fraction++;
+        }
+        if (!any) return false;
+
+        // 3. Scale up whatever fraction digits were missing
+        int have = fraction < 0 ? 0 : (fraction > scale ? scale : fraction);
+        int missing = scale - have;
+        if (missing > 0) {
+            if (value > INT64_MAX / pow10(missing)) return false;
+            value *= pow10(missing);
+        }
+        if (roundUp) value++;
+
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Strict integer parse: the whole field must be digits (optional sign)
+    static bool parseInt(std::string_view s, int& out) {
+        if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+        if (s.empty()) return false;
+        int value = 0;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        if (ec != std::errc() || ptr != s.data() + s.size()) return false;
+        out = value;
+        return true;
+    }
+
+    // Strict floating-point parse (std::from_chars: locale-free, no allocation)
+    static bool parseDouble(std::string_view s, double& out) {
+        if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+        if (s.empty()) return false;
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value, std::chars_format::fixed);
+        if (ec != std::errc() || ptr != s.data() + s.size()) return false;
+        out = value;
+        return true;
+    }
+
+    // DDMM.MMMM (lat) / DDDMM.MMMM (lon) + hemisphere -> integer 1e-7 degrees.
+    // Exact for up to 9 minute decimals: result = round(DD * 1e7 + MM.MMMM * 1e7 / 60).
+    static bool parseCoordinateE7(std::string_view pos, std::string_view hemisphere, int32_t& outE7) {
+        if (pos.size() < 2) return false;
+
+        // 1. Split degrees from minutes (minutes are always the 2 digits before '.')
+        size_t dot = pos.find('.');
+        size_t minutesStart = (dot == std::string_view::npos ? pos.size() : dot);
+        if (minutesStart < 2) return false;
+        minutesStart -= 2;
+
+        // 2. Degrees (may be empty, e.g. "07.5" is 0 deg 7.5 min)
+        int64_t degrees = 0;
+        for (size_t i = 0; i < minutesStart; ++i) {
+            char c = pos[i];
+            if (c < '0' || c > '9' || degrees > 180) return false;
+            degrees = degrees * 10 + (c - '0');
+        }
+
+        // 3. Minutes in 1e-9 units, then to 1e-7 degrees: minutes * 1e7 / 60 = minutes_e9 / 6000
+        int64_t minutesE9 = 0;
+        if (!parseFixed(pos.substr(minutesStart), 9, minutesE9)) return false;
+        if (minutesE9 < 0 || minutesE9 >= 60 * pow10(9)) return false;
+        int64_t e7 = degrees * pow10(7) + (minutesE9 + 3000) / 6000;
+
+        // 4. Hemisphere and range (N/S is latitude, E/W is longitude)
+        bool isLatitude = (hemisphere == "N" || hemisphere == "S");
+        if (e7 > (isLatitude ? 90 : 180) * pow10(7)) return false;
+        if (hemisphere == "S" || hemisphere == "W") e7 = -e7;
+
+        outE7 = static_cast<int32_t>(e7);
+        return true;
+    }
+
+    // hhmmss[.sss] -> milliseconds since midnight
+    static bool parseTimeMs(std::string_view hhmmss, int32_t& outMs) {
+        if (hhmmss.size() < 6) return false;
+        int hours = 0, minutes = 0;
+        int64_t millis = 0;
+        if (!parseTwoDigits(hhmmss.substr(0, 2), hours) || hours > 23) return false;
+        if (!parseTwoDigits(hhmmss.substr(2, 2), minutes) || minutes > 59) return false;
+        if (!parseFixed(hhmmss.substr(4), 3, millis) || millis < 0 || millis > 60999) return false; // Allow leap second
+        outMs = static_cast<int32_t>(hours * 3600000 + minutes * 60000 + millis);
+        return true;
+    }
+
+private:
+    static bool parseTwoDigits(std::string_view s, int& out) {
+        if (s.size() != 2 || s[0] < '0' || s[0] > '9' || s[1] < '0' || s[1] > '9') return false;
+        out = (s[0] - '0') * 10 + (s[1] - '0');
+        return true;
+    }
+};
@@ -1,19 +1,27 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <cmath>
 #include <iostream>
 #include <functional> // <--- Added
+#include "AISDecoder.h"
 
 // 1. Define the Data Object
 // This struct holds the final, clean data extracted from the messy string.
 struct GPSData {
     std::string ID;   // Identifier for the data source
 
-    double timestamp = 0.0;     // UTC Time
+    double timestamp = 0.0;     // UTC Time (seconds since midnight)
     double latitude = 0.0;      // Decimal Degrees (converted from NMEA format)
     double longitude = 0.0;     // Decimal Degrees (converted from NMEA format)
     double altitude = 0.0;      // Meters above sea level
+
+    int32_t latitudeE7 = 0;     // Same position in exact fixed point (1e-7 degrees)
+    int32_t longitudeE7 = 0;
     
     int fixQuality = 0;         // 0 = Invalid, 1 = GPS Fix, 2 = DGPS Fix
     int satellites = 0;         // Number of satellites being tracked
@@ -24,7 +32,13 @@ struct GPSData {
     double speed = 0.0;     // Speed over ground (knots)
     double course = 0.0;    // Track angle in degrees True
     std::string date = "";  // Date string (DDMMYY)
-    std::string type = "";  // "GPGGA" or "GPRMC"
+    std::string type = "";  // Full address, e.g. "GPGGA" or "GNRMC"
+    std::string talker = ""; // Talker ID: "GP" (GPS), "GN" (multi-GNSS), "GL", "GA", "BD"...
+
+    // Fixed-point position for storage and the wire. Parsed NMEA carries the exact value;
+    // other producers only the double.
+    int32_t latE7() const { return latitudeE7 != 0 ? latitudeE7 : static_cast<int32_t>(std::llround(latitude * 1e7)); }
+    int32_t lonE7() const { return longitudeE7 != 0 ? longitudeE7 : static_cast<int32_t>(std::llround(longitude * 1e7)); }
 
     std::string toString() const {
         return type + " | Lat: " + std::to_string(latitude) + 
@@ -32,7 +46,49 @@ struct GPSData {
     }
 };
 
-// 2. Define the Class Interface
+// 2. Define the Token View
+// Fixed-capacity list of field offsets into the original sentence.
+// Tokenizing never allocates: each field is just (start, length) into 'sentence'.
+struct NMEATokens {
+    static constexpr size_t MAX_FIELDS = 32;
+
+    std::string_view sentence;              // Buffer the offsets point into (must outlive the tokens)
+    std::array<uint16_t, MAX_FIELDS> starts{};
+    std::array<uint16_t, MAX_FIELDS> lengths{};
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Out-of-range fields read as empty, just like a blank NMEA field
+    std::string_view operator[](size_t i) const {
+        if (i >= count) return {};
+        return std::string_view(sentence.data() + starts[i], lengths[i]);
+    }
+};
+
+// 3. Define the Batch Result
+// Column-oriented (SoA) output of parseBatch(): one contiguous array per field,
+// so downstream math can stream and vectorize over a single column.
+struct GPSBatch {
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<double> speed;       // Knots (RMC only, 0 otherwise)
+    std::vector<double> course;      // Degrees True (RMC only, 0 otherwise)
+    std::vector<double> timestamp;   // UTC seconds since midnight
+    std::vector<uint8_t> fixQuality;
+    std::vector<uint64_t> validBits; // Bit i set = row i passed checksum and was decoded
+
+    size_t size() const { return latitude.size(); }
+    bool isValid(size_t i) const { return (validBits[i >> 6] >> (i & 63)) & 1u; }
+    size_t validCount() const;
+
+    // Sizes every column to 'rows' and zeroes them (keeps capacity for reuse)
+    void resize(size_t rows);
+    void clear() { resize(0); }
+};
+
+// 4. Define the Class Interface
 class NMEAParser {
     // Define the Event Type: A function that returns void and takes const GPSData&
     using GPSCallback = std::function<void(const GPSData&)>;
@@ -40,6 +96,9 @@ class NMEAParser {
     // List of subscribers
     std::vector<GPSCallback> listeners;
 
+    // AIS state (fragment reassembly + vessel records) lives per parser instance
+    AISDecoder aisDecoder;
+
     
 
 public:
@@ -47,8 +106,22 @@ public:
     NMEAParser() = default;
 
     // The Main Public Interface
-    // Takes a raw NMEA string, returns a clean GPSData object
-    GPSData parse(const std::string& nmeastring);
+    // Takes a raw NMEA string, returns a clean GPSData object.
+    // Accepts std::string, literals or views into a larger receive buffer without copying.
+    GPSData parse(std::string_view nmeastring);
+
+    // Same decode as parse() but listeners are NOT notified, for pipelines that
+    // post-process fixes (tag the source, fuse epochs) before publishing them.
+    bool decode(std::string_view nmeastring, GPSData& data);
+
+    // Batch Interface (offline analytics / backfill)
+    // Parses 'count' sentences into columns; row i of 'out' matches sentences[i].
+    // Listeners are NOT notified: this path is for bulk processing, not live fixes.
+    static void parseBatch(const std::string_view* sentences, size_t count, GPSBatch& out);
+    static void parseBatch(const std::vector<std::string>& sentences, GPSBatch& out);
+
+    // AIS vessel records built from every !AIVDM/!AIVDO this parser has seen
+    const AISDecoder& ais() const { return aisDecoder; }
 
     // NEW: Subscription Method
     // Users call this to say "Call me when you get a fix"
@@ -62,12 +135,27 @@ public:
     // Verifies if the string is not corrupted
     static double safeStod(std::string_view str);
     static int safeStoi(std::string_view str);
-    static bool validateChecksum(const std::string& s);
+    static bool validateChecksum(std::string_view s);
+    // Splits the payload ('$' or '!' up to '*') into field views without allocating.
+    // Returns empty tokens if the sentence has more than NMEATokens::MAX_FIELDS fields.
+    static NMEATokens tokenize(std::string_view s);
     // Splits the string by commas (like Python's split)
+    // Allocates one std::string per field; prefer tokenize() on hot paths.
     static std::vector<std::string> split(const std::string& s, char delimiter);
+    // Converts NMEA time (hhmmss.ss) to seconds since midnight UTC
+    static double parseUtcTime(std::string_view hhmmss);
     // Converts NMEA weird coordinates (DDMM.MMMM) to standard Decimal Degrees
     static double convertToDecimalDegrees(const std::string_view nmeaPos, const std::string_view direction);
-    // Hex to Int converter for checksum validation
-    static int hexToDecimal(const std::string& hex);
+    // Hex to Int converter for checksum validation (-1 on invalid input)
+    static int hexToDecimal(std::string_view hex);
+
+private:
+    // Checksum + tokenize + dispatch into 'data' (no listeners). Returns data.isValid.
+    // AIS sentences are only decoded when an 'ais' decoder is supplied.
+    static bool decodeInto(std::string_view nmeastring, GPSData& data, AISDecoder* ais);
+    // Maps a completed AIS position report onto GPSData (ID = MMSI)
+    static bool decodeAIS(const NMEATokens& tokens, GPSData& data, AISDecoder& ais);
+    // Shared front end for parse/tokenize/validateChecksum: one scan, returns checksum result
+    static bool scanSentence(std::string_view s, NMEATokens& tokens);
 
 };
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "NMEAFramer.h"
+#include "NMEASource.h"
+
+// epoll I/O Reactor
+// Services any number of non-blocking sources (UDP, serial, TCP) from a fixed number of
+// threads. Each source is pinned to one reactor thread and has its own framer, so its
+// sentences come out in order; thread count scales with cores, not with receivers.
+//
+// Shutdown is an eventfd wake-up: no closing sockets under a blocked reader.
+class NMEAReactor {
+public:
+    // Receives each framed sentence (view valid only during the call)
+    using SentenceSink = std::function<void(std::string_view sentence)>;
+    // Told when a source hit EOF or an error and was removed from the reactor
+    using ClosedCallback = std::function<void(const std::string& sourceID)>;
+    // Sees every chunk exactly as read, before framing (e.g. CaptureRecorder)
+    using RawTap = std::function<void(const std::string& sourceID, uint64_t receivedNs, std::string_view bytes)>;
+
+    struct Config {
+        size_t threads = 1;
+        size_t readsPerWakeup = 16;  // Reads per ready source before moving on (fairness)
+        size_t chunkBytes = 4096;    // Per-thread read buffer
+    };
+
+    struct Stats {
+        uint64_t bytes = 0;
+        uint64_t sentences = 0;
+        uint64_t framingErrors = 0;
+        uint64_t closedSources = 0;
+    };
+
+    explicit NMEAReactor(Config config);
+    ~NMEAReactor();
+
+    // Takes ownership of an already opened source. Safe before or after start().
+    bool add(std::string sourceID, std::unique_ptr<IPollableSource> source, SentenceSink sink);
+
+    // Must be set before start()
+    void onClosed(ClosedCallback cb) { closed = std::move(cb); }
+    void onRaw(RawTap cb) { rawTap = std::move(cb); }
+
+    void start();
+    // Wakes and joins the reactor threads, then closes every source
+    void stop();
+
+    size_t sourceCount() const;
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string id;
+        std::unique_ptr<IPollableSource> source;
+        SentenceSink sink;
+        NMEAFramer framer;
+        bool active = true;
+    };
+
+    struct Loop {
+        int epfd = -1;
+        int wakefd = -1; // eventfd: written by stop()
+        std::thread thread;
+        std::vector<char> chunk;
+        std::vector<Entry*> backlog;  // Sources with user-space data left after their budget
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> sentences{0};
+        std::atomic<uint64_t> framingErrors{0};
+    };
+
+    Config config;
+    ClosedCallback closed;
+    RawTap rawTap;
+    std::vector<std::unique_ptr<Loop>> loops;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> closedSources{0};
+    bool started = false;
+
+    mutable std::mutex entriesMtx;
+    std::vector<std::unique_ptr<Entry>> entries; // Stable addresses: epoll data points at them
+    size_t nextLoop = 0;
+
+    void run(Loop& loop);
+    void service(Loop& loop, Entry& entry);
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include "RawPacket.h"
+#include "RingQueue.h"
+
+// Raw Sentence Relay
+// Re-publishes validated sentences to downstream TCP clients (chart plotters, autopilots,
+// loggers) and UDP targets. Each sentence is copied once into a reference-counted
+// buffer that every client queue shares. Clients have bounded queues: a slow client loses
+// its own oldest sentences instead of stalling ingest or the other clients.
+//
+// publish() is safe from any number of threads and never blocks; one sender thread does
+// all socket I/O with epoll.
+class NMEARelay {
+public:
+    using Buffer = std::shared_ptr<const std::string>; // Sentence + CR/LF, shared by all clients
+
+    struct Config {
+        int tcpPort = -1;                      // Listen for TCP clients (-1 = off, 0 = any free port)
+        std::vector<std::string> udpTargets;   // "host:port" datagram destinations
+        size_t clientQueue = 1024;             // Sentences buffered per client
+        OverflowPolicy overflow = OverflowPolicy::DropOldest; // Block is treated as DropNewest
+        std::vector<std::string> formatters;   // Only relay these ("GGA", "VDM", ...); empty = all
+        std::vector<std::string> sources;      // Only relay these source IDs; empty = all
+        std::chrono::milliseconds dedupWindow{0}; // Drop repeats of an identical sentence (0 = off)
+    };
+
+    struct Stats {
+        uint64_t published = 0;   // Sentences handed to clients
+        uint64_t invalid = 0;     // Failed checksum
+        uint64_t filtered = 0;    // Excluded by formatter/source filters
+        uint64_t duplicates = 0;  // Suppressed by dedup
+        uint64_t dropped = 0;     // Lost in client queues (slow clients)
+        uint64_t bytesSent = 0;
+        uint64_t clients = 0;     // Currently connected TCP clients + UDP targets
+    };
+
+    explicit NMEARelay(Config config);
+    ~NMEARelay();
+
+    bool start();
+    void stop();
+
+    // PRODUCER: validate, filter, dedup and fan out one sentence (CR/LF optional)
+    void publish(std::string_view sourceID, std::string_view sentence);
+    void publish(const RawPacket& packet) { publish(packet.sourceID, packet.nmeaString); }
+
+    int tcpPort() const { return boundPort; }
+    Stats stats() const;
+
+private:
+    struct Client {
+        Client(size_t capacity, OverflowPolicy policy) : queue(capacity, policy) {}
+
+        int fd = -1;                  // TCP socket, or the shared UDP socket
+        bool tcp = true;
+        sockaddr_storage addr{};      // UDP destination
+        socklen_t addrLen = 0;
+        RingQueue<Buffer> queue;
+        std::vector<Buffer> pending;  // Popped but not fully written yet (TCP)
+        size_t offset = 0;            // Bytes of pending[0] already written
+        bool wantWrite = false;       // EPOLLOUT armed
+    };
+    using ClientList = std::vector<std::shared_ptr<Client>>;
+
+    Config config;
+    int listenfd = -1;
+    int udpfd = -1;
+    int epfd = -1;
+    int wakefd = -1;
+    int boundPort = -1;
+    std::thread sender;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> wakePending{false};
+    bool started = false;
+
+    // Copy-on-write: publishers take a snapshot, only the sender thread replaces it
+    std::shared_ptr<const ClientList> clients;
+
+    // Lock-free dedup memory: hash -> last seen (races only cost a missed duplicate)
+    static constexpr size_t DEDUP_SLOTS = 1024;
+    std::unique_ptr<std::atomic<uint64_t>[]> dedupHash;
+    std::unique_ptr<std::atomic<int64_t>[]> dedupTimeMs;
+
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> invalid{0};
+    std::atomic<uint64_t> filtered{0};
+    std::atomic<uint64_t> duplicates{0};
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic<uint64_t> droppedByGone{0}; // Drop counts of clients that already left
+
+    bool accepts(std::string_view sourceID, std::string_view body) const;
+    bool isDuplicate(std::string_view body);
+    void run();
+    void acceptClients();
+    void addClient(std::shared_ptr<Client> client);
+    void removeClient(const std::shared_ptr<Client>& client);
+    bool flushTcp(Client& client, bool& more);
+    void flushUdp(Client& client, bool& more);
+    void setWantWrite(Client& client, bool on);
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Result of one pass over a sentence
+struct NMEAScan {
+    static constexpr size_t npos = std::string_view::npos;
+
+    size_t start = npos;     // Offset of the leading '$' (or '!' for AIS)
+    size_t star = npos;      // Offset of the '*' that ends the payload
+    uint8_t checksum = 0;    // XOR of every byte strictly between start and star
+    size_t commaCount = 0;   // Commas seen in the payload (may exceed the caller's capacity)
+};
+
+// Front-end scanner: finds the delimiters and computes the checksum in a single pass.
+// SSE2/AVX2 kernels are picked once at startup from the CPU's features; the scalar
+// kernel is the reference implementation and the fallback on other architectures.
+class NMEAScanner {
+public:
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+    // Scans 's' with the best kernel for this CPU.
+    // Comma offsets (relative to s) are written to 'commas' up to 'maxCommas' entries.
+    static NMEAScan scan(std::string_view s, uint32_t* commas, size_t maxCommas);
+
+    // Same as scan() but with an explicit kernel (tests and benchmarks)
+    static NMEAScan scanWith(Kernel kernel, std::string_view s, uint32_t* commas, size_t maxCommas);
+
+    static bool isSupported(Kernel kernel);
+    static Kernel activeKernel();
+    static const char* kernelName(Kernel kernel);
+};
@@ -1,44 +1,82 @@
 #pragma once
+#include <cstdint>
+#include <string_view>
 #include "NMEAParser.h" // Needs visibility of GPSData and Static Helpers
+#include "NMEANumber.h"
 
 // Abstract Base Class
+// Decoders are stateless: one shared instance per sentence type handles every talker.
 class INMEASentence {
 public:
     virtual ~INMEASentence() = default; // Virtual destructor for proper cleanup
-    virtual void parse(const std::vector<std::string>& tokens, GPSData& data) = 0; //each derived class implements this
+    virtual void parse(const NMEATokens& tokens, GPSData& data) const = 0; //each derived class implements this
+
+protected:
+    // Shared by GGA/RMC: lat, N/S, lon, E/W starting at token 'first'.
+    // Fixed-point first, doubles derived from it so both always agree.
+    static void decodePosition(const NMEATokens& tokens, size_t first, GPSData& data) {
+        if (NMEANumber::parseCoordinateE7(tokens[first], tokens[first + 1], data.latitudeE7)) {
+            data.latitude = data.latitudeE7 / 1e7;
+        }
+        if (NMEANumber::parseCoordinateE7(tokens[first + 2], tokens[first + 3], data.longitudeE7)) {
+            data.longitude = data.longitudeE7 / 1e7;
+        }
+    }
 };
-// 1. GPGGA Strategy
-class GPGGASentence : public INMEASentence {
+
+// 1. GGA Strategy (Fix data: position, quality, satellites, altitude)
+class GGASentence : public INMEASentence {
 public:
-    void parse(const std::vector<std::string>& tokens, GPSData& data) override {
-        data.type = "GPGGA";
-        // Map tokens specific to GPGGA
-        if (tokens.size() > 3) data.latitude = NMEAParser::convertToDecimalDegrees(tokens[2], tokens[3]);
-        if (tokens.size() > 5) data.longitude = NMEAParser::convertToDecimalDegrees(tokens[4], tokens[5]);
-        if (tokens.size() > 6 && !tokens[6].empty()) data.fixQuality = std::stoi(tokens[6]);
-        if (tokens.size() > 7 && !tokens[7].empty()) data.satellites = std::stoi(tokens[7]);
-        if (tokens.size() > 9) {
-        try {
-            data.altitude = std::stod(std::string(tokens[9]));
-        } catch (...) { data.altitude = 0.0; }
-    }
+    void parse(const NMEATokens& tokens, GPSData& data) const override {
+        // Map tokens specific to GGA
+        if (tokens.size() > 1) data.timestamp = NMEAParser::parseUtcTime(tokens[1]);
+        decodePosition(tokens, 2, data);
+        if (tokens.size() > 6) data.fixQuality = NMEAParser::safeStoi(tokens[6]);
+        if (tokens.size() > 7) data.satellites = NMEAParser::safeStoi(tokens[7]);
+        if (tokens.size() > 9) data.altitude = NMEAParser::safeStod(tokens[9]);
     }
 };
 
-// 2. GPRMC Strategy
-class GPRMCSentence : public INMEASentence {
+// 2. RMC Strategy (Recommended minimum: position, speed, course)
+class RMCSentence : public INMEASentence {
 public:
-    void parse(const std::vector<std::string>& tokens, GPSData& data) override {
-        data.type = "GPRMC";
-        // GPRMC puts status in token 2 ('A' = valid)
+    void parse(const NMEATokens& tokens, GPSData& data) const override {
+        if (tokens.size() > 1) data.timestamp = NMEAParser::parseUtcTime(tokens[1]);
+
+        // RMC puts status in token 2 ('A' = valid)
         if (tokens.size() > 2 && tokens[2] == "A") data.fixQuality = 1; 
         else data.fixQuality = 0;
 
-        if (tokens.size() > 4) data.latitude = NMEAParser::convertToDecimalDegrees(tokens[3], tokens[4]);
-        if (tokens.size() > 6) data.longitude = NMEAParser::convertToDecimalDegrees(tokens[5], tokens[6]);
+        decodePosition(tokens, 3, data);
         
         // Specific to RMC
-        if (tokens.size() > 7 && !tokens[7].empty()) data.speed = std::stod(tokens[7]);
-        if (tokens.size() > 8 && !tokens[8].empty()) data.course = std::stod(tokens[8]);
+        if (tokens.size() > 7) data.speed = NMEAParser::safeStod(tokens[7]);
+        if (tokens.size() > 8) data.course = NMEAParser::safeStod(tokens[8]);
+        if (tokens.size() > 9) data.date = tokens[9];
+    }
+};
+
+// 3. The Dispatch Table
+// Decoders are registered once, keyed on the 3-char sentence formatter ("GGA", "RMC").
+// The talker ID ("GP", "GN", "GL", "GA", "BD", ...) is irrelevant to decoding.
+namespace NMEASentenceTable {
+    // Pack the formatter into one integer so lookup is a single switch
+    constexpr uint32_t key(char a, char b, char c) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(a)) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+                static_cast<uint32_t>(static_cast<unsigned char>(c));
+    }
+
+    inline const GGASentence gga;
+    inline const RMCSentence rmc;
+
+    // Returns nullptr for formatters we don't decode
+    inline const INMEASentence* find(std::string_view formatter) {
+        if (formatter.size() != 3) return nullptr;
+        switch (key(formatter[0], formatter[1], formatter[2])) {
+            case key('G', 'G', 'A'): return &gga;
+            case key('R', 'M', 'C'): return &rmc;
+            default:                 return nullptr;
+        }
     }
-};
\ No newline at end of file
+}
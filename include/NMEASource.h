@@ -1,8 +1,13 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
 #include <fcntl.h> 
 #include <termios.h>
+#include <unistd.h>
 
 // Abstract Base Class for any Data Source
 class INMEASource {
@@ -11,6 +16,23 @@ public:
     
     // Blocking call that waits for the next line of data
     virtual std::string readLine() = 0;
+
+    // Blocking bulk read: fills 'buf' with up to 'cap' raw bytes, which may hold
+    // partial or several sentences (run them through NMEAFramer).
+    // Returns the byte count, 0 on error or disconnect.
+    // Default adapts readLine() so existing sources keep working.
+    virtual size_t readChunk(char* buf, size_t cap) {
+        std::string line = readLine();
+        if (line.empty() || cap == 0) return 0;
+        size_t n = std::min(line.size(), cap - 1);
+        std::memcpy(buf, line.data(), n);
+        buf[n++] = '\n'; // readLine() strips the terminator
+        return n;
+    }
+
+    // True if every readChunk() is one self-contained message (e.g. a UDP datagram),
+    // so the framer can close a final sentence sent without CR/LF
+    virtual bool isMessageOriented() const { return false; }
     
     // Setup connection (open port, bind socket, etc.)
     virtual bool open() = 0;
@@ -19,19 +41,53 @@ public:
     virtual void close() = 0;
 };
 
+// Non-blocking Source
+// Exposes its file descriptor so one NMEAReactor thread can service many sources.
+// The reactor switches the descriptor to O_NONBLOCK and calls tryRead() on readiness.
+class IPollableSource : public INMEASource {
+public:
+    enum class ReadResult { Data, WouldBlock, Closed };
+
+    virtual int fd() const = 0;
+
+    // Never blocks. On Data, 'n' holds the byte count (may be 0 for an empty datagram).
+    // Default: plain read() on fd(), which suits serial ports, pipes and TCP streams.
+    virtual ReadResult tryRead(char* buf, size_t cap, size_t& n) {
+        for (;;) {
+            ssize_t r = ::read(fd(), buf, cap);
+            if (r > 0 || (r == 0 && isMessageOriented())) {
+                n = static_cast<size_t>(r);
+                return ReadResult::Data;
+            }
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return ReadResult::WouldBlock;
+            return ReadResult::Closed; // EOF on a stream, or a hard error
+        }
+    }
+
+    // True if the source holds data in user space that epoll cannot see
+    // (e.g. the rest of a recvmmsg batch); the reactor then comes back without waiting
+    virtual bool hasBuffered() const { return false; }
+
+    // Kernel receive time (CLOCK_REALTIME ns) of the data last returned by tryRead(),
+    // 0 if the source can't tell (the reactor then stamps it on arrival)
+    virtual uint64_t receiveTimeNs() const { return 0; }
+};
+
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netdb.h>
 #include <unistd.h>
 #include <cstring>
 #include <iostream>
 
-class UDPSource : public INMEASource {
+class UDPSource : public IPollableSource {
     int sockfd;
     int port;
     char buffer[1024];
 
 public:
-    UDPSource(int port = 10110) : port(port), sockfd(-1) {}
+    UDPSource(int port = 10110) : sockfd(-1), port(port) {}
 
     bool open() override {
         // 1. Create UDP Socket
@@ -59,25 +115,89 @@ public:
 
     std::string readLine() override {
         // Wait for packet (Blocking)
-        socklen_t len;
-        int n = recvfrom(sockfd, (char*)buffer, 1024, 
-                        MSG_WAITALL, nullptr, &len);
-        buffer[n] = '\0'; // Null terminate
-        return std::string(buffer);
+        size_t n = readChunk(buffer, sizeof(buffer));
+        return std::string(buffer, n);
+    }
+
+    // One datagram per call; it may carry several CR/LF separated sentences
+    size_t readChunk(char* buf, size_t cap) override {
+        ssize_t n = recvfrom(sockfd, buf, cap, 0, nullptr, nullptr);
+        return n > 0 ? static_cast<size_t>(n) : 0;
     }
 
+    bool isMessageOriented() const override { return true; }
+
+    int fd() const override { return sockfd; }
+
     void close() override {
         ::close(sockfd);
     }
 };
 
-class SerialSource : public INMEASource {
+// TCP client, e.g. an NMEA multiplexer or gpsd-style raw feed on a remote host
+class TCPSource : public IPollableSource {
+    int sockfd = -1;
+    std::string host;
+    int port;
+
+public:
+    TCPSource(std::string host, int port) : host(std::move(host)), port(port) {}
+
+    bool open() override {
+        // 1. Resolve (IPv4 or IPv6)
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+            std::cerr << "TCP: Cannot resolve " << host << std::endl;
+            return false;
+        }
+
+        // 2. Connect to the first address that answers
+        for (addrinfo* a = res; a != nullptr; a = a->ai_next) {
+            sockfd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (sockfd < 0) continue;
+            if (connect(sockfd, a->ai_addr, a->ai_addrlen) == 0) break;
+            ::close(sockfd);
+            sockfd = -1;
+        }
+        freeaddrinfo(res);
+        if (sockfd < 0) {
+            perror("TCP Connect Error");
+            return false;
+        }
+        std::cout << "TCP: Connected to " << host << ":" << port << std::endl;
+        return true;
+    }
+
+    std::string readLine() override {
+        std::string sentence;
+        char c;
+        while (::read(sockfd, &c, 1) == 1 && c != '\n') sentence += c;
+        return sentence;
+    }
+
+    size_t readChunk(char* buf, size_t cap) override {
+        ssize_t n = ::read(sockfd, buf, cap);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    int fd() const override { return sockfd; }
+
+    void close() override {
+        if (sockfd >= 0) ::close(sockfd);
+        sockfd = -1;
+    }
+};
+
+class SerialSource : public IPollableSource {
     int serial_fd;
     std::string device;
     char buffer[1]; // Read 1 byte at a time
 
 public:
-    SerialSource(std::string dev) : device(dev), serial_fd(-1) {}
+    SerialSource(std::string dev) : serial_fd(-1), device(dev) {}
 
     bool open() override {
         // 1. Open the device
@@ -126,6 +246,14 @@ public:
         return sentence;
     }
 
+    // Whatever the driver has ready (one line in canonical mode)
+    size_t readChunk(char* buf, size_t cap) override {
+        ssize_t n = ::read(serial_fd, buf, cap);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    int fd() const override { return serial_fd; }
+
     void close() override {
         ::close(serial_fd);
     }
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "FixFusion.h"
+#include "NMEAParser.h"
+#include "RawPacket.h"
+#include "RingQueue.h"
+
+// Sharded Parser Pool
+// Every source gets a Lane: its own mailbox, parser (AIS reassembly) and fusion state.
+// Lanes are sharded onto workers by hashing the source ID, and a lane is only ever
+// scheduled on one worker at a time, so sentences from one source are decoded in order
+// while different sources parse in parallel.
+//
+// With work stealing enabled, an idle worker takes whole lanes from the busiest worker's
+// run queue. Ordering still holds because a lane is never processed by two workers at once.
+//
+// Producers never take a lock: mailboxes and run queues are bounded lock-free rings, and
+// a full mailbox is handled by Config::overflow (block, drop newest or drop oldest).
+//
+// The fix callback is invoked concurrently from worker threads: observers must be thread-safe.
+class ParserPool {
+public:
+    using FixCallback = std::function<void(const GPSData&)>;
+
+    struct Config {
+        size_t workers = 2;
+        bool workStealing = false;
+        size_t batchSize = 64;   // Sentences decoded per lane visit before yielding the worker
+        std::chrono::milliseconds fusionTimeout{200};
+        size_t laneCapacity = 4096;      // Sentences buffered per source
+        OverflowPolicy overflow = OverflowPolicy::Block; // Live feeds usually want DropOldest
+        size_t maxSources = 1024;        // Run queues are sized so every lane always fits
+    };
+
+    struct Stats {
+        uint64_t sentences = 0;  // Sentences decoded
+        uint64_t fixes = 0;      // Fixes published
+        uint64_t steals = 0;     // Lanes taken from another worker
+        uint64_t dropped = 0;    // Sentences rejected by full mailboxes (DropNewest)
+        uint64_t evicted = 0;    // Queued sentences discarded for newer ones (DropOldest)
+        uint64_t waits = 0;      // Submits that had to wait for room (Block)
+    };
+
+    // Per-source state; obtain once with lane() and submit to it directly
+    struct Lane {
+        Lane(size_t capacity, OverflowPolicy policy) : mailbox(capacity, policy) {}
+
+        std::string id;
+        size_t home = 0;                 // Worker this source is sharded to
+        RingQueue<std::string> mailbox;
+        std::atomic<bool> scheduled{false}; // In a run queue or being processed
+        std::mutex busy;                 // Held while decoding (fusion/parser are single-threaded)
+        NMEAParser parser;
+        FixFusion fusion;
+    };
+
+    explicit ParserPool(Config config);
+    ~ParserPool();
+
+    // Must be set before start()
+    void onFix(FixCallback cb) { output = std::move(cb); }
+
+    void start();
+    // Stops the workers, then drains every mailbox and flushes pending epochs
+    void stop();
+
+    // Registers (or finds) the lane for a source; nullptr once maxSources is reached
+    Lane* lane(const std::string& sourceID);
+
+    // PRODUCER: queue one framed sentence for its source (lock-free)
+    // Returns false if the sentence was dropped by the overflow policy
+    bool submit(Lane* lane, std::string sentence);
+    bool submit(RawPacket packet) { return submit(lane(packet.sourceID), std::move(packet.nmeaString)); }
+
+    Stats stats() const;
+    size_t workerCount() const { return workers.size(); }
+
+private:
+    struct Worker {
+        explicit Worker(size_t lanes) : runQueue(lanes, OverflowPolicy::Block) {}
+
+        RingQueue<Lane*> runQueue;       // Each lane sits in at most one run queue, so never full
+        std::mutex mtx;                  // Only for sleeping on cv
+        std::condition_variable cv;
+        std::atomic<bool> sleeping{false};
+        std::vector<std::string> batch;  // Reused between lane visits
+        std::thread thread;
+        std::atomic<uint64_t> sentences{0};
+        std::atomic<uint64_t> steals{0};
+    };
+
+    Config config;
+    FixCallback output;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> fixes{0};
+    bool started = false;
+
+    mutable std::mutex registryMtx;
+    std::unordered_map<std::string, std::unique_ptr<Lane>> lanes;
+
+    void run(size_t index);
+    void schedule(Lane* lane);
+    Lane* steal(size_t thief);
+    void process(Lane* lane, Worker& worker, bool drainAll);
+    void wake(Worker& worker);
+    void pollHomeLanes(size_t index);
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// One framed sentence (or raw chunk) tagged with the source it came from
+struct RawPacket {
+    std::string sourceID;
+    std::string nmeaString;
+    uint64_t receivedNs = 0; // Receive time, CLOCK_REALTIME ns (kernel timestamp where available)
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "NMEASource.h"
+
+// Memory-mapped Capture Replay
+// Plays a recorded NMEA log back into the engine. The file is mmap'd, so multi-gigabyte
+// logs cost no reads or copies: next() hands out views straight into the mapping.
+//
+// Log time comes from an optional leading timestamp ("1697040000.250 $GPGGA,...", as
+// written by most loggers) or, failing that, from the UTC field of GGA/RMC/GLL/ZDA/GNS.
+// Sentences without a time inherit the previous one.
+//
+// As an IPollableSource it runs inside NMEAReactor: fd() is a timerfd armed for the next
+// due sentence, so pacing needs no extra thread.
+class ReplaySource : public IPollableSource {
+public:
+    enum class Pacing {
+        RealTime,  // Original timing
+        Scaled,    // Original timing divided by Config::speed (e.g. 10x)
+        MaxSpeed   // As fast as the consumer takes it
+    };
+
+    struct Config {
+        std::string path;
+        Pacing pacing = Pacing::RealTime;
+        double speed = 1.0;                  // Scaled only
+        std::chrono::milliseconds maxGap{0}; // Clamp recording gaps (receiver off, ...) when pacing; 0 = keep
+        bool loop = false;                   // Start over at the end
+    };
+
+    struct Stats {
+        uint64_t sentences = 0;
+        uint64_t bytes = 0;
+        uint64_t loops = 0;
+        uint64_t truncated = 0; // Lines longer than the read buffer, cut to fit
+        double maxLagMs = 0;  // Worst lateness behind the pacing schedule
+    };
+
+    explicit ReplaySource(Config config);
+    ~ReplaySource() override;
+
+    bool open() override;
+    void close() override;
+
+    // Zero copy: next sentence (CR/LF and timestamp prefix stripped), waiting for its
+    // due time unless MaxSpeed. The view stays valid until close(). False at the end.
+    bool next(std::string_view& sentence);
+
+    // Jump to 'seconds' after the first timestamp in the log (builds a sparse index on first use)
+    bool seek(double seconds);
+    // Log time of the last sentence handed out, in seconds from the first timestamp
+    double position() const { return lastTime - startTime; }
+    // Length of the recording in seconds (first to last timestamp)
+    double duration();
+
+    // INMEASource / IPollableSource: copies due sentences into 'buf', one per line
+    std::string readLine() override;
+    size_t readChunk(char* buf, size_t cap) override;
+    int fd() const override { return timerfd; }
+    ReadResult tryRead(char* buf, size_t cap, size_t& n) override;
+    bool hasBuffered() const override;
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Line {
+        std::string_view sentence; // Without timestamp prefix and CR/LF
+        size_t end = 0;            // Offset just past the line terminator
+        bool hasTime = false;
+        double time = 0;           // Raw time: epoch seconds or seconds since midnight
+        bool fromPrefix = false;
+    };
+
+    Config config;
+    int filefd = -1;
+    int timerfd = -1;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    size_t cursor = 0;          // Offset of the next line
+    Line peeked;                // Next line, decoded once
+    bool havePeek = false;
+
+    // UTC-of-day times wrap at midnight: keep a running day offset
+    struct Unwrap {
+        double lastRaw = -1;
+        double dayOffset = 0;
+        double apply(const Line& line);
+    };
+
+    // Timeline: unwrapped times, measured from the first one
+    Unwrap unwrap;
+    double startTime = 0;
+    double lastTime = 0;
+    bool haveStart = false;
+
+    // Pacing anchor: log time 'anchorLog' is due at wall time 'anchorWall'
+    Clock::time_point anchorWall;
+    double anchorLog = 0;
+    bool anchored = false;
+    Clock::time_point peekedDue;
+    bool dueValid = false;
+
+    // Sparse seek index: one entry per ~64 KiB, with the unwrap state to resume from
+    struct IndexEntry {
+        double time;     // Seconds from startTime
+        size_t offset;
+        Unwrap unwrap;
+    };
+    std::vector<IndexEntry> index;
+    double endTime = 0;
+    Stats stats_;
+
+    bool parseLine(size_t offset, Line& line) const;
+    bool peek();
+    void advance();
+    Clock::time_point dueTime();
+    void rewind();
+    void buildIndex();
+    void armTimer(Clock::time_point when);
+};
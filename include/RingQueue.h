@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// What push() does when the ring is full
+enum class OverflowPolicy {
+    Block,       // Wait (spin, then yield, then sleep) until there is room; never takes a lock
+    DropNewest,  // Reject the incoming item
+    DropOldest   // Evict the oldest queued item to make room (freshest data wins)
+};
+
+// Bounded Lock-free Ring Queue
+// Fixed-capacity MPMC ring (per-cell sequence numbers, Vyukov style). Producers and
+// consumers only ever CAS an index, so a stalled consumer degrades into drops or
+// backpressure instead of unbounded memory growth. Items are moved in and out.
+// Capacity is rounded up to a power of two.
+template <typename T>
+class RingQueue {
+public:
+    struct Stats {
+        uint64_t pushed = 0;   // Items accepted
+        uint64_t dropped = 0;  // DropNewest: items rejected
+        uint64_t evicted = 0;  // DropOldest: queued items thrown away
+        uint64_t waits = 0;    // Block: pushes that had to wait for room
+    };
+
+    explicit RingQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::Block)
+        : mask(roundUp(capacity) - 1), policy(policy), cells(new Cell[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    ~RingQueue() {
+        T discard;
+        while (tryPop(discard)) {}
+    }
+
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    // PRODUCER: returns false if the item was dropped (DropNewest) or the queue is closed
+    bool push(T&& item) { return emplace(std::move(item)); }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        for (unsigned attempt = 0;; ++attempt) {
+            if (tryEmplace(std::forward<Args>(args)...)) {
+                pushed.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire)) return false;
+
+            switch (policy) {
+                case OverflowPolicy::DropNewest:
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::DropOldest: {
+                    T oldest;
+                    if (tryPop(oldest)) evicted.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                case OverflowPolicy::Block:
+                    if (attempt == 0) waits.fetch_add(1, std::memory_order_relaxed);
+                    backoff(attempt);
+                    break;
+            }
+        }
+    }
+
+    // CONSUMER: non-blocking pop
+    bool tryPop(T& item) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* slot = cell->ptr();
+        item = std::move(*slot);
+        slot->~T();
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // CONSUMER: pops up to 'max' items into 'out' in FIFO order, returns how many
+    size_t popN(T* out, size_t max) {
+        size_t n = 0;
+        while (n < max && tryPop(out[n])) ++n;
+        return n;
+    }
+
+    // Wakes blocked producers for shutdown; later pushes fail, pops still drain
+    void close() { closed.store(true, std::memory_order_release); }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Snapshot only: other threads may be pushing/popping concurrently
+    size_t sizeApprox() const {
+        size_t head = dequeuePos.load(std::memory_order_acquire);
+        size_t tail = enqueuePos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    bool empty() const { return sizeApprox() == 0; }
+
+    Stats stats() const {
+        Stats s;
+        s.pushed = pushed.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        s.evicted = evicted.load(std::memory_order_relaxed);
+        s.waits = waits.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        T* ptr() { return std::launder(reinterpret_cast<T*>(&storage)); }
+    };
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    alignas(64) const size_t mask;
+    const OverflowPolicy policy;
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<bool> closed{false};
+
+    std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> evicted{0};
+    std::atomic<uint64_t> waits{0};
+
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(std::forward<Args>(args)...);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    static void backoff(unsigned attempt) {
+        if (attempt < 16) return;                        // Spin
+        if (attempt < 64) std::this_thread::yield();    // Let the consumer run
+        else std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    static size_t roundUp(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+};
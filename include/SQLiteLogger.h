@@ -1,37 +1,132 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <sqlite3.h> // The C Library header
-#include <iostream>
+#include "ITrackLogger.h"
+#include "BatchWriter.h"
 #include "NMEAParser.h"
+#include "TrackPartitions.h"
 
-class SQLiteLogger {
-private:
-    sqlite3* db; // Raw pointer to the C struct
-
+// SQLite Track Logger
+// log() only enqueues the fix; a dedicated writer thread owns the connection, keeps one
+// prepared INSERT and commits in groups (by row count or by time), so one fsync covers
+// hundreds of rows and the parser workers never wait on the disk.
+// Schema and migrations: TrackSchema.h. Reading history back: TrackQuery.h.
+//
+// With partitioning, each hour/day of fix time goes to its own file (TrackPartitions.h).
+// A maintenance thread deletes partitions past the retention period and thins out older
+// ones with Douglas-Peucker, so storage stays bounded while recent data stays exact.
+// Files are routed by fix time, so late or replayed fixes can reopen an old period: the
+// maintenance pass skips whatever the writer has open.
+class SQLiteLogger : public ITrackLogger {
 public:
-    // Constructor: Opens DB and creates table if missing
-    SQLiteLogger(const std::string& dbPath) {
-        // 1. Open Database
-        int rc = sqlite3_open(dbPath.c_str(), &db);
-        if (rc) {
-            std::cerr << "DB Error: " << sqlite3_errmsg(db) << std::endl;
-        } else {
-            std::cout << "DB: Opened " << dbPath << std::endl;
-            initTable();
-        }
-    }
-
-    // Destructor: Closes Database safely
-    ~SQLiteLogger() {
-        if (db) {
-            sqlite3_close(db);
-            std::cout << "DB: Connection Closed." << std::endl;
-        }
-    }
-
-    // The Action Method
-    void log(const GPSData& data);
+    // What a power cut may cost (an application crash loses nothing that was committed)
+    enum class Durability {
+        Fast,     // WAL, synchronous=OFF: no fsync at all; the database may be corrupted
+        Normal,   // WAL, synchronous=NORMAL: the last commits may roll back, never corrupts
+        Full      // WAL, synchronous=FULL: every commit is on disk when it returns
+    };
+
+    struct Config {
+        std::string path = "voyage_data.db";        // Base name when partitioned
+        size_t batchRows = 512;                     // Commit after this many rows...
+        std::chrono::milliseconds batchInterval{250}; // ...or when the open batch is this old
+        Durability durability = Durability::Normal;
+        size_t queueCapacity = 65536;               // Fixes waiting for the writer
+
+        Partitioning partitioning = Partitioning::None;
+        std::chrono::hours retention{0};            // Delete partitions that ended longer ago (0 = keep)
+        std::chrono::hours compactAfter{0};         // Downsample partitions that ended longer ago (0 = never)
+        double compactToleranceM = 10.0;            // Douglas-Peucker tolerance, metres
+        std::chrono::minutes maintenanceInterval{10}; // 0 = no thread, call maintain() yourself
+    };
+
+    struct Stats {
+        uint64_t rows = 0;      // Rows committed
+        uint64_t commits = 0;   // Transactions (one fsync each, at most)
+        uint64_t dropped = 0;   // Queue full: writer could not keep up
+        uint64_t errors = 0;
+        uint64_t partitionsDeleted = 0;
+        uint64_t partitionsCompacted = 0;
+        uint64_t rowsCompacted = 0;  // Rows removed by downsampling
+    };
+
+    // Constructor: Opens DB, creates table if missing, starts the writer
+    explicit SQLiteLogger(const std::string& dbPath);
+    explicit SQLiteLogger(Config config);
+
+    // Destructor: Flushes the queue and closes the database safely
+    ~SQLiteLogger() override;
+
+    // The Action Method: any thread, never blocks on the database
+    void log(const GPSData& data) override;
+
+    // Commits everything queued so far, then closes the database (idempotent)
+    void stop() override;
+
+    // One retention + compaction pass as of 'nowMs' (the maintenance thread runs this)
+    void maintain(int64_t nowMs);
+
+    Stats stats() const;
 
 private:
-    void initTable();
-};
\ No newline at end of file
+    // One open database file (the only one without partitioning)
+    struct Partition {
+        TrackPartitions::File file;
+        sqlite3* db = nullptr; // Raw pointer to the C struct
+        sqlite3_stmt* insert = nullptr; // Prepared once, reset per row
+        sqlite3_stmt* internInsert = nullptr;
+        sqlite3_stmt* internSelect = nullptr;
+        std::unordered_map<std::string, int64_t> sourceIds; // Interned source keys
+        size_t pending = 0;    // Rows in its open transaction
+
+        ~Partition();
+    };
+
+    Config config;
+    // Writer thread only. Most recently used last; at most MAX_OPEN, so fixes straddling
+    // a period boundary don't reopen files back and forth.
+    std::vector<std::unique_ptr<Partition>> partitions;
+    static constexpr size_t MAX_OPEN = 2;
+    size_t groupRows = 0;  // Rows in the open group, over all partitions
+    std::chrono::steady_clock::time_point groupOpened;
+    // Paths in 'partitions'. The writer holds openMtx to open or close one; maintain()
+    // holds it across each file's check and retire/compact.
+    std::mutex openMtx;
+    std::unordered_set<std::string> openPaths;
+
+    BatchWriter<GPSData> writer;
+
+    std::thread maintainer;
+    std::mutex maintMtx;   // Only for maintStop/maintCv
+    std::condition_variable maintCv;
+    bool maintStop = false;
+    std::mutex passMtx;    // One maintain() pass at a time
+
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> partitionsDeleted{0};
+    std::atomic<uint64_t> partitionsCompacted{0};
+    std::atomic<uint64_t> rowsCompacted{0};
+
+    std::unique_ptr<Partition> openPartition(const TrackPartitions::File& file);
+    Partition* partitionFor(int64_t timeMs);
+    void closePartitions();
+    bool exec(sqlite3* db, const char* sql);
+    void writeBatch(GPSData* fixes, size_t n);
+    void commitPartition(Partition& p);
+    void commitAll();
+    int64_t sourceKey(Partition& p, const std::string& name);
+    void insertRow(const GPSData& data);
+    void maintenanceLoop();
+    bool compact(const std::string& path);
+};
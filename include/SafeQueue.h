@@ -4,6 +4,7 @@
 #include <condition_variable>
 #include <atomic>
 
+// Unbounded, mutex-based queue. The ingest path uses RingQueue (bounded, lock-free) instead.
 
 template <typename T>
 class SafeQueue {
@@ -41,6 +42,7 @@ public:
         queue.pop();
         return true;
     } // Lock releases here
+
     // New Helper: Break the deadlock
     void shutdown() {
         {
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Static Asset Cache
+// The built dashboard (frontend/dist) loaded once into an immutable table: every file with
+// its MIME type, a Cache-Control policy and, for compressible types, precompressed gzip
+// (NMEA_HAVE_ZLIB) and brotli (NMEA_HAVE_BROTLI) variants, each variant with its own strong
+// ETag. Requests are answered from memory: no disk I/O, no per-request compression, 304
+// for revalidations.
+//
+// Read-only after load(), so any number of server threads may call serve() without locks.
+class StaticAssets {
+public:
+    struct Asset {
+        std::string mime;
+        std::string etag;          // Strong: "\"<content hash>-<size>\"" for identity,
+        std::string gzipETag;      // the same with -gz / -br for the variants (empty if none)
+        std::string brotliETag;
+        std::string cacheControl;  // Hashed build names are immutable; the rest revalidates
+        std::string identity;
+        std::string gzip;          // Empty if not worth it (or no codec)
+        std::string brotli;
+    };
+
+    struct Reply {
+        int status = 404;                  // 200, 304 or 404
+        const Asset* asset = nullptr;      // Set for 200 and 304
+        const std::string* etag = nullptr; // Set for 200 and 304: ETag of the chosen variant
+        const std::string* body = nullptr; // Set for 200: the variant to send
+        const char* encoding = nullptr;    // Content-Encoding of body ("br", "gzip") or null
+    };
+
+    // Loads every file under 'root' (recursively), replacing what was loaded before.
+    // Returns the number of files.
+    size_t load(const std::string& root);
+
+    // 'path' is the URL path ("/" = "/index.html"); headers may be empty
+    Reply serve(std::string_view path, std::string_view acceptEncoding, std::string_view ifNoneMatch) const;
+
+    const Asset* find(std::string_view path) const;
+    size_t size() const { return assets.size(); }
+    uint64_t bytes() const { return totalBytes; } // All variants
+
+    static std::string mimeType(std::string_view filename);
+    // Vite-style content-hashed names ("index-B3xk9_aZ.js")
+    static bool isHashedName(std::string_view filename);
+    // First existing dashboard directory: 'configured', next to the executable
+    // (<exe>/../frontend/dist), then ../frontend/dist from the working directory
+    static std::string locate(const std::string& configured);
+
+private:
+    std::unordered_map<std::string, Asset> assets; // URL path -> asset
+    uint64_t totalBytes = 0;
+
+    void add(const std::string& urlPath, std::string content);
+    void scan(const std::string& dir, const std::string& urlPrefix);
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BatchWriter.h"
+#include "ITrackLogger.h"
+#include "TrackSchema.h"
+
+// Columnar Track Store file format
+//
+// A store is a directory of three append-only files:
+//
+//   tracks.vessels   "<key> <source ID>\n" per vessel, in order of first sighting
+//   tracks.dat       column blocks (one vessel each): ColumnBlockHeader | columns
+//   tracks.idx       one ColumnIndexEntry per block: vessel, time and position bounds
+//
+// A block holds up to Config::blockFixes fixes of one vessel as separate columns, each a
+// run of zig-zag varints of the delta to the previous fix:
+//   time (ms), latitudeE7, longitudeE7, altitude (dm), speed (0.01 kn), course (0.01 deg),
+//   satellites, fix quality (-1 = invalid fix)
+// Dense tracks change little from fix to fix, so most values take one byte. Range scans
+// read the index (in memory) and decode only the blocks whose bounds overlap.
+namespace ColumnFormat {
+    constexpr uint32_t BLOCK_MAGIC = 0x314C4F43; // "COL1"
+    constexpr size_t COLUMNS = 8;
+
+#pragma pack(push, 1)
+    struct ColumnBlockHeader {
+        uint32_t magic;
+        uint32_t vessel;
+        uint32_t count;
+        uint32_t columnBytes[COLUMNS];
+    };
+    struct ColumnIndexEntry {
+        uint32_t vessel;
+        uint32_t count;
+        int64_t minMs, maxMs;
+        int32_t minLatE7, maxLatE7, minLonE7, maxLonE7;
+        uint64_t offset;     // Of the ColumnBlockHeader in tracks.dat
+        uint32_t bytes;      // Header + columns
+    };
+#pragma pack(pop)
+}
+
+// Track Column Store
+// Alternative to SQLiteLogger for dense tracks: a few bytes per fix instead of a table
+// row plus two index entries. Keeps position, time, altitude, speed, course, satellites
+// and quality; sentence type/talker are not stored.
+class TrackColumnStore : public ITrackLogger {
+public:
+    using StoredFix = TrackSchema::StoredFix;
+
+    struct Config {
+        std::string directory = "tracks";
+        size_t blockFixes = 4096;                   // Fixes per vessel block
+        std::chrono::milliseconds flushInterval{10000}; // Write partial blocks this often
+        size_t queueCapacity = 65536;               // Fixes waiting for the writer
+    };
+
+    struct Stats {
+        uint64_t fixes = 0;         // Fixes written to disk
+        uint64_t blocks = 0;
+        uint64_t bytes = 0;         // Block bytes written (headers + columns)
+        uint64_t dropped = 0;       // Queue full: writer could not keep up
+        uint64_t writeErrors = 0;
+    };
+
+    // Opens (or creates) the store and starts the writer; existing data is appended to
+    explicit TrackColumnStore(Config config);
+    ~TrackColumnStore() override;
+
+    void log(const GPSData& data) override;
+    // Flushes every open block; queries keep working afterwards
+    void stop() override;
+
+    // Fixes of one vessel in [fromMs, toMs], oldest first. Sees flushed blocks only.
+    std::vector<StoredFix> track(const std::string& sourceID, int64_t fromMs, int64_t toMs);
+
+    // Every flushed fix inside the box during [fromMs, toMs] (block bounds prune the scan)
+    void scanBox(double minLat, double minLon, double maxLat, double maxLon, int64_t fromMs, int64_t toMs,
+                 const std::function<void(const StoredFix&)>& visit);
+
+    Stats stats() const;
+
+private:
+    // Open block of one vessel: columns grow as fixes arrive
+    struct OpenBlock {
+        uint32_t vessel = 0;
+        uint32_t count = 0;
+        std::string columns[ColumnFormat::COLUMNS];
+        int64_t last[ColumnFormat::COLUMNS] = {};  // Previous value per column (delta base)
+        ColumnFormat::ColumnIndexEntry bounds{};
+    };
+
+    Config config;
+    BatchWriter<GPSData> writer;
+
+    int datafd = -1;
+    int indexfd = -1;
+    int vesselfd = -1;
+
+    // Writer thread only
+    std::unordered_map<std::string, OpenBlock> open;
+    std::chrono::steady_clock::time_point lastFlush;
+
+    // Shared with queries
+    mutable std::mutex indexMtx;
+    std::vector<ColumnFormat::ColumnIndexEntry> index;
+    std::unordered_map<std::string, uint32_t> vesselKeys;
+    std::vector<std::string> vesselNames;  // By key
+
+    std::atomic<uint64_t> fixes{0};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> writeErrors{0};
+
+    bool openFiles();
+    void writeBatch(GPSData* fixes, size_t n);
+    void append(const GPSData& data);
+    void flushBlock(OpenBlock& block);
+    void flushAll();
+    uint32_t vesselKey(const std::string& name);
+    bool decodeBlock(const ColumnFormat::ColumnIndexEntry& entry, std::vector<StoredFix>& out) const;
+};
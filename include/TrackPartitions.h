@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Time-partitioned track databases
+// With partitioning, the logger's path is a base name and every hour/day of fix time gets
+// its own file next to it:
+//
+//   voyage_data.db  ->  voyage_data-20231115.db     (Daily, UTC)
+//                       voyage_data-2023111513.db   (Hourly, UTC)
+//
+// Old partitions are dropped or compacted whole, and a query only opens the files whose
+// period overlaps its time window.
+enum class Partitioning { None, Hourly, Daily };
+
+namespace TrackPartitions {
+    struct File {
+        std::string path;
+        int64_t startMs = 0;     // Period covered: [startMs, endMs)
+        int64_t endMs = 0;
+    };
+
+    int64_t periodMs(Partitioning p);
+
+    // Partition holding 'timeMs' (None: the base path itself, covering all time)
+    File fileFor(const std::string& basePath, Partitioning p, int64_t timeMs);
+
+    // Existing partitions of 'basePath', oldest first
+    std::vector<File> list(const std::string& basePath, Partitioning p);
+
+    // Deletes a partition together with its -wal/-shm companions
+    void remove(const std::string& path);
+}
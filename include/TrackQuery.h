@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "TrackPartitions.h"
+#include "TrackSchema.h"
+
+// Track History Queries
+// Read-only connections to the database(s) written by SQLiteLogger. WAL mode lets them
+// read while the logger commits. Statements are prepared once per file; calls are
+// serialized internally, so one instance may be shared between threads (e.g. web handlers).
+//
+// With partitioning, every call fans out to the partitions overlapping its time window
+// (opened lazily, dropped once retention deletes them) and merges the results.
+class TrackQuery {
+public:
+    using StoredFix = TrackSchema::StoredFix;
+
+    explicit TrackQuery(const std::string& dbPath, Partitioning partitioning = Partitioning::None);
+    ~TrackQuery();
+
+    // Single file: it opened. Partitioned: always (partitions come and go)
+    bool isOpen();
+
+    // Fixes of one source in [fromMs, toMs], oldest first (uses the (source, time) index).
+    // 'limit' = 0: no limit.
+    std::vector<StoredFix> track(const std::string& sourceID, int64_t fromMs, int64_t toMs, size_t limit = 0);
+
+    // Sources seen inside the box during [fromMs, toMs], with their latest fix in it (R*Tree)
+    std::vector<StoredFix> inBox(double minLat, double minLon, double maxLat, double maxLon,
+                                 int64_t fromMs, int64_t toMs);
+
+    // Most recent fix of every source
+    std::vector<StoredFix> latest();
+
+private:
+    // One open database file
+    struct Shard {
+        TrackPartitions::File file;
+        sqlite3* db = nullptr;
+        sqlite3_stmt* trackStmt = nullptr;
+        sqlite3_stmt* boxStmt = nullptr;
+        sqlite3_stmt* latestStmt = nullptr;
+
+        ~Shard();
+        bool open();
+        sqlite3_stmt* prepare(const std::string& sql);
+        std::vector<StoredFix> collect(sqlite3_stmt* stmt);
+    };
+
+    std::string basePath;
+    Partitioning partitioning;
+    std::map<std::string, std::unique_ptr<Shard>> shards; // By path
+    std::mutex mtx;
+
+    // Open shards overlapping [fromMs, toMs], oldest first
+    std::vector<Shard*> shardsFor(int64_t fromMs, int64_t toMs);
+};
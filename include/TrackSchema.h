@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <sqlite3.h>
+#include "NMEAParser.h"
+
+// Track database schema (versioned via PRAGMA user_version)
+//
+//   sources(id, name)                     Source/vessel IDs, interned once
+//   fixes(id, source, time_ms, lat, lon, altitude, fix_quality, satellites,
+//         speed, course, type, talker, valid)
+//   fixes_source_time                     (source, time_ms) index: track lookups
+//   fixes_rtree(id, min_lat, max_lat, min_lon, max_lon)
+//                                         R*Tree over every fix, filled by trigger
+//   meta(key, value)                      Bookkeeping, e.g. "compacted_m" (v2)
+//
+// time_ms is UTC milliseconds since the Unix epoch. latitudeE7/longitudeE7 are not
+// stored separately: they are exactly recoverable from the REAL columns.
+namespace TrackSchema {
+    constexpr int VERSION = 2;
+
+    // Brings the database up to VERSION, one transaction per step.
+    // Returns false (database left at the last good version) on error.
+    bool migrate(sqlite3* db);
+
+    // A stored fix with its absolute time
+    struct StoredFix {
+        int64_t timeMs = 0;
+        GPSData data;
+    };
+
+    // UTC epoch of a fix: date (DDMMYY) + time of day. Without a date (GGA alone) the day
+    // is taken from 'nowMs', picking the one nearest to it so fixes around midnight land on
+    // the right side. Without any time, 'nowMs' itself.
+    int64_t epochMs(const GPSData& data, int64_t nowMs);
+
+    // Fills data.timestamp/date back from an epoch
+    void setTime(GPSData& data, int64_t timeMs);
+
+    // Column list for SELECTs over "fixes f JOIN sources s", read back with readRow()
+    extern const char* const SELECT_COLUMNS;
+    StoredFix readRow(sqlite3_stmt* stmt);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Douglas-Peucker line simplification for tracks
+// Keeps the first and last point and, recursively, every point farther than 'toleranceM'
+// metres from the line between the points kept around it. Distances use a local
+// equirectangular projection, which is accurate for the short segments of a track.
+struct TrackPoint {
+    double lat = 0.0;
+    double lon = 0.0;
+};
+
+// Returns keep[i] for every input point
+std::vector<bool> simplifyTrack(const std::vector<TrackPoint>& points, double toleranceM);
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include "NMEASource.h"
+
+// One received datagram; 'data' points into the source's slab and is only valid
+// until the next receiveBatch()/readChunk() call
+struct UDPDatagram {
+    std::string_view data;
+    uint64_t kernelTimeNs = 0; // SO_TIMESTAMPNS receive time (CLOCK_REALTIME), 0 if unavailable
+    bool truncated = false;    // Larger than Config::slotBytes, tail was cut by the kernel
+};
+
+// Batched UDP Source
+// Pulls up to Config::batch datagrams per recvmmsg() into one preallocated slab, so a
+// burst of small NMEA packets costs one syscall instead of one each. Each datagram is
+// tagged with its kernel receive timestamp.
+//
+// With Config::reusePort several sources (one per reader thread) can bind the same port;
+// the kernel then shards senders across them by flow hash, so each sender stays ordered.
+class UDPBatchSource : public IPollableSource {
+public:
+    struct Config {
+        int port = 10110;              // 0 = any free port (see boundPort())
+        size_t batch = 64;             // Datagrams per recvmmsg()
+        size_t slotBytes = 2048;       // Largest datagram kept whole
+        bool reusePort = false;        // SO_REUSEPORT: share the port between readers
+        bool kernelTimestamps = true;  // SO_TIMESTAMPNS
+        int receiveBufferBytes = 4 << 20; // SO_RCVBUF: absorbs bursts while we parse
+    };
+
+    struct Stats {
+        uint64_t datagrams = 0;      // Datagrams received
+        uint64_t syscalls = 0;       // recvmmsg() calls that returned data
+        uint64_t truncated = 0;      // Datagrams larger than a slot
+        uint64_t kernelDrops = 0;    // Socket buffer overflows reported by SO_RXQ_OVFL
+        uint64_t errors = 0;         // Failed recvmmsg() calls
+    };
+
+    explicit UDPBatchSource(Config config);
+    explicit UDPBatchSource(int port = 10110) : UDPBatchSource(Config{port}) {}
+    ~UDPBatchSource() override;
+
+    bool open() override;
+    void close() override;
+
+    // Blocks for at least one datagram, then takes whatever else is queued (up to
+    // Config::batch). Returns the count, 0 on error or after close().
+    // On a non-blocking socket (NMEAReactor) it returns 0 with errno == EAGAIN when idle.
+    size_t receiveBatch();
+    const UDPDatagram* datagrams() const { return received.data(); }
+
+    // INMEASource: hands out the current batch one datagram at a time,
+    // refilling it with a single recvmmsg() when it runs dry
+    std::string readLine() override;
+    size_t readChunk(char* buf, size_t cap) override;
+    bool isMessageOriented() const override { return true; }
+
+    // IPollableSource: one datagram per call, one recvmmsg() per batch
+    int fd() const override { return sockfd; }
+    ReadResult tryRead(char* buf, size_t cap, size_t& n) override;
+    bool hasBuffered() const override { return cursor < count; }
+    uint64_t receiveTimeNs() const override { return lastTimeNs; }
+
+    // Kernel receive time of the datagram last returned by readChunk()/readLine()
+    uint64_t lastTimestampNs() const { return lastTimeNs; }
+
+    int boundPort() const { return port; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    Config config;
+    int sockfd = -1;
+    int port = 0;
+
+    // Slab: batch * slotBytes payload bytes, plus one control buffer per slot
+    std::unique_ptr<char[]> slab;
+    std::unique_ptr<char[]> control;
+    size_t controlBytes = 0;
+    std::vector<mmsghdr> headers;
+    std::vector<iovec> iovecs;
+    std::vector<UDPDatagram> received;
+
+    size_t count = 0;   // Datagrams in the current batch
+    size_t cursor = 0;  // Next one readChunk() hands out
+    uint64_t lastTimeNs = 0;
+    uint32_t lastDropCounter = 0;
+    Stats stats_;
+
+    const UDPDatagram* nextDatagram();
+};
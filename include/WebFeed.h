@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "GeoGrid.h"
+#include "NMEAParser.h"
+#include "WireFormat.h"
+
+// Live Web Feed
+// Fans vessel updates out to WebSocket clients without ever blocking the publisher.
+// publish() only records the newest fix per vessel; once per tick a feed thread packs
+// the tick's updates into one frame per client: a JSON array ("[fix,fix,...]", shared by
+// every JSON client that keeps up) or, for clients that asked for it, a binary
+// WireFormat frame of per-vessel deltas.
+//
+// Every client has a window, and a client whose window is shut keeps a per-vessel map of
+// pending updates instead, so when it catches up it gets the newest state of each vessel,
+// not the history. Clients backlogged for longer than laggardTimeout are closed.
+//  - Ack clients (FlowControl::Ack, opt-in) acknowledge each frame they have processed; at
+//    most Config::maxInFlight frames are unacknowledged, which bounds the transport's
+//    outbound queue.
+//  - Plain clients (the default) give no feedback, so the feed cannot see what the
+//    transport still holds for them. They get at most Config::maxBytesPerSec; a consumer
+//    slower than that still grows the transport's queue, but only at the difference.
+//
+// Clients may subscribe to a viewport (bounding box), a list of vessel IDs and a maximum
+// frame rate. Routing goes through a grid of this tick's updates, so a client's cost is
+// the cells under its box plus its vessel list, not clients x vessels; a second grid of
+// every vessel's last position gives a new or moved viewport its current contents at once.
+//
+// Vessels that have not reported for vesselTimeout are forgotten: their handle is freed
+// for reuse and dropped from every client's delta state, so the tables follow the live
+// fleet instead of every vessel ever seen.
+//
+// The transport is abstracted as two callbacks per client, so the feed knows nothing
+// about Crow. Callbacks run on the feed thread (or in flush(), one caller at a time),
+// never concurrently for one client and never after removeClient() returned.
+class WebFeed {
+public:
+    using Buffer = std::shared_ptr<const std::string>; // One frame, shared by all clients
+    using SendFn = std::function<void(const Buffer& frame, bool binary)>;
+    using CloseFn = std::function<void()>;
+
+    enum class Protocol { Json, Binary };
+    enum class FlowControl { None, Ack }; // Ack: the client acknowledges every frame
+
+    struct Config {
+        std::chrono::milliseconds tick{100};            // Coalescing period (0 = no thread, call flush())
+        size_t maxInFlight = 8;                         // Unacknowledged frames allowed per ack client
+        size_t maxBytesPerSec = 8u << 20;               // Per plain client (0 = unbounded)
+        std::chrono::milliseconds laggardTimeout{10000}; // Backlogged this long: disconnect
+        double gridCellDeg = 0.5;                       // Routing grid resolution
+        std::chrono::milliseconds vesselTimeout{600000}; // Silent this long: handle freed (0 = never)
+    };
+
+    // What a client wants to see. Without a box or vessel list it gets everything; with
+    // both, a vessel is sent if it is inside the box or on the list.
+    struct Subscription {
+        bool hasBox = false;
+        GeoGrid::Box box;
+        std::vector<std::string> vessels; // Followed wherever they are (subscribe() dedupes)
+        double maxRate = 0.0;             // Frames per second (0 = every tick)
+
+        bool filters() const { return hasBox || !vessels.empty(); }
+    };
+
+    struct Stats {
+        uint64_t published = 0;    // Fixes handed to publish()
+        uint64_t coalesced = 0;    // Superseded by a newer fix of the same vessel before sending
+        uint64_t frames = 0;       // Frames handed to clients
+        uint64_t bytes = 0;
+        uint64_t disconnected = 0; // Laggards closed
+        uint64_t backlogged = 0;   // Clients at their in-flight limit or byte budget
+        uint64_t plainClients = 0; // Without acks: paced by byte budget only
+        uint64_t clients = 0;
+        uint64_t binaryClients = 0;
+        uint64_t subscribed = 0;   // Clients with a box or vessel filter
+        uint64_t vessels = 0;      // Live handles
+        uint64_t expired = 0;      // Handles freed after vesselTimeout
+    };
+
+    explicit WebFeed(Config config);
+    ~WebFeed();
+
+    void start();
+    void stop();
+
+    // PRODUCER: replaces any unsent fix of the same vessel. Never blocks on clients.
+    void publish(const GPSData& fix);
+
+    // Transport side (e.g. WebSocket open/close/message handlers)
+    uint64_t addClient(SendFn send, CloseFn close);
+    void removeClient(uint64_t id);
+    void acknowledge(uint64_t id);
+    void setProtocol(uint64_t id, Protocol protocol);
+    // Switching resets the window: frames sent before the switch are not expected back
+    void setFlowControl(uint64_t id, FlowControl flow);
+    // Replaces the client's subscription; the next tick sends what newly matches
+    void subscribe(uint64_t id, Subscription sub);
+
+    // One tick: pack pending updates and send what each client's window allows
+    void flush();
+
+    Stats stats() const;
+
+private:
+    struct Client {
+        uint64_t id = 0;
+        SendFn send;
+        CloseFn close;
+        std::mutex mtx;                                 // Serializes callbacks against removal
+        bool gone = false;
+        Protocol protocol = Protocol::Json;
+        FlowControl flow = FlowControl::None;
+        size_t inFlight = 0;                            // Ack clients only
+        int64_t budgetStartMs = 0;                      // Plain clients: current second...
+        size_t budgetBytes = 0;                         // ...and the bytes sent in it
+        int64_t stalledSinceMs = 0;                     // 0 = keeping up
+        std::unordered_map<uint32_t, GPSData> pending;  // Newest unsent fix per vessel handle
+        std::unordered_map<uint32_t, WireFormat::State> sent; // Binary: delta base per handle
+        Subscription sub;
+        bool resubscribed = false;                      // Feed thread still has to apply 'sub'
+        std::vector<uint32_t> followed;                 // sub.vessels as handles (feed thread)
+        int64_t nextDueMs = 0;                          // maxRate: earliest next frame
+    };
+    using Update = std::pair<uint32_t, const GPSData*>; // Vessel handle, fix
+    using ClientList = std::vector<std::shared_ptr<Client>>;
+
+    Config config;
+    std::thread ticker;
+    std::atomic<bool> stopping{false};
+    std::mutex tickMtx;  // Only for sleeping on cv
+    std::condition_variable cv;
+
+    std::mutex latestMtx;
+    std::unordered_map<std::string, GPSData> latest; // This tick's updates
+
+    // Feed thread only: vessel ID <-> handle (index into names)
+    std::unordered_map<std::string, uint32_t> handles;
+    std::vector<std::string> names;
+    std::vector<GPSData> lastFix;     // Per handle; empty ID = never seen
+    std::vector<int64_t> lastSeenMs;  // Per handle
+    std::vector<uint32_t> freeHandles; // Expired, ready for reuse
+    int64_t nextSweepMs = 0;
+    GeoGrid positions;            // Last position per handle
+    GeoGrid tickGrid;             // This tick's updates, by index into the update list
+
+    // Copy-on-write: the feed thread takes a snapshot, add/remove replace it under listMtx
+    std::mutex listMtx;
+    std::shared_ptr<const ClientList> clients;
+    uint64_t nextId = 1;
+
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> disconnected{0};
+    std::atomic<uint64_t> liveVessels{0};
+    std::atomic<uint64_t> expired{0};
+
+    void run();
+    std::shared_ptr<Client> find(uint64_t id) const;
+    uint32_t handleFor(const std::string& id);
+    void expireSilent(int64_t now, std::vector<uint32_t>& freed);
+    bool windowOpen(Client& c, int64_t now) const;
+    void send(Client& c, const Buffer& frame, bool binary);
+    void sendFrame(Client& c, const std::vector<Update>& updates, Buffer* sharedJson);
+    void applySubscription(Client& c);
+    void route(const Client& c, const std::vector<Update>& updates, const std::vector<int32_t>& tickIndex,
+               std::vector<Update>& out) const;
+};
@@ -5,24 +5,33 @@
 #include <algorithm>
 #include <string>
 #include <iostream>
+#include "StaticAssets.h"
+#include "WebFeed.h"
 
 class WebServer {
 private:
     crow::SimpleApp app; // The Crow Application
-    
-    // List of active WebSocket connections
-    // We store pointers because Crow manages the actual connection objects
-    std::vector<crow::websocket::connection*> connections;
-    
-    // Mutex to protect the connection list from race conditions
-    std::mutex mtx;
+
+    // Per-client send windows and per-vessel coalescing; sends happen on the feed
+    // thread and Crow's I/O threads, never in broadcast()
+    WebFeed feed;
+
+    // frontend/dist in memory (with gzip/brotli variants), read-only after construction
+    StaticAssets assets;
+
+    void serveAsset(const crow::request& req, crow::response& res, const std::string& path);
 
 public:
     WebServer();
+    // webRoot: the built dashboard; empty = search next to the executable, then ../frontend/dist
+    explicit WebServer(WebFeed::Config feedConfig, const std::string& webRoot = "");
 
     // Blocking call that starts the server loop
     void run();
 
-    // Sends a JSON string to all connected clients
-    void broadcast(const std::string& message);
-};
\ No newline at end of file
+    // Queues a fix for all connected clients. Only the newest fix per vessel is kept
+    // until the next feed tick, which encodes it per client protocol (JSON or binary).
+    void broadcast(const GPSData& fix);
+
+    WebFeed::Stats stats() const { return feed.stats(); }
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "NMEAParser.h"
+
+// Binary WebSocket frame format (opt-in; JSON stays the default)
+//
+// A client switches with the control message {"protocol":"binary"}. Every frame is
+//   u8 VERSION | record*
+// and every record
+//   varint handle | varint field mask | fields in the mask
+// Handles are small per-server vessel numbers. NAME and TYPE (varint length + bytes) come
+// first, then the numeric fields in bit order, each a zig-zag varint delta against the
+// state last sent to this client for the handle. Unchanged fields are left out.
+//   NAME    first record of a handle for this client, or of a handle the server expired
+//           and gave to another vessel: vessel ID, state starts at zero
+//   TYPE    sentence type ("GPRMC", ...)
+//   LAT/LON 1e-7 degrees, TIME ms since midnight UTC, SPEED 0.01 kn, COURSE 0.01 deg,
+//   ALT dm, SATS, VALID 0/1
+// A moving vessel costs about 10 bytes per update instead of ~170 as JSON.
+namespace WireFormat {
+    constexpr uint8_t VERSION = 1;
+
+    enum Field : uint32_t {
+        LAT = 1u << 0,
+        LON = 1u << 1,
+        TIME = 1u << 2,
+        SPEED = 1u << 3,
+        COURSE = 1u << 4,
+        ALT = 1u << 5,
+        SATS = 1u << 6, // The usual changes fit a one-byte mask
+        VALID = 1u << 7,
+        TYPE = 1u << 8,
+        NAME = 1u << 9
+    };
+
+    // Fixed-point state of one vessel
+    struct State {
+        int64_t latE7 = 0, lonE7 = 0, timeMs = 0, speed = 0, course = 0, altDm = 0, sats = 0, valid = 0;
+        std::string type;
+    };
+
+    State toState(const GPSData& data);
+
+    // Appends the record taking a client from 'last' to 'now' (last == nullptr: new handle,
+    // name included). Returns false, appending nothing, if nothing changed.
+    bool encode(std::string& frame, uint32_t handle, const std::string& name, const State& now, const State* last);
+
+    // Client side (tests, tools): applies a frame to 'vessels' and lists the handles it
+    // touched, in order. False on a malformed frame.
+    struct Vessel {
+        std::string name;
+        State state;
+    };
+    bool decode(std::string_view frame, std::unordered_map<uint32_t, Vessel>& vessels, std::vector<uint32_t>& updated);
+}
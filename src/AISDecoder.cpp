@@ -0,0 +1,328 @@
+#include "AISDecoder.h"
+#include "NMEAParser.h"
+#include <cstring>
+
+namespace {
+
+// 6-bit armor table: '0'..'W' -> 0..39, '`'..'w' -> 40..63, everything else invalid
+constexpr std::array<uint8_t, 256> makeArmorTable() {
+    std::array<uint8_t, 256> table{};
+    for (auto& v : table) v = 0xFF;
+    for (int c = '0'; c <= 'W'; ++c) table[c] = static_cast<uint8_t>(c - '0');
+    for (int c = '`'; c <= 'w'; ++c) table[c] = static_cast<uint8_t>(c - '0' - 8);
+    return table;
+}
+constexpr std::array<uint8_t, 256> ARMOR = makeArmorTable();
+
+// 6-bit ASCII used by AIS text fields
+constexpr char SIXBIT_TEXT[] = "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_ !\"#$%&'()*+,-./0123456789:;<=>?";
+
+// Packed, MSB-first bit buffer over a decoded payload.
+// Reads past the end return zero bits (some transmitters send short type 5/24 messages).
+class AISBits {
+public:
+    bool load(std::string_view payload, int fillBits) {
+        if (payload.size() > AISDecoder::MAX_PAYLOAD_CHARS) return false;
+        std::memset(bytes, 0, sizeof(bytes));
+
+        size_t bit = 0;
+        for (char c : payload) {
+            uint8_t v = ARMOR[static_cast<unsigned char>(c)];
+            if (v == 0xFF) return false;
+            // Write 6 bits at 'bit' (spans at most two bytes)
+            unsigned shift = 10 - (bit & 7);  // Position inside a 16-bit window
+            unsigned window = static_cast<unsigned>(v) << shift;
+            bytes[bit >> 3] |= static_cast<uint8_t>(window >> 8);
+            bytes[(bit >> 3) + 1] |= static_cast<uint8_t>(window);
+            bit += 6;
+        }
+        if (fillBits < 0 || static_cast<size_t>(fillBits) > bit) return false;
+        count = bit - fillBits;
+        return true;
+    }
+
+    size_t size() const { return count; }
+
+    uint32_t u(size_t start, unsigned len) const {
+        // 40-bit window covers any 32-bit field at any bit offset
+        size_t byte = start >> 3;
+        uint64_t window = 0;
+        for (int k = 0; k < 5; ++k) window = (window << 8) | bytes[byte + k];
+        unsigned shift = 40 - (start & 7) - len;
+        uint32_t value = static_cast<uint32_t>((window >> shift) & ((uint64_t{1} << len) - 1));
+        // Mask off fill bits / anything past the end
+        if (start >= count) return 0;
+        if (start + len > count) value &= static_cast<uint32_t>(~((uint64_t{1} << (start + len - count)) - 1));
+        return value;
+    }
+
+    int32_t s(size_t start, unsigned len) const {
+        uint32_t v = u(start, len);
+        // Two's complement sign extension (len < 32)
+        if (v & (uint32_t{1} << (len - 1))) return static_cast<int32_t>(v) - static_cast<int32_t>(uint32_t{1} << len);
+        return static_cast<int32_t>(v);
+    }
+
+    // Decodes 'chars' 6-bit characters, trimming '@' padding and trailing spaces
+    template <size_t N>
+    void text(size_t start, size_t chars, char (&out)[N]) const {
+        size_t n = 0;
+        for (size_t k = 0; k < chars && n + 1 < N; ++k) {
+            char c = SIXBIT_TEXT[u(start + 6 * k, 6)];
+            if (c == '@') break;
+            out[n++] = c;
+        }
+        while (n > 0 && out[n - 1] == ' ') --n;
+        out[n] = '\0';
+    }
+
+private:
+    uint8_t bytes[AISDecoder::MAX_PAYLOAD_CHARS * 6 / 8 + 8];
+    size_t count = 0;
+};
+
+// Lat/lon are in 1/10000 minute: degrees * 1e7 = v * 1e7 / 600000 = v * 50 / 3
+int32_t toE7(int32_t tenThousandthMinutes) {
+    int64_t scaled = static_cast<int64_t>(tenThousandthMinutes) * 50;
+    return static_cast<int32_t>(scaled >= 0 ? (scaled + 1) / 3 : (scaled - 1) / 3);
+}
+
+// Small strict integer field (fragment numbers, sequence IDs, fill bits)
+int digitField(std::string_view s, int maxValue) {
+    if (s.size() != 1 || s[0] < '0' || s[0] > '9') return -1;
+    int v = s[0] - '0';
+    return v <= maxValue ? v : -1;
+}
+
+} // namespace
+
+uint8_t AISDecoder::armorValue(char c) {
+    return ARMOR[static_cast<unsigned char>(c)];
+}
+
+const AISVessel* AISDecoder::find(uint32_t mmsi) const {
+    auto it = vessels_.find(mmsi);
+    return it == vessels_.end() ? nullptr : &it->second;
+}
+
+AISDecoder::Update AISDecoder::decodeSentence(std::string_view sentence, uint64_t nowMs, const AISVessel*& vessel) {
+    vessel = nullptr;
+    if (!NMEAParser::validateChecksum(sentence)) {
+        stats_.errors++;
+        return Update::None;
+    }
+    NMEATokens t = NMEAParser::tokenize(sentence);
+    if (t.size() < 7) {
+        stats_.errors++;
+        return Update::None;
+    }
+    return decodeFragment(t[1], t[2], t[3], t[4], t[5], t[6], nowMs, vessel);
+}
+
+AISDecoder::Update AISDecoder::decodeFragment(std::string_view fragCount, std::string_view fragNum,
+                                              std::string_view seqId, std::string_view channel,
+                                              std::string_view payload, std::string_view fillBits,
+                                              uint64_t nowMs, const AISVessel*& vessel) {
+    vessel = nullptr;
+
+    // 1. Validate the envelope
+    int count = digitField(fragCount, 9);
+    int num = digitField(fragNum, 9);
+    int fill = digitField(fillBits, 5);
+    int seq = seqId.empty() ? -1 : digitField(seqId, 9);
+    char chan = channel.empty() ? 0 : channel[0];
+    if (count < 1 || num < 1 || num > count || fill < 0 || (!seqId.empty() && seq < 0)) {
+        stats_.errors++;
+        return Update::None;
+    }
+
+    // 2. Fast path: single-fragment messages decode straight from the sentence
+    if (count == 1) return decodePayload(payload, fill, nowMs, vessel);
+
+    // 3. Reassembly (fragments must arrive in order, as receivers send them)
+    expireSlots(nowMs);
+    Slot* slot = findSlot(seq, chan, count);
+
+    if (num == 1) {
+        if (slot != nullptr) stats_.fragmentsDropped += slot->nextFrag - 1; // Superseded
+        else slot = claimSlot();
+        slot->active = true;
+        slot->seqId = seq;
+        slot->channel = chan;
+        slot->fragCount = count;
+        slot->nextFrag = 1;
+        slot->startedMs = nowMs;
+        slot->length = 0;
+    } else if (slot == nullptr || slot->nextFrag != num) {
+        // Missing the start or a fragment in between: the message is unrecoverable
+        stats_.fragmentsDropped++;
+        if (slot != nullptr) {
+            stats_.fragmentsDropped += slot->nextFrag - 1;
+            slot->active = false;
+        }
+        return Update::None;
+    }
+
+    if (slot->length + payload.size() > MAX_PAYLOAD_CHARS) {
+        stats_.errors++;
+        slot->active = false;
+        return Update::None;
+    }
+    std::memcpy(slot->chars.data() + slot->length, payload.data(), payload.size());
+    slot->length += payload.size();
+    slot->nextFrag++;
+
+    if (num < count) return Update::None; // Wait for the rest
+
+    slot->active = false;
+    return decodePayload(std::string_view(slot->chars.data(), slot->length), fill, nowMs, vessel);
+}
+
+void AISDecoder::expireSlots(uint64_t nowMs) {
+    for (auto& slot : slots) {
+        if (slot.active && nowMs - slot.startedMs > timeoutMs) {
+            slot.active = false;
+            stats_.timeouts++;
+        }
+    }
+}
+
+AISDecoder::Slot* AISDecoder::findSlot(int seqId, char channel, int fragCount) {
+    for (auto& slot : slots) {
+        if (slot.active && slot.seqId == seqId && slot.channel == channel && slot.fragCount == fragCount) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+// Free slot if there is one, otherwise evict the oldest partial message
+AISDecoder::Slot* AISDecoder::claimSlot() {
+    Slot* oldest = &slots[0];
+    for (auto& slot : slots) {
+        if (!slot.active) return &slot;
+        if (slot.startedMs < oldest->startedMs) oldest = &slot;
+    }
+    stats_.fragmentsDropped += oldest->nextFrag - 1;
+    oldest->active = false;
+    return oldest;
+}
+
+AISDecoder::Update AISDecoder::decodePayload(std::string_view payload, int fillBits,
+                                             uint64_t nowMs, const AISVessel*& vessel) {
+    AISBits b;
+    if (!b.load(payload, fillBits) || b.size() < 38) {
+        stats_.errors++;
+        return Update::None;
+    }
+
+    unsigned type = b.u(0, 6);
+    uint32_t mmsi = b.u(8, 30);
+
+    // Minimum payload length per supported type (bits)
+    size_t minBits = 0;
+    switch (type) {
+        case 1: case 2: case 3: case 18: minBits = 168; break;
+        case 19: minBits = 312; break;
+        case 5:  minBits = 420; break; // Spec says 424, many transmitters send 420
+        case 24: minBits = 160; break;
+        default:
+            stats_.unsupported++;
+            return Update::None;
+    }
+    if (b.size() < minBits) {
+        stats_.errors++;
+        return Update::None;
+    }
+
+    stats_.messages++;
+    AISVessel& v = vessels_[mmsi];
+    v.mmsi = mmsi;
+    vessel = &v;
+
+    // Shared position layout; Class B fields sit 4 bits earlier than Class A
+    auto readPosition = [&](size_t sog, size_t lon, size_t lat, size_t cog, size_t hdg) {
+        uint32_t rawSog = b.u(sog, 10);
+        uint32_t rawCog = b.u(cog, 12);
+        int32_t rawLon = b.s(lon, 28);
+        int32_t rawLat = b.s(lat, 27);
+        v.speed = rawSog == 1023 ? 0.0 : rawSog / 10.0;
+        v.course = rawCog >= 3600 ? 0.0 : rawCog / 10.0;
+        v.heading = static_cast<int>(b.u(hdg, 9));
+        // 181 deg lon / 91 deg lat mean "not available"
+        if (rawLon == 181 * 600000 || rawLat == 91 * 600000) return Update::None;
+        if (rawLon < -180 * 600000 || rawLon > 180 * 600000 || rawLat < -90 * 600000 || rawLat > 90 * 600000) {
+            return Update::None;
+        }
+        v.latitudeE7 = toE7(rawLat);
+        v.longitudeE7 = toE7(rawLon);
+        v.hasPosition = true;
+        v.positionTimeMs = nowMs;
+        return Update::Position;
+    };
+
+    switch (type) {
+        // Class A position report
+        case 1: case 2: case 3:
+            v.positionClass = 'A';
+            v.navStatus = static_cast<int>(b.u(38, 4));
+            v.rateOfTurn = b.s(42, 8);
+            return readPosition(50, 61, 89, 116, 128);
+
+        // Class B position report
+        case 18:
+            v.positionClass = 'B';
+            return readPosition(46, 57, 85, 112, 124);
+
+        // Extended Class B: position plus static data
+        case 19: {
+            v.positionClass = 'B';
+            b.text(143, 20, v.name);
+            v.shipType = static_cast<int>(b.u(263, 8));
+            v.toBow = static_cast<int>(b.u(271, 9));
+            v.toStern = static_cast<int>(b.u(280, 9));
+            v.toPort = static_cast<int>(b.u(289, 6));
+            v.toStarboard = static_cast<int>(b.u(295, 6));
+            v.hasStatic = true;
+            v.staticTimeMs = nowMs;
+            return readPosition(46, 57, 85, 112, 124);
+        }
+
+        // Static and voyage related data
+        case 5:
+            v.imo = b.u(40, 30);
+            b.text(70, 7, v.callsign);
+            b.text(112, 20, v.name);
+            v.shipType = static_cast<int>(b.u(232, 8));
+            v.toBow = static_cast<int>(b.u(240, 9));
+            v.toStern = static_cast<int>(b.u(249, 9));
+            v.toPort = static_cast<int>(b.u(258, 6));
+            v.toStarboard = static_cast<int>(b.u(264, 6));
+            v.draught = b.u(294, 8) / 10.0;
+            b.text(302, 20, v.destination);
+            v.hasStatic = true;
+            v.staticTimeMs = nowMs;
+            return Update::Static;
+
+        // Static data report (Part A: name, Part B: type, callsign, dimensions)
+        case 24:
+            if (b.u(38, 2) == 0) {
+                b.text(40, 20, v.name);
+            } else {
+                if (b.u(38, 2) != 1 || b.size() < 168) {
+                    stats_.errors++;
+                    return Update::None;
+                }
+                v.shipType = static_cast<int>(b.u(40, 8));
+                b.text(90, 7, v.callsign);
+                v.toBow = static_cast<int>(b.u(132, 9));
+                v.toStern = static_cast<int>(b.u(141, 9));
+                v.toPort = static_cast<int>(b.u(150, 6));
+                v.toStarboard = static_cast<int>(b.u(156, 6));
+            }
+            v.hasStatic = true;
+            v.staticTimeMs = nowMs;
+            return Update::Static;
+    }
+    return Update::None;
+}
@@ -0,0 +1,189 @@
+#include "BufferedSerialSource.h"
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+BufferedSerialSource::BufferedSerialSource(Config cfg) : config(std::move(cfg)) {
+    size_t size = 256;
+    while (size < config.ringBytes) size <<= 1;
+    ring = std::make_unique<char[]>(size);
+    mask = size - 1;
+}
+
+BufferedSerialSource::~BufferedSerialSource() {
+    close();
+}
+
+bool BufferedSerialSource::baudConstant(int baud, speed_t& out) {
+    switch (baud) {
+        case 4800:   out = B4800;   return true;
+        case 9600:   out = B9600;   return true;
+        case 19200:  out = B19200;  return true;
+        case 38400:  out = B38400;  return true;
+        case 57600:  out = B57600;  return true;
+        case 115200: out = B115200; return true;
+        case 230400: out = B230400; return true;
+#ifdef B460800
+        case 460800: out = B460800; return true;
+#endif
+#ifdef B921600
+        case 921600: out = B921600; return true;
+#endif
+        default: return false;
+    }
+}
+
+bool BufferedSerialSource::open() {
+    speed_t speed;
+    if (!baudConstant(config.baud, speed)) {
+        std::cerr << "Serial: Unsupported baud rate " << config.baud << std::endl;
+        return false;
+    }
+
+    // 1. Open the device (no O_SYNC: that only slows writes, and we never write)
+    serial_fd = ::open(config.device.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (serial_fd < 0) {
+        perror("Serial Open Error");
+        return false;
+    }
+
+    // 2. Raw mode: no line discipline, no echo, no CR/LF translation, 8N1
+    termios tty;
+    if (tcgetattr(serial_fd, &tty) != 0) {
+        perror("Serial tcgetattr");
+        close();
+        return false;
+    }
+    cfmakeraw(&tty);
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
+    tty.c_cflag |= (CLOCAL | CREAD);   // ignore modem controls, enable reading
+    tty.c_cflag &= ~(PARENB | CSTOPB); // 8N1
+    tty.c_cflag &= ~CRTSCTS;           // No hardware flow control
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+
+    // 3. Let the driver batch: wake on 'vmin' bytes or when the burst ends
+    tty.c_cc[VMIN] = config.vmin;
+    tty.c_cc[VTIME] = config.vtimeDs;
+
+    if (tcsetattr(serial_fd, TCSANOW, &tty) != 0) {
+        perror("Serial tcsetattr");
+        close();
+        return false;
+    }
+    tcflush(serial_fd, TCIFLUSH); // Drop whatever queued up at the old settings
+
+    head = tail = 0;
+    stats_ = Stats{};
+    readHardwareCounters(baseline);
+    haveBaseline = true;
+
+    std::cout << "Serial: Connected to " << config.device << " @ " << config.baud << " Baud (raw)" << std::endl;
+    return true;
+}
+
+void BufferedSerialSource::close() {
+    if (serial_fd >= 0) ::close(serial_fd);
+    serial_fd = -1;
+}
+
+ssize_t BufferedSerialSource::fill() {
+    // Contiguous free space after 'tail' (the ring may wrap)
+    size_t used = tail - head;
+    size_t free = mask + 1 - used;
+    if (free == 0) {
+        // Consumer fell a full ring behind: make room by dropping the oldest half
+        size_t drop = (mask + 1) / 2;
+        head += drop;
+        stats_.ringOverflows += drop;
+        free = drop;
+    }
+    size_t offset = tail & mask;
+    size_t span = std::min(free, mask + 1 - offset);
+
+    ssize_t n;
+    do {
+        n = ::read(serial_fd, ring.get() + offset, span);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0) {
+        tail += static_cast<size_t>(n);
+        stats_.bytes += static_cast<uint64_t>(n);
+        stats_.reads++;
+    }
+    return n;
+}
+
+size_t BufferedSerialSource::take(char* buf, size_t cap) {
+    size_t n = std::min(cap, tail - head);
+    size_t offset = head & mask;
+    size_t first = std::min(n, mask + 1 - offset);
+    std::memcpy(buf, ring.get() + offset, first);
+    std::memcpy(buf + first, ring.get(), n - first);
+    head += n;
+    return n;
+}
+
+size_t BufferedSerialSource::readChunk(char* buf, size_t cap) {
+    if (serial_fd < 0 || cap == 0) return 0;
+    while (head == tail) {
+        if (fill() <= 0) return 0; // Error or disconnect
+    }
+    return take(buf, cap);
+}
+
+IPollableSource::ReadResult BufferedSerialSource::tryRead(char* buf, size_t cap, size_t& n) {
+    if (head == tail) {
+        ssize_t r = fill();
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return ReadResult::WouldBlock;
+        if (r <= 0) return ReadResult::Closed;
+    }
+    n = take(buf, cap);
+    return ReadResult::Data;
+}
+
+std::string BufferedSerialSource::readLine() {
+    std::string sentence;
+    size_t scanned = head;
+    for (;;) {
+        // Look for '\n' in what is already buffered before touching the port
+        for (; scanned != tail; ++scanned) {
+            if (ring[scanned & mask] != '\n') continue;
+            sentence.resize(scanned - head);
+            take(sentence.data(), sentence.size());
+            head++; // Skip the '\n'
+            if (!sentence.empty() && sentence.back() == '\r') sentence.pop_back();
+            return sentence;
+        }
+        if (serial_fd < 0) return std::string();
+        size_t before = head;
+        if (fill() <= 0) return std::string(); // Error or disconnect
+        if (head != before) scanned = head;    // Ring overflowed: rescan from the new head
+    }
+}
+
+const BufferedSerialSource::Stats& BufferedSerialSource::stats() {
+    if (serial_fd >= 0 && haveBaseline) {
+        Stats now;
+        readHardwareCounters(now);
+        stats_.overruns = now.overruns - baseline.overruns;
+        stats_.frameErrors = now.frameErrors - baseline.frameErrors;
+        stats_.parityErrors = now.parityErrors - baseline.parityErrors;
+        stats_.breaks = now.breaks - baseline.breaks;
+    }
+    return stats_;
+}
+
+// Linux UART error counters; ptys and USB adapters without support leave them at 0
+void BufferedSerialSource::readHardwareCounters(Stats& out) const {
+    serial_icounter_struct ic{};
+    if (ioctl(serial_fd, TIOCGICOUNT, &ic) != 0) return;
+    out.overruns = static_cast<uint64_t>(ic.overrun) + static_cast<uint64_t>(ic.buf_overrun);
+    out.frameErrors = static_cast<uint64_t>(ic.frame);
+    out.parityErrors = static_cast<uint64_t>(ic.parity);
+    out.breaks = static_cast<uint64_t>(ic.brk);
+}
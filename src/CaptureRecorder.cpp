@@ -0,0 +1,375 @@
+#include "CaptureRecorder.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#ifdef NMEA_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace CaptureFormat;
+
+namespace {
+// Record header inside a block (before source ID and bytes)
+constexpr size_t RECORD_HEADER = 8 + 2 + 4;
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T)); // Little-endian host layout
+}
+
+template <typename T>
+T get(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+bool readExact(int fd, void* buf, size_t len, off_t at) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, at);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        at += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+}
+
+uint32_t CaptureFormat::crc32(const void* data, size_t len) {
+    // Table-driven CRC-32 (IEEE), table built on first use
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    const auto* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool CaptureFormat::codecAvailable(Codec codec) {
+    switch (codec) {
+        case Codec::None: return true;
+#ifdef NMEA_HAVE_ZLIB
+        case Codec::Zlib: return true;
+#endif
+        default: return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Recorder
+// ---------------------------------------------------------------------------
+
+CaptureRecorder::CaptureRecorder(Config cfg)
+    : config(std::move(cfg)), writer(config.queueCapacity, 256) {
+    if (!codecAvailable(config.codec)) {
+        std::cerr << "Capture: codec not built in, storing blocks uncompressed" << std::endl;
+        config.codec = Codec::None;
+    }
+    block.reserve(config.blockBytes + 1024);
+}
+
+CaptureRecorder::~CaptureRecorder() {
+    stop();
+}
+
+bool CaptureRecorder::start() {
+    if (started) return true;
+    if (mkdir(config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror("Capture: mkdir");
+        return false;
+    }
+    started = true;
+    writer.start([this](RawPacket* batch, size_t n) { writeBatch(batch, n); },
+                 [this] {
+                     flushBlock();
+                     closeSegment();
+                 });
+    return true;
+}
+
+void CaptureRecorder::stop() {
+    if (!started) return;
+    started = false;
+    writer.stop(); // Writes the last partial block, closes the segment
+}
+
+void CaptureRecorder::record(std::string_view sourceID, uint64_t receivedNs, std::string_view bytes) {
+    record(RawPacket{std::string(sourceID), std::string(bytes), receivedNs});
+}
+
+void CaptureRecorder::record(RawPacket packet) {
+    writer.push(std::move(packet)); // Full: counted as dropped, ingest keeps going
+}
+
+void CaptureRecorder::writeBatch(RawPacket* batch, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (blockRecords == 0) blockStarted = std::chrono::steady_clock::now();
+        append(batch[i]);
+    }
+
+    // A slow trickle still reaches disk: bounds what a crash could lose
+    if (blockRecords > 0 && std::chrono::steady_clock::now() - blockStarted >= config.flushInterval) {
+        flushBlock();
+    }
+}
+
+void CaptureRecorder::append(const RawPacket& p) {
+    if (datafd < 0 && !openSegment(p.receivedNs)) {
+        writeErrors++;
+        return;
+    }
+    if (blockRecords == 0) blockFirstNs = p.receivedNs;
+    blockLastNs = p.receivedNs;
+
+    // 1. Serialize the record into the open block
+    uint16_t idLen = static_cast<uint16_t>(std::min<size_t>(p.sourceID.size(), UINT16_MAX));
+    put<uint64_t>(block, p.receivedNs);
+    put<uint16_t>(block, idLen);
+    put<uint32_t>(block, static_cast<uint32_t>(p.nmeaString.size()));
+    block.append(p.sourceID.data(), idLen);
+    block.append(p.nmeaString);
+    blockRecords++;
+    packets++;
+    bytesIn += p.nmeaString.size();
+
+    // 2. Full block: write it, roll the segment if it grew too big
+    if (block.size() >= config.blockBytes) {
+        flushBlock();
+        if (segmentStored >= config.segmentBytes) closeSegment();
+    }
+}
+
+void CaptureRecorder::flushBlock() {
+    if (blockRecords == 0 || datafd < 0) return;
+
+    // 1. Compress (falls back to raw if it doesn't shrink)
+    Codec codec = Codec::None;
+    const std::string* payload = &block;
+#ifdef NMEA_HAVE_ZLIB
+    if (config.codec == Codec::Zlib) {
+        uLongf len = compressBound(static_cast<uLong>(block.size()));
+        stored.resize(len);
+        if (compress2(reinterpret_cast<Bytef*>(&stored[0]), &len,
+                      reinterpret_cast<const Bytef*>(block.data()), static_cast<uLong>(block.size()), 1) == Z_OK &&
+            len < block.size()) {
+            stored.resize(len);
+            payload = &stored;
+            codec = Codec::Zlib;
+        }
+    }
+#endif
+
+    // 2. Header + payload, then the index entry pointing at it
+    BlockHeader h{};
+    h.magic = BLOCK_MAGIC;
+    h.codec = static_cast<uint8_t>(codec);
+    h.rawBytes = static_cast<uint32_t>(block.size());
+    h.storedBytes = static_cast<uint32_t>(payload->size());
+    h.records = blockRecords;
+    h.firstNs = blockFirstNs;
+    h.lastNs = blockLastNs;
+    h.crc = crc32(payload->data(), payload->size());
+
+    IndexEntry e{blockFirstNs, 0};
+    off_t at = lseek(datafd, 0, SEEK_END);
+    e.offset = static_cast<uint64_t>(at);
+    if (at < 0 || !writeAll(datafd, &h, sizeof(h)) || !writeAll(datafd, payload->data(), payload->size()) ||
+        !writeAll(indexfd, &e, sizeof(e))) {
+        writeErrors++;
+    }
+
+    segmentStored += sizeof(h) + payload->size();
+    bytesStored += sizeof(h) + payload->size();
+    blocks++;
+    block.clear();
+    blockRecords = 0;
+}
+
+bool CaptureRecorder::openSegment(uint64_t firstNs) {
+    std::string base = config.directory + "/capture-" + std::to_string(firstNs);
+    datafd = ::open((base + ".nmeacap").c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    indexfd = ::open((base + ".idx").c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (datafd < 0 || indexfd < 0) {
+        perror("Capture: open segment");
+        closeSegment();
+        return false;
+    }
+    // New (empty) file gets the magic; an existing one is appended to
+    if (lseek(datafd, 0, SEEK_END) == 0) writeAll(datafd, FILE_MAGIC, sizeof(FILE_MAGIC));
+    segmentStored = sizeof(FILE_MAGIC);
+    segments++;
+    return true;
+}
+
+void CaptureRecorder::closeSegment() {
+    if (datafd >= 0) {
+        fdatasync(datafd); // Segment boundaries are durable
+        ::close(datafd);
+    }
+    if (indexfd >= 0) ::close(indexfd);
+    datafd = indexfd = -1;
+}
+
+bool CaptureRecorder::writeAll(int fd, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+CaptureRecorder::Stats CaptureRecorder::stats() const {
+    Stats s;
+    s.packets = packets;
+    s.bytesIn = bytesIn;
+    s.bytesStored = bytesStored;
+    s.blocks = blocks;
+    s.segments = segments;
+    s.dropped = writer.queueStats().dropped;
+    s.writeErrors = writeErrors;
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+std::vector<std::string> CaptureReader::segments(const std::string& directory) {
+    std::vector<std::pair<uint64_t, std::string>> found;
+    if (DIR* d = opendir(directory.c_str())) {
+        while (dirent* e = readdir(d)) {
+            std::string name = e->d_name;
+            const std::string suffix = ".nmeacap";
+            if (name.rfind("capture-", 0) != 0 || name.size() <= suffix.size() ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            found.emplace_back(std::strtoull(name.c_str() + 8, nullptr, 10), directory + "/" + name);
+        }
+        closedir(d);
+    }
+    std::sort(found.begin(), found.end()); // Numeric, not lexical, time order
+    std::vector<std::string> paths;
+    for (auto& f : found) paths.push_back(std::move(f.second));
+    return paths;
+}
+
+bool CaptureReader::open(const std::string& segmentPath) {
+    close();
+    datafd = ::open(segmentPath.c_str(), O_RDONLY | O_CLOEXEC);
+    char magic[sizeof(FILE_MAGIC)];
+    if (datafd < 0 || !readExact(datafd, magic, sizeof(magic), 0) ||
+        std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+        close();
+        return false;
+    }
+    offset = sizeof(FILE_MAGIC);
+
+    // The index is tiny (one entry per block): load it whole
+    std::string idxPath = segmentPath.substr(0, segmentPath.size() - 8) + ".idx";
+    int idx = ::open(idxPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (idx >= 0) {
+        struct stat st;
+        if (fstat(idx, &st) == 0) {
+            index.resize(static_cast<size_t>(st.st_size) / sizeof(IndexEntry));
+            if (!readExact(idx, index.data(), index.size() * sizeof(IndexEntry), 0)) index.clear();
+        }
+        ::close(idx);
+    }
+    return true;
+}
+
+void CaptureReader::close() {
+    if (datafd >= 0) ::close(datafd);
+    datafd = -1;
+    index.clear();
+    block.clear();
+    blockPos = 0;
+}
+
+bool CaptureReader::seek(uint64_t ns) {
+    if (index.empty()) return false;
+    // Last block starting at or before 'ns' (earlier packets in it are skipped by the caller)
+    auto it = std::upper_bound(index.begin(), index.end(), ns,
+                               [](uint64_t t, const IndexEntry& e) { return t < e.firstNs; });
+    if (it != index.begin()) --it;
+    offset = it->offset;
+    block.clear();
+    blockPos = 0;
+    return true;
+}
+
+bool CaptureReader::loadBlock() {
+    BlockHeader h;
+    if (!readExact(datafd, &h, sizeof(h), static_cast<off_t>(offset)) || h.magic != BLOCK_MAGIC) return false;
+
+    std::string payload(h.storedBytes, '\0');
+    if (!readExact(datafd, &payload[0], payload.size(), static_cast<off_t>(offset + sizeof(h))) ||
+        crc32(payload.data(), payload.size()) != h.crc) {
+        return false; // Torn write at the tail, or corruption
+    }
+    offset += sizeof(h) + h.storedBytes;
+
+    switch (static_cast<Codec>(h.codec)) {
+        case Codec::None:
+            block = std::move(payload);
+            break;
+#ifdef NMEA_HAVE_ZLIB
+        case Codec::Zlib: {
+            block.resize(h.rawBytes);
+            uLongf len = h.rawBytes;
+            if (uncompress(reinterpret_cast<Bytef*>(&block[0]), &len,
+                           reinterpret_cast<const Bytef*>(payload.data()), static_cast<uLong>(payload.size())) != Z_OK ||
+                len != h.rawBytes) {
+                return false;
+            }
+            break;
+        }
+#endif
+        default:
+            return false; // Codec not built in
+    }
+    blockPos = 0;
+    return true;
+}
+
+bool CaptureReader::next(RawPacket& packet) {
+    if (datafd < 0) return false;
+    if (blockPos >= block.size() && !loadBlock()) return false;
+
+    const char* p = block.data() + blockPos;
+    if (block.size() - blockPos < RECORD_HEADER) return false;
+    packet.receivedNs = get<uint64_t>(p);
+    uint16_t idLen = get<uint16_t>(p + 8);
+    uint32_t len = get<uint32_t>(p + 10);
+    if (block.size() - blockPos - RECORD_HEADER < size_t{idLen} + len) return false;
+
+    packet.sourceID.assign(p + RECORD_HEADER, idLen);
+    packet.nmeaString.assign(p + RECORD_HEADER + idLen, len);
+    blockPos += RECORD_HEADER + idLen + len;
+    return true;
+}
@@ -0,0 +1,100 @@
+#include "FixFusion.h"
+#include <cmath>
+
+namespace {
+// Which fusable sentence is this? (0 = pass through)
+unsigned sentenceKind(const std::string& type) {
+    if (type.size() != 5) return 0;
+    if (type.compare(2, 3, "GGA") == 0) return 1; // SEEN_GGA
+    if (type.compare(2, 3, "RMC") == 0) return 2; // SEEN_RMC
+    return 0;
+}
+}
+
+void FixFusion::add(const GPSData& data, Clock::time_point now) {
+    if (!data.isValid) return;
+    stats_.sentencesIn++;
+
+    // 1. Non-fusable sentences go straight out
+    unsigned kind = sentenceKind(data.type);
+    if (kind == 0) {
+        stats_.fixesOut++;
+        if (output) output(data);
+        return;
+    }
+
+    // 2. Rollover: a newer epoch from this source closes the old one
+    int64_t epochMs = std::llround(data.timestamp * 1000.0);
+    Pending& p = pending[data.ID];
+    if (p.active && p.epochMs != epochMs) {
+        stats_.rollovers++;
+        emit(p);
+    }
+
+    // 3. Merge into the current epoch
+    if (!p.active) {
+        p.fix = GPSData();
+        p.epochMs = epochMs;
+        p.seen = 0;
+        p.started = now;
+        p.active = true;
+    }
+    merge(p.fix, data, kind, p.seen);
+    p.seen |= kind;
+
+    // 4. Complete epoch: no reason to wait
+    if (p.seen == (SEEN_GGA | SEEN_RMC)) {
+        stats_.complete++;
+        emit(p);
+    }
+}
+
+void FixFusion::poll(Clock::time_point now) {
+    for (auto& [id, p] : pending) {
+        if (p.active && now - p.started >= timeout) {
+            stats_.timeouts++;
+            emit(p);
+        }
+    }
+}
+
+void FixFusion::flush() {
+    for (auto& [id, p] : pending) {
+        if (p.active) emit(p);
+    }
+}
+
+void FixFusion::emit(Pending& p) {
+    p.active = false;
+    stats_.fixesOut++;
+    if (output) output(p.fix);
+}
+
+// GGA owns altitude/satellites/quality, RMC owns speed/course/date; both carry position
+void FixFusion::merge(GPSData& fused, const GPSData& part, unsigned kind, unsigned seen) {
+    if (fused.type.empty()) {
+        fused.type = part.type;
+        fused.talker = part.talker;
+        fused.ID = part.ID;
+    } else if (fused.type.find(part.type) == std::string::npos) {
+        fused.type += "+" + part.type; // e.g. "GPGGA+GPRMC"
+    }
+
+    fused.isValid = true;
+    fused.timestamp = part.timestamp;
+    fused.latitude = part.latitude;
+    fused.longitude = part.longitude;
+    fused.latitudeE7 = part.latitudeE7;
+    fused.longitudeE7 = part.longitudeE7;
+
+    if (kind == SEEN_GGA) {
+        fused.altitude = part.altitude;
+        fused.satellites = part.satellites;
+        fused.fixQuality = part.fixQuality; // GGA quality (GPS/DGPS/RTK) beats RMC's A/V
+    } else {
+        fused.speed = part.speed;
+        fused.course = part.course;
+        fused.date = part.date;
+        if (!(seen & SEEN_GGA)) fused.fixQuality = part.fixQuality;
+    }
+}
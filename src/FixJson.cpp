@@ -0,0 +1,101 @@
+#include "FixJson.h"
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+
+namespace {
+void appendDouble(std::string& out, double v) {
+    if (!std::isfinite(v)) {
+        out.append("null", 4);
+        return;
+    }
+    // nlohmann's own Grisu2 formatter (what dump() calls, minus the DOM): std::to_chars'
+    // shortest digits differ from Grisu2's in the last place for ~1% of 16-17 digit values
+    char buf[64];
+    char* end = nlohmann::detail::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, static_cast<size_t>(end - buf));
+}
+
+void appendInt(std::string& out, int v) {
+    char buf[16];
+    char* end = std::to_chars(buf, buf + sizeof(buf), v).ptr;
+    out.append(buf, static_cast<size_t>(end - buf));
+}
+
+// Same escapes as nlohmann's dump() without ensure_ascii
+void appendString(std::string& out, const std::string& s) {
+    static const char HEX[] = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0; // Start of the pending unescaped run
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(s, run, i - run);
+        run = i + 1;
+        out.push_back('\\');
+        switch (c) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '\b': out.push_back('b'); break;
+            case '\t': out.push_back('t'); break;
+            case '\n': out.push_back('n'); break;
+            case '\f': out.push_back('f'); break;
+            case '\r': out.push_back('r'); break;
+            default:
+                out.append("u00", 3);
+                out.push_back(HEX[c >> 4]);
+                out.push_back(HEX[c & 0xF]);
+        }
+    }
+    out.append(s, run, s.size() - run);
+    out.push_back('"');
+}
+
+std::string& threadBuffer() {
+    thread_local std::string buffer;
+    buffer.clear(); // Keeps its capacity
+    return buffer;
+}
+}
+
+void FixJson::append(std::string& out, const GPSData& fix) {
+    // nlohmann objects are std::maps: keys come out sorted
+    out.append("{\"alt\":", 7);
+    appendDouble(out, fix.altitude);
+    out.append(",\"course\":", 10);
+    appendDouble(out, fix.course);
+    out.append(",\"id\":", 6);
+    appendString(out, fix.ID);
+    out.append(fix.isValid ? ",\"isValid\":true" : ",\"isValid\":false");
+    out.append(",\"lat\":", 7);
+    appendDouble(out, fix.latitude);
+    out.append(",\"lon\":", 7);
+    appendDouble(out, fix.longitude);
+    out.append(",\"sats\":", 8);
+    appendInt(out, fix.satellites);
+    out.append(",\"speed\":", 9);
+    appendDouble(out, fix.speed);
+    out.append(",\"timestamp\":", 13);
+    appendDouble(out, fix.timestamp);
+    out.append(",\"type\":", 8);
+    appendString(out, fix.type);
+    out.push_back('}');
+}
+
+std::string_view FixJson::write(const GPSData& fix) {
+    std::string& out = threadBuffer();
+    append(out, fix);
+    return out;
+}
+
+std::string_view FixJson::writeArray(const GPSData* fixes, size_t count) {
+    std::string& out = threadBuffer();
+    out.push_back('[');
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) out.push_back(',');
+        append(out, fixes[i]);
+    }
+    out.push_back(']');
+    return out;
+}
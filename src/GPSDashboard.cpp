@@ -20,6 +20,8 @@ void GPSDashboard::drawStaticLayout() {
 }
 
 void GPSDashboard::update(const GPSData& data) {
+    std::lock_guard<std::mutex> lock(mtx);
+
     // 1. Update the state
     fleet[data.ID] = data;
 
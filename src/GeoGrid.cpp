@@ -0,0 +1,121 @@
+#include "GeoGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+uint64_t key(uint32_t row, uint32_t col) {
+    return (static_cast<uint64_t>(row) << 32) | col;
+}
+
+// Into [-180, 180)
+double wrapLon(double lon) {
+    lon = std::fmod(lon + 180.0, 360.0);
+    if (lon < 0) lon += 360.0;
+    return lon - 180.0;
+}
+}
+
+bool GeoGrid::Box::contains(double lat, double lon) const {
+    if (lat < south || lat > north) return false;
+    if (west <= east) return lon >= west && lon <= east;
+    return lon >= west || lon <= east; // Across the antimeridian
+}
+
+bool GeoGrid::makeBox(double west, double south, double east, double north, Box& out) {
+    if (!std::isfinite(west) || !std::isfinite(south) || !std::isfinite(east) || !std::isfinite(north)) return false;
+    if (south > north) return false;
+    out.south = std::max(south, -90.0);
+    out.north = std::min(north, 90.0);
+    if (west <= east && east - west >= 360.0) {
+        out.west = -180.0;
+        out.east = 180.0;
+    } else {
+        out.west = wrapLon(west);
+        out.east = wrapLon(east);
+        if (out.east == -180.0 && east > west) out.east = 180.0; // East edge exactly on the antimeridian
+    }
+    return true;
+}
+
+GeoGrid::GeoGrid(double cell) : cellDeg(cell > 0 ? cell : 0.5) {
+    rows = static_cast<uint32_t>(std::ceil(180.0 / cellDeg));
+    cols = static_cast<uint32_t>(std::ceil(360.0 / cellDeg));
+}
+
+uint32_t GeoGrid::row(double lat) const {
+    double r = std::floor((lat + 90.0) / cellDeg);
+    return static_cast<uint32_t>(std::clamp(r, 0.0, static_cast<double>(rows - 1)));
+}
+
+uint32_t GeoGrid::col(double lon) const {
+    double c = std::floor((lon + 180.0) / cellDeg);
+    return static_cast<uint32_t>(std::clamp(c, 0.0, static_cast<double>(cols - 1)));
+}
+
+void GeoGrid::insert(uint32_t id, double lat, double lon) {
+    if (!std::isfinite(lat) || !std::isfinite(lon)) return;
+    uint64_t cell = key(row(lat), col(lon));
+
+    auto it = points.find(id);
+    if (it != points.end()) {
+        it->second.lat = lat;
+        it->second.lon = lon;
+        if (it->second.cell == cell) return;
+        erase(id);
+    }
+    cells[cell].push_back(id);
+    points[id] = Point{cell, lat, lon};
+}
+
+void GeoGrid::erase(uint32_t id) {
+    auto it = points.find(id);
+    if (it == points.end()) return;
+    auto c = cells.find(it->second.cell);
+    auto& ids = c->second;
+    ids.erase(std::find(ids.begin(), ids.end(), id)); // Cells hold a handful of points
+    if (ids.empty()) cells.erase(c);
+    points.erase(it);
+}
+
+void GeoGrid::clear() {
+    cells.clear();
+    points.clear();
+}
+
+void GeoGrid::query(const Box& box, std::vector<uint32_t>& out) const {
+    if (points.empty() || box.south > box.north) return;
+    if (box.west <= box.east) {
+        queryRange(box, box.west, box.east, out);
+    } else {
+        queryRange(box, box.west, 180.0, out);
+        queryRange(box, -180.0, box.east, out);
+    }
+}
+
+void GeoGrid::queryRange(const Box& box, double west, double east, std::vector<uint32_t>& out) const {
+    uint32_t r0 = row(box.south), r1 = row(box.north);
+    uint32_t c0 = col(west), c1 = col(east);
+
+    // 1. Walk whichever is smaller: the cells under the box, or the occupied cells
+    uint64_t boxCells = uint64_t(r1 - r0 + 1) * (c1 - c0 + 1);
+    auto emit = [&](const std::vector<uint32_t>& ids) {
+        // 2. Edge cells stick out of the box: check the points themselves
+        for (uint32_t id : ids) {
+            const Point& p = points.at(id);
+            if (p.lat >= box.south && p.lat <= box.north && p.lon >= west && p.lon <= east) out.push_back(id);
+        }
+    };
+    if (boxCells <= cells.size()) {
+        for (uint32_t r = r0; r <= r1; ++r) {
+            for (uint32_t c = c0; c <= c1; ++c) {
+                auto it = cells.find(key(r, c));
+                if (it != cells.end()) emit(it->second);
+            }
+        }
+        return;
+    }
+    for (const auto& cell : cells) {
+        uint32_t r = static_cast<uint32_t>(cell.first >> 32), c = static_cast<uint32_t>(cell.first);
+        if (r >= r0 && r <= r1 && c >= c0 && c <= c1) emit(cell.second);
+    }
+}
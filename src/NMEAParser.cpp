@@ -1,13 +1,16 @@
 #include "NMEAParser.h"
 #include "NMEASentences.h"
+#include "NMEAScanner.h"
+#include "NMEANumber.h"
 #include <cmath> // Will be needed later for math
 #include <sstream> // For stringstream in split 
 #include <string>
+#include <chrono>
 
 /* Logic:
 1. Validate Checksum
 2. Tokenize String
-3. Factory Dispatcher (Which sentence type?)
+3. Dispatch Table (Which sentence type? Any talker)
 4. Execution
 5. Return GPSData Object
 */
@@ -24,102 +27,198 @@ void NMEAParser::notifyListeners(const GPSData& data) {
 }
 
 // Internal helper: safely convert string to double
+// std::from_chars underneath: no std::string copy, no exceptions
 double NMEAParser::safeStod(std::string_view str) {
-    if (str.empty()) return 0.0;
-    try {
-        // std::stod requires std::string, so we cast
-        return std::stod(std::string(str));
-    } catch (...) {
-        return 0.0; // Return 0.0 on error instead of crashing
-    }
+    double value = 0.0;
+    return NMEANumber::parseDouble(str, value) ? value : 0.0; // 0.0 on error instead of crashing
 }
 
 // Internal helper: safely convert string to int
 int NMEAParser::safeStoi(std::string_view str) {
-    if (str.empty()) return 0;
-    try {
-        return std::stoi(std::string(str));
-    } catch (...) {
-        return 0; // Return 0 on error
-    }
+    int value = 0;
+    return NMEANumber::parseInt(str, value) ? value : 0; // 0 on error
 }
 
 
 // Main Parse Function
-GPSData NMEAParser::parse(const std::string& nmeastring) {
+GPSData NMEAParser::parse(std::string_view nmeastring) {
     GPSData result;
-    
-    // 1. Check Valid Checksum
-    if (!validateChecksum(nmeastring)) {
-        result.isValid = false;
-        return result; // Early return on invalid data
+
+    // NEW: If valid, notify everyone!
+    if (decodeInto(nmeastring, result, &aisDecoder)) {
+        notifyListeners(result);
     }
 
-      
-    // 2. Tokenize String
-     // We assume the payload starts at '$' and we split by comma
-    std::vector<std::string> tokens = split(nmeastring, ',');
-    if (tokens.empty()) return result; // Early return on empty data
+    return result;
+}
 
-    // 3. The Factory Dispatcher
-    // We use a pointer to the Interface (Polymorphism)
-    INMEASentence* parser = nullptr;
+bool NMEAParser::decode(std::string_view nmeastring, GPSData& data) {
+    return decodeInto(nmeastring, data, &aisDecoder);
+}
 
-    if (tokens[0] == "$GPGGA") {
-        parser = new GPGGASentence();
-    } else if (tokens[0] == "$GPRMC") {
-        parser = new GPRMCSentence();
+// Shared decode path for parse() and parseBatch()
+bool NMEAParser::decodeInto(std::string_view nmeastring, GPSData& result, AISDecoder* ais) {
+    result.isValid = false;
+
+    // 1 + 2. Check Valid Checksum and Tokenize String in one pass
+    // Field views point straight into 'nmeastring', no per-field copies
+    NMEATokens tokens;
+    if (!scanSentence(nmeastring, tokens) || tokens.empty()) {
+        return false; // Early return on invalid data
+    }
+
+    // 3. The Dispatcher
+    // Address is "$" + 2-char talker + 3-char formatter, e.g. "$GNGGA"
+    std::string_view address = tokens[0];
+    if (address.size() != 6) return false; // Proprietary ($P...) or malformed
+
+    // AIS is stateful (multi-fragment), so it bypasses the stateless table
+    std::string_view formatter = address.substr(3);
+    if (formatter == "VDM" || formatter == "VDO") {
+        if (ais == nullptr || !decodeAIS(tokens, result, *ais)) return false;
+        result.type = address.substr(1);
+        result.talker = address.substr(1, 2);
+        return true;
     }
 
+    const INMEASentence* parser = NMEASentenceTable::find(formatter);
+    if (parser == nullptr) return false; // Sentence type we don't decode
+
     // 4. Execution
-    if (parser != nullptr) {
-        result.isValid = true;
-        parser->parse(tokens, result);
-        delete parser;
-        
-        // NEW: If valid, notify everyone!
-        if (result.isValid) {
-            notifyListeners(result);
-        }
-    } else {
-        result.isValid = false;
+    result.isValid = true;
+    result.type = address.substr(1);
+    result.talker = address.substr(1, 2);
+    parser->parse(tokens, result);
+    return true;
+}
+
+// AIS: one fragment in, a position fix out once a position report completes
+bool NMEAParser::decodeAIS(const NMEATokens& t, GPSData& result, AISDecoder& ais) {
+    if (t.size() < 7) return false;
+
+    uint64_t nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    const AISVessel* vessel = nullptr;
+    if (ais.decodeFragment(t[1], t[2], t[3], t[4], t[5], t[6], nowMs, vessel) != AISDecoder::Update::Position) {
+        return false; // Partial message, static data or unsupported type
     }
 
-    return result;
+    // Each AIS report describes a different vessel, so it carries its own ID
+    result.isValid = true;
+    result.ID = std::to_string(vessel->mmsi);
+    result.latitudeE7 = vessel->latitudeE7;
+    result.longitudeE7 = vessel->longitudeE7;
+    result.latitude = vessel->latitudeE7 / 1e7;
+    result.longitude = vessel->longitudeE7 / 1e7;
+    result.speed = vessel->speed;
+    result.course = vessel->course;
+    result.fixQuality = 1;
+    return true;
 }
 
-// Helper: Checksum Validation
-bool NMEAParser::validateChecksum(const std::string& s) {
-    // 1. Identify the Payload
-    size_t dollar = s.find('$');
-    size_t asterisk = s.find('*');
-
-    // Edge Case: If chars are missing or out of order, it's garbage.
-    if (dollar == std::string::npos || asterisk == std::string::npos || asterisk < dollar) {
-        return false;
+// Batch Parse: fill columns directly, one reusable scratch row
+void NMEAParser::parseBatch(const std::string_view* sentences, size_t count, GPSBatch& out) {
+    out.resize(count);
+
+    GPSData row;
+    for (size_t i = 0; i < count; ++i) {
+        // Reset only what the decoders write (the strings keep their buffers)
+        row.latitude = row.longitude = row.speed = row.course = row.timestamp = 0.0;
+        row.fixQuality = 0;
+
+        // AIS needs per-stream reassembly state, so batches decode NMEA fixes only
+        if (!decodeInto(sentences[i], row, nullptr)) continue; // Row stays zeroed, bit stays clear
+
+        out.latitude[i] = row.latitude;
+        out.longitude[i] = row.longitude;
+        out.speed[i] = row.speed;
+        out.course[i] = row.course;
+        out.timestamp[i] = row.timestamp;
+        out.fixQuality[i] = static_cast<uint8_t>(row.fixQuality);
+        out.validBits[i >> 6] |= (uint64_t{1} << (i & 63));
     }
+}
+
+void NMEAParser::parseBatch(const std::vector<std::string>& sentences, GPSBatch& out) {
+    std::vector<std::string_view> views(sentences.begin(), sentences.end());
+    parseBatch(views.data(), views.size(), out);
+}
+
+void GPSBatch::resize(size_t rows) {
+    // assign() zeroes every element but keeps the allocation for the next batch
+    latitude.assign(rows, 0.0);
+    longitude.assign(rows, 0.0);
+    speed.assign(rows, 0.0);
+    course.assign(rows, 0.0);
+    timestamp.assign(rows, 0.0);
+    fixQuality.assign(rows, 0);
+    validBits.assign((rows + 63) / 64, 0);
+}
 
-    // 2. Implement the XOR Loop
-    int calculatedChecksum = 0;
-    // Loop only the payload (between delimiters)
-    for (size_t i = dollar + 1; i < asterisk; ++i) {
-        calculatedChecksum ^= s[i];
+size_t GPSBatch::validCount() const {
+    size_t n = 0;
+    for (uint64_t word : validBits) n += static_cast<size_t>(__builtin_popcountll(word));
+    return n;
+}
+
+// Helper: Checksum Validation
+bool NMEAParser::validateChecksum(std::string_view s) {
+    NMEATokens tokens;
+    return scanSentence(s, tokens);
+}
+
+// Helper: Zero-allocation Tokenizer
+NMEATokens NMEAParser::tokenize(std::string_view s) {
+    NMEATokens tokens;
+    scanSentence(s, tokens); // Fields are usable even if the checksum is wrong
+    return tokens;
+}
+
+// Helper: Single-pass Front End
+// One scanner pass finds '$', '*' and every ',' and computes the XOR checksum.
+bool NMEAParser::scanSentence(std::string_view s, NMEATokens& tokens) {
+    tokens.count = 0;
+
+    // 1. Scan (SIMD where the CPU allows it)
+    uint32_t commas[NMEATokens::MAX_FIELDS];
+    NMEAScan scan = NMEAScanner::scan(s, commas, NMEATokens::MAX_FIELDS);
+    if (scan.start == NMEAScan::npos) return false;
+
+    // 2. Find the end of the payload
+    size_t end = scan.star;
+    if (end == NMEAScan::npos) {
+        // No checksum: stop before any trailing line terminator
+        end = s.find_first_of("\r\n", scan.start);
+        if (end == std::string_view::npos) end = s.size();
     }
 
-    // 3. Validate
-    // Ensure there are at least 2 characters after the asterisk for the hex code
-    if (asterisk + 3 > s.length()) {
-        return false;
+    // Offsets are 16-bit; anything this long is not NMEA
+    if (end > UINT16_MAX) return false;
+
+    // 3. Turn comma offsets into (start, length) fields
+    size_t fieldCommas = 0;
+    while (fieldCommas < scan.commaCount && fieldCommas < NMEATokens::MAX_FIELDS &&
+           commas[fieldCommas] < end) {
+        fieldCommas++;
     }
+    if (fieldCommas >= NMEATokens::MAX_FIELDS) return false; // Too many fields: reject rather than truncate
 
-    // Extract the 2 hex characters after '*'
-    std::string providedHex = s.substr(asterisk + 1, 2);
-    int providedChecksum = hexToDecimal(providedHex);
+    tokens.sentence = s;
+    size_t fieldStart = scan.start;
+    for (size_t k = 0; k <= fieldCommas; ++k) {
+        size_t fieldEnd = (k < fieldCommas) ? commas[k] : end;
+        tokens.starts[k] = static_cast<uint16_t>(fieldStart);
+        tokens.lengths[k] = static_cast<uint16_t>(fieldEnd - fieldStart);
+        fieldStart = fieldEnd + 1;
+    }
+    tokens.count = fieldCommas + 1;
 
-    return calculatedChecksum == providedChecksum;
+    // 4. Validate: need '*' followed by 2 hex characters
+    if (scan.star == NMEAScan::npos || scan.star + 3 > s.size()) return false;
+    int providedChecksum = hexToDecimal(s.substr(scan.star + 1, 2));
+    return providedChecksum == scan.checksum;
 }
 
-
 // Helper: String Splitter
 std::vector<std::string> NMEAParser::split(const std::string& s, char delimiter) {
     std::vector<std::string> tokens;
@@ -136,40 +235,33 @@ std::vector<std::string> NMEAParser::split(const std::string& s, char delimiter)
     return tokens;
 }
 
+// Helper: UTC Time Converter (hhmmss.ss -> seconds since midnight)
+double NMEAParser::parseUtcTime(std::string_view hhmmss) {
+    int32_t millis = 0;
+    if (!NMEANumber::parseTimeMs(hhmmss, millis)) return 0.0;
+    return millis / 1000.0;
+}
+
 // Helper: Coordinate Converter
+// Decodes in fixed point (1e-7 degrees) and converts once at the end
 double NMEAParser::convertToDecimalDegrees(std::string_view nmeaPos, std::string_view direction) {
-    if (nmeaPos.empty()) return 0.0;
-
-    size_t decimalPos = nmeaPos.find('.');
-    if (decimalPos == std::string_view::npos || decimalPos < 2) return 0.0;
-
-    // Separate Degrees and Minutes
-    size_t minutesStart = decimalPos - 2;
-    std::string_view degStr = nmeaPos.substr(0, minutesStart);
-    std::string_view minStr = nmeaPos.substr(minutesStart);
-
-    // --- FIX: USE SAFE CONVERSION ---
-    double degrees = safeStod(degStr);
-    double minutes = safeStod(minStr);
-    // --------------------------------
-
-    double result = degrees + (minutes / 60.0);
-
-    if (direction == "S" || direction == "W") {
-        result *= -1.0;
-    }
-
-    return result;
+    int32_t e7 = 0;
+    if (!NMEANumber::parseCoordinateE7(nmeaPos, direction, e7)) return 0.0;
+    return e7 / 1e7;
 }
 
 // Helper: Hex Converter
-int NMEAParser::hexToDecimal(const std::string& hex) {
-    if (hex.empty()) return 0;
-       // std::stoi converts string to integer. Base 16 handles "A" -> 10, "F" -> 15.
-    try{
-        return std::stoi(hex, nullptr, 16);
-    } catch(const std::exception& e){
-        std::cerr << e.what() << '\n';
-        return 0;// Return 0 on error
+// Returns -1 if the input is not a valid hex number (never throws)
+int NMEAParser::hexToDecimal(std::string_view hex) {
+    if (hex.empty() || hex.size() > 7) return -1;
+    int value = 0;
+    for (char c : hex) {
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else return -1;
+        value = (value << 4) | digit;
     }
-}
\ No newline at end of file
+    return value;
+}
@@ -0,0 +1,187 @@
+#include "NMEAReactor.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+NMEAReactor::NMEAReactor(Config cfg) : config(cfg) {
+    config.chunkBytes = std::max<size_t>(1, config.chunkBytes);
+    config.readsPerWakeup = std::max<size_t>(1, config.readsPerWakeup);
+
+    size_t n = std::max<size_t>(1, config.threads);
+    for (size_t i = 0; i < n; ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epfd < 0 || loop->wakefd < 0) perror("Reactor: epoll/eventfd");
+
+        // data.ptr == nullptr marks the wake-up descriptor
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->wakefd, &ev);
+
+        loop->chunk.resize(config.chunkBytes);
+        loops.push_back(std::move(loop));
+    }
+}
+
+NMEAReactor::~NMEAReactor() {
+    stop();
+    for (auto& loop : loops) {
+        if (loop->epfd >= 0) ::close(loop->epfd);
+        if (loop->wakefd >= 0) ::close(loop->wakefd);
+    }
+}
+
+bool NMEAReactor::add(std::string sourceID, std::unique_ptr<IPollableSource> source, SentenceSink sink) {
+    if (!source || source->fd() < 0) return false;
+
+    // 1. Non-blocking from now on: a spurious wake-up must never stall the loop
+    int fd = source->fd();
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        perror("Reactor: O_NONBLOCK");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(entriesMtx);
+    auto entry = std::make_unique<Entry>();
+    entry->id = std::move(sourceID);
+    entry->source = std::move(source);
+    entry->sink = std::move(sink);
+
+    // 2. Pin to a loop round-robin; only that thread ever touches the framer
+    Loop& loop = *loops[nextLoop++ % loops.size()];
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.ptr = entry.get();
+    if (epoll_ctl(loop.epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("Reactor: epoll_ctl");
+        return false;
+    }
+    entries.push_back(std::move(entry));
+    return true;
+}
+
+void NMEAReactor::start() {
+    if (started) return;
+    started = true;
+    stopping = false;
+    for (auto& loop : loops) {
+        loop->thread = std::thread(&NMEAReactor::run, this, std::ref(*loop));
+    }
+}
+
+void NMEAReactor::stop() {
+    if (started) {
+        started = false;
+
+        // 1. Wake every loop out of epoll_wait and join
+        stopping = true;
+        for (auto& loop : loops) {
+            uint64_t one = 1;
+            if (::write(loop->wakefd, &one, sizeof(one)) < 0) perror("Reactor: wake");
+        }
+        for (auto& loop : loops) {
+            if (loop->thread.joinable()) loop->thread.join();
+        }
+    }
+
+    // 2. No thread reads any more: closing is safe now
+    std::lock_guard<std::mutex> lock(entriesMtx);
+    for (auto& entry : entries) {
+        if (entry->active) entry->source->close();
+        entry->active = false;
+    }
+}
+
+void NMEAReactor::run(Loop& loop) {
+    epoll_event events[64];
+    std::vector<Entry*> pending;
+
+    while (!stopping) {
+        // Don't sleep while a source still holds buffered data
+        int timeout = loop.backlog.empty() ? -1 : 0;
+        int n = epoll_wait(loop.epfd, events, 64, timeout);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("Reactor: epoll_wait");
+            break;
+        }
+
+        // Last round's leftovers first, then whatever became ready
+        pending.swap(loop.backlog);
+        loop.backlog.clear();
+        for (int i = 0; i < n; ++i) {
+            Entry* entry = static_cast<Entry*>(events[i].data.ptr);
+            if (entry == nullptr) continue; // Wake-up: loop condition handles it
+            if (std::find(pending.begin(), pending.end(), entry) == pending.end()) pending.push_back(entry);
+        }
+        for (Entry* entry : pending) {
+            if (stopping) break;
+            service(loop, *entry);
+        }
+        pending.clear();
+    }
+}
+
+// Drain one ready source (bounded, so a firehose can't starve its neighbours).
+// Level-triggered epoll reports it again next round if bytes are left.
+void NMEAReactor::service(Loop& loop, Entry& entry) {
+    if (!entry.active) return;
+
+    uint64_t before = entry.framer.stats().sentences;
+    uint64_t errorsBefore = entry.framer.stats().framingErrors;
+    auto emit = [&entry](std::string_view sentence) { entry.sink(sentence); };
+
+    for (size_t r = 0; r < config.readsPerWakeup; ++r) {
+        size_t got = 0;
+        auto result = entry.source->tryRead(loop.chunk.data(), loop.chunk.size(), got);
+        if (result == IPollableSource::ReadResult::WouldBlock) break;
+
+        if (result == IPollableSource::ReadResult::Closed) {
+            // EOF / error: stop watching it (the descriptor is closed in stop())
+            epoll_ctl(loop.epfd, EPOLL_CTL_DEL, entry.source->fd(), nullptr);
+            entry.active = false;
+            closedSources++;
+            if (closed) closed(entry.id);
+            break;
+        }
+
+        loop.bytes += got;
+        if (rawTap) {
+            uint64_t t = entry.source->receiveTimeNs();
+            if (t == 0) {
+                t = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count());
+            }
+            rawTap(entry.id, t, std::string_view(loop.chunk.data(), got));
+        }
+        entry.framer.feed(loop.chunk.data(), got, emit);
+        if (entry.source->isMessageOriented()) entry.framer.endOfMessage(emit);
+    }
+
+    if (entry.active && entry.source->hasBuffered()) loop.backlog.push_back(&entry);
+
+    loop.sentences += entry.framer.stats().sentences - before;
+    loop.framingErrors += entry.framer.stats().framingErrors - errorsBefore;
+}
+
+size_t NMEAReactor::sourceCount() const {
+    std::lock_guard<std::mutex> lock(entriesMtx);
+    return entries.size();
+}
+
+NMEAReactor::Stats NMEAReactor::stats() const {
+    Stats s;
+    for (const auto& loop : loops) {
+        s.bytes += loop->bytes;
+        s.sentences += loop->sentences;
+        s.framingErrors += loop->framingErrors;
+    }
+    s.closedSources = closedSources;
+    return s;
+}
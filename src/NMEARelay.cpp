@@ -0,0 +1,380 @@
+#include "NMEARelay.h"
+#include "NMEAParser.h"
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+namespace {
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+NMEARelay::NMEARelay(Config cfg)
+    : config(std::move(cfg)),
+      clients(std::make_shared<const ClientList>()),
+      dedupHash(new std::atomic<uint64_t>[DEDUP_SLOTS]),
+      dedupTimeMs(new std::atomic<int64_t>[DEDUP_SLOTS]) {
+    // Blocking would let one dead client stall every publisher
+    if (config.overflow == OverflowPolicy::Block) config.overflow = OverflowPolicy::DropNewest;
+    for (size_t i = 0; i < DEDUP_SLOTS; ++i) {
+        dedupHash[i].store(0, std::memory_order_relaxed);
+        dedupTimeMs[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+NMEARelay::~NMEARelay() {
+    stop();
+}
+
+bool NMEARelay::start() {
+    if (started) return true;
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epfd < 0 || wakefd < 0) {
+        perror("Relay: epoll/eventfd");
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr; // nullptr = wake-up, &listenfd = listener, otherwise a Client
+    epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev);
+
+    // 1. TCP listener
+    if (config.tcpPort >= 0) {
+        listenfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port = htons(static_cast<uint16_t>(config.tcpPort));
+        if (listenfd < 0 || bind(listenfd, (const sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenfd, 16) < 0) {
+            perror("Relay: TCP listen");
+            return false;
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listenfd, (sockaddr*)&addr, &len);
+        boundPort = ntohs(addr.sin_port);
+
+        ev.events = EPOLLIN;
+        ev.data.ptr = &listenfd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, listenfd, &ev);
+    }
+
+    // 2. UDP targets share one unconnected socket
+    if (!config.udpTargets.empty()) {
+        udpfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(udpfd, SOL_SOCKET, SO_BROADCAST, &one, sizeof(one)); // Allow x.x.x.255 targets
+        for (const auto& target : config.udpTargets) {
+            size_t colon = target.rfind(':');
+            addrinfo hints{};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_DGRAM;
+            addrinfo* res = nullptr;
+            if (colon == std::string::npos ||
+                getaddrinfo(target.substr(0, colon).c_str(), target.c_str() + colon + 1, &hints, &res) != 0) {
+                std::cerr << "Relay: Bad UDP target " << target << std::endl;
+                continue;
+            }
+            auto client = std::make_shared<Client>(config.clientQueue, config.overflow);
+            client->fd = udpfd;
+            client->tcp = false;
+            std::memcpy(&client->addr, res->ai_addr, res->ai_addrlen);
+            client->addrLen = res->ai_addrlen;
+            freeaddrinfo(res);
+            addClient(std::move(client));
+        }
+    }
+
+    started = true;
+    stopping = false;
+    sender = std::thread(&NMEARelay::run, this);
+    return true;
+}
+
+void NMEARelay::stop() {
+    if (started) {
+        started = false;
+        stopping = true;
+        uint64_t one = 1;
+        if (::write(wakefd, &one, sizeof(one)) < 0) perror("Relay: wake");
+        if (sender.joinable()) sender.join();
+    }
+
+    // Sender is gone: close everything it owned
+    auto list = std::atomic_load(&clients);
+    for (const auto& c : *list) {
+        if (c->tcp) ::close(c->fd);
+    }
+    std::atomic_store(&clients, std::make_shared<const ClientList>());
+    for (int* fd : {&listenfd, &udpfd, &epfd, &wakefd}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+}
+
+// Formatter and source filters (body = sentence without CR/LF)
+bool NMEARelay::accepts(std::string_view sourceID, std::string_view body) const {
+    if (!config.sources.empty() &&
+        std::find(config.sources.begin(), config.sources.end(), sourceID) == config.sources.end()) {
+        return false;
+    }
+    if (!config.formatters.empty()) {
+        // "$GPGGA,..." / "!AIVDM,...": formatter follows the 2-char talker
+        std::string_view formatter = body.size() >= 6 ? body.substr(3, 3) : std::string_view();
+        if (std::find(config.formatters.begin(), config.formatters.end(), formatter) == config.formatters.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NMEARelay::isDuplicate(std::string_view body) {
+    uint64_t h = std::hash<std::string_view>{}(body) | 1; // 0 marks an empty slot
+    size_t slot = h & (DEDUP_SLOTS - 1);
+    int64_t now = nowMs();
+
+    bool dup = dedupHash[slot].load(std::memory_order_relaxed) == h &&
+               now - dedupTimeMs[slot].load(std::memory_order_relaxed) < config.dedupWindow.count();
+    if (!dup) {
+        dedupHash[slot].store(h, std::memory_order_relaxed);
+        dedupTimeMs[slot].store(now, std::memory_order_relaxed);
+    }
+    return dup;
+}
+
+void NMEARelay::publish(std::string_view sourceID, std::string_view sentence) {
+    // 1. Strip the terminator, validate, filter, dedup
+    while (!sentence.empty() && (sentence.back() == '\r' || sentence.back() == '\n')) sentence.remove_suffix(1);
+    if (!NMEAParser::validateChecksum(sentence)) {
+        invalid++;
+        return;
+    }
+    if (!accepts(sourceID, sentence)) {
+        filtered++;
+        return;
+    }
+    if (config.dedupWindow.count() > 0 && isDuplicate(sentence)) {
+        duplicates++;
+        return;
+    }
+
+    auto list = std::atomic_load(&clients);
+    if (list->empty()) return;
+
+    // 2. One copy, shared by every client queue
+    auto buffer = std::make_shared<std::string>();
+    buffer->reserve(sentence.size() + 2);
+    buffer->append(sentence).append("\r\n");
+    Buffer shared = std::move(buffer);
+    for (const auto& c : *list) c->queue.push(Buffer(shared)); // Full queue: policy drops, never blocks
+    published++;
+
+    // 3. Wake the sender once per burst, not once per sentence
+    if (!wakePending.exchange(true)) {
+        uint64_t one = 1;
+        if (::write(wakefd, &one, sizeof(one)) < 0 && errno != EAGAIN) perror("Relay: wake");
+    }
+}
+
+void NMEARelay::run() {
+    epoll_event events[64];
+    bool more = false;
+
+    while (!stopping) {
+        int n = epoll_wait(epfd, events, 64, more ? 0 : 100);
+        if (n < 0 && errno != EINTR) {
+            perror("Relay: epoll_wait");
+            break;
+        }
+
+        auto list = std::atomic_load(&clients);
+        for (int i = 0; i < n; ++i) {
+            void* tag = events[i].data.ptr;
+            if (tag == nullptr) {
+                uint64_t count;
+                while (::read(wakefd, &count, sizeof(count)) > 0) {}
+            } else if (tag == &listenfd) {
+                acceptClients();
+            } else if (events[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+                // Find the owning pointer so removal keeps the snapshot consistent
+                for (const auto& c : *list) {
+                    if (c.get() == tag) removeClient(c);
+                }
+            } else if (events[i].events & EPOLLIN) {
+                // Clients are listeners: discard anything they send us
+                char sink[512];
+                Client* c = static_cast<Client*>(tag);
+                while (::recv(c->fd, sink, sizeof(sink), MSG_DONTWAIT) > 0) {}
+            }
+            // EPOLLOUT needs no action here: the flush pass below retries every client
+        }
+        wakePending.exchange(false); // Acquire: sees every push made before the publisher's wake
+
+        // Flush every client (a bounded amount each, so one busy socket can't hog the thread)
+        more = false;
+        list = std::atomic_load(&clients);
+        for (const auto& c : *list) {
+            if (c->tcp) {
+                if (!flushTcp(*c, more)) removeClient(c);
+            } else {
+                flushUdp(*c, more);
+            }
+        }
+    }
+}
+
+void NMEARelay::acceptClients() {
+    for (;;) {
+        int fd = accept4(listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return; // EAGAIN: no more pending connections
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Sentences are tiny, don't batch them up
+
+        auto client = std::make_shared<Client>(config.clientQueue, config.overflow);
+        client->fd = fd;
+        client->tcp = true;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = client.get();
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+        addClient(std::move(client));
+    }
+}
+
+void NMEARelay::addClient(std::shared_ptr<Client> client) {
+    auto next = std::make_shared<ClientList>(*std::atomic_load(&clients));
+    next->push_back(std::move(client));
+    std::atomic_store(&clients, std::shared_ptr<const ClientList>(std::move(next)));
+}
+
+void NMEARelay::removeClient(const std::shared_ptr<Client>& client) {
+    auto current = std::atomic_load(&clients);
+    auto next = std::make_shared<ClientList>();
+    for (const auto& c : *current) {
+        if (c != client) next->push_back(c);
+    }
+    if (next->size() == current->size()) return; // Already gone
+
+    auto s = client->queue.stats();
+    droppedByGone += s.dropped + s.evicted;
+    epoll_ctl(epfd, EPOLL_CTL_DEL, client->fd, nullptr);
+    ::close(client->fd);
+    std::atomic_store(&clients, std::shared_ptr<const ClientList>(std::move(next)));
+}
+
+// Gather queued buffers into one sendmsg(); keeps partial writes for the next round.
+// Returns false if the client is gone.
+bool NMEARelay::flushTcp(Client& c, bool& more) {
+    constexpr size_t MAX_IOV = 64;
+    Buffer popped[MAX_IOV];
+
+    for (int round = 0; round < 8; ++round) {
+        // 1. Top up the in-flight list from the queue
+        if (c.pending.size() < MAX_IOV) {
+            size_t n = c.queue.popN(popped, MAX_IOV - c.pending.size());
+            for (size_t i = 0; i < n; ++i) c.pending.push_back(std::move(popped[i]));
+        }
+        if (c.pending.empty()) {
+            setWantWrite(c, false);
+            return true;
+        }
+
+        // 2. One syscall for the whole list
+        iovec iov[MAX_IOV];
+        for (size_t i = 0; i < c.pending.size(); ++i) {
+            size_t skip = (i == 0) ? c.offset : 0;
+            iov[i].iov_base = const_cast<char*>(c.pending[i]->data() + skip);
+            iov[i].iov_len = c.pending[i]->size() - skip;
+        }
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = c.pending.size();
+        ssize_t w = sendmsg(c.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                setWantWrite(c, true); // Socket buffer full: wait for EPOLLOUT
+                return true;
+            }
+            return false; // EPIPE, ECONNRESET, ...
+        }
+        bytesSent += static_cast<uint64_t>(w);
+
+        // 3. Retire fully written buffers
+        size_t left = static_cast<size_t>(w) + c.offset;
+        size_t done = 0;
+        while (done < c.pending.size() && left >= c.pending[done]->size()) {
+            left -= c.pending[done]->size();
+            done++;
+        }
+        c.pending.erase(c.pending.begin(), c.pending.begin() + static_cast<long>(done));
+        c.offset = left;
+    }
+    more = true; // Still busy: come back without sleeping
+    return true;
+}
+
+// One datagram per sentence (the usual NMEA-over-UDP convention), batched with sendmmsg()
+void NMEARelay::flushUdp(Client& c, bool& more) {
+    constexpr size_t MAX_MSGS = 64;
+    Buffer popped[MAX_MSGS];
+    iovec iov[MAX_MSGS];
+    mmsghdr msgs[MAX_MSGS];
+
+    size_t n = c.queue.popN(popped, MAX_MSGS);
+    if (n == 0) return;
+    for (size_t i = 0; i < n; ++i) {
+        iov[i].iov_base = const_cast<char*>(popped[i]->data());
+        iov[i].iov_len = popped[i]->size();
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_name = &c.addr;
+        msgs[i].msg_hdr.msg_namelen = c.addrLen;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int sent = sendmmsg(c.fd, msgs, static_cast<unsigned>(n), MSG_DONTWAIT);
+    for (int i = 0; i < sent; ++i) bytesSent += msgs[i].msg_len;
+    // Datagrams the kernel refused are simply lost, like any UDP packet
+    if (n == MAX_MSGS) more = true;
+}
+
+void NMEARelay::setWantWrite(Client& c, bool on) {
+    if (c.wantWrite == on) return;
+    c.wantWrite = on;
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | (on ? EPOLLOUT : 0u);
+    ev.data.ptr = &c;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+NMEARelay::Stats NMEARelay::stats() const {
+    Stats s;
+    s.published = published;
+    s.invalid = invalid;
+    s.filtered = filtered;
+    s.duplicates = duplicates;
+    s.bytesSent = bytesSent;
+    s.dropped = droppedByGone;
+    auto list = std::atomic_load(&clients);
+    for (const auto& c : *list) {
+        auto q = c->queue.stats();
+        s.dropped += q.dropped + q.evicted;
+    }
+    s.clients = list->size();
+    return s;
+}
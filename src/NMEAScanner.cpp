@@ -0,0 +1,240 @@
+#include "NMEAScanner.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NMEA_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using ScanFn = NMEAScan (*)(std::string_view, uint32_t*, size_t);
+
+inline bool isStart(char c) { return c == '$' || c == '!'; }
+
+inline void recordComma(NMEAScan& r, uint32_t* commas, size_t maxCommas, size_t pos) {
+    if (r.commaCount < maxCommas) commas[r.commaCount] = static_cast<uint32_t>(pos);
+    r.commaCount++;
+}
+
+// Finishes a scan byte by byte from offset 'i' (reference kernel and SIMD tails)
+void scanTail(std::string_view s, size_t i, NMEAScan& r, uint32_t* commas, size_t maxCommas) {
+    // 1. Still hunting for the start character
+    if (r.start == NMEAScan::npos) {
+        while (i < s.size() && !isStart(s[i])) ++i;
+        if (i == s.size()) return;
+        r.start = i++;
+    }
+
+    // 2. XOR and record commas until '*'
+    uint8_t x = 0;
+    for (; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == '*') {
+            r.star = i;
+            break;
+        }
+        if (c == ',') recordComma(r, commas, maxCommas, i);
+        x ^= static_cast<uint8_t>(c);
+    }
+    r.checksum ^= x;
+}
+
+NMEAScan scanScalar(std::string_view s, uint32_t* commas, size_t maxCommas) {
+    NMEAScan r;
+    scanTail(s, 0, r, commas, maxCommas);
+    return r;
+}
+
+#ifdef NMEA_SCANNER_X86
+
+// 0xFF for the first N bytes when loaded from (kPrefixMask + 32 - N)
+alignas(32) const uint8_t kPrefixMask[64] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+inline void recordCommaMask(NMEAScan& r, uint32_t* commas, size_t maxCommas, size_t base, uint32_t mask) {
+    while (mask) {
+        recordComma(r, commas, maxCommas, base + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+}
+
+__attribute__((target("sse2")))
+NMEAScan scanSSE2(std::string_view s, uint32_t* commas, size_t maxCommas) {
+    NMEAScan r;
+    const char* p = s.data();
+    const size_t n = s.size();
+    size_t i = 0;
+
+    // 1. Find the start character 16 bytes at a time
+    const __m128i dollar = _mm_set1_epi8('$');
+    const __m128i bang = _mm_set1_epi8('!');
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        uint32_t m = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, dollar), _mm_cmpeq_epi8(v, bang))));
+        if (m) {
+            r.start = i + __builtin_ctz(m);
+            break;
+        }
+    }
+    if (r.start == NMEAScan::npos) {
+        scanTail(s, i, r, commas, maxCommas);
+        return r;
+    }
+    i = r.start + 1;
+
+    // 2. One pass over the payload: '*' and ',' masks plus a running XOR
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i comma = _mm_set1_epi8(',');
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        uint32_t starMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, star)));
+        uint32_t commaMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma)));
+        if (starMask) {
+            unsigned k = __builtin_ctz(starMask);
+            __m128i keep = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kPrefixMask + 32 - k));
+            acc = _mm_xor_si128(acc, _mm_and_si128(v, keep));
+            recordCommaMask(r, commas, maxCommas, i, commaMask & ((1u << k) - 1));
+            r.star = i + k;
+            break;
+        }
+        acc = _mm_xor_si128(acc, v);
+        recordCommaMask(r, commas, maxCommas, i, commaMask);
+    }
+
+    // 3. Fold the 16 lanes down to one byte
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+    r.checksum = static_cast<uint8_t>(_mm_cvtsi128_si32(acc));
+
+    if (r.star == NMEAScan::npos) scanTail(s, i, r, commas, maxCommas);
+    return r;
+}
+
+__attribute__((target("avx2")))
+NMEAScan scanAVX2(std::string_view s, uint32_t* commas, size_t maxCommas) {
+    NMEAScan r;
+    const char* p = s.data();
+    const size_t n = s.size();
+    size_t i = 0;
+
+    // 1. Find the start character 32 bytes at a time
+    const __m256i dollar = _mm256_set1_epi8('$');
+    const __m256i bang = _mm256_set1_epi8('!');
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        uint32_t m = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, dollar), _mm256_cmpeq_epi8(v, bang))));
+        if (m) {
+            r.start = i + __builtin_ctz(m);
+            break;
+        }
+    }
+    if (r.start == NMEAScan::npos) {
+        scanTail(s, i, r, commas, maxCommas);
+        return r;
+    }
+    i = r.start + 1;
+
+    // 2. One pass over the payload: '*' and ',' masks plus a running XOR
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i comma = _mm256_set1_epi8(',');
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        uint32_t starMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, star)));
+        uint32_t commaMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, comma)));
+        if (starMask) {
+            unsigned k = __builtin_ctz(starMask);
+            __m256i keep = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kPrefixMask + 32 - k));
+            acc = _mm256_xor_si256(acc, _mm256_and_si256(v, keep));
+            recordCommaMask(r, commas, maxCommas, i, k == 0 ? 0 : commaMask & (0xFFFFFFFFu >> (32 - k)));
+            r.star = i + k;
+            break;
+        }
+        acc = _mm256_xor_si256(acc, v);
+        recordCommaMask(r, commas, maxCommas, i, commaMask);
+    }
+
+    // 3. Fold the 32 lanes down to one byte
+    __m128i x = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    x = _mm_xor_si128(x, _mm_srli_si128(x, 8));
+    x = _mm_xor_si128(x, _mm_srli_si128(x, 4));
+    x = _mm_xor_si128(x, _mm_srli_si128(x, 2));
+    x = _mm_xor_si128(x, _mm_srli_si128(x, 1));
+    r.checksum = static_cast<uint8_t>(_mm_cvtsi128_si32(x));
+
+    if (r.star == NMEAScan::npos) scanTail(s, i, r, commas, maxCommas);
+    return r;
+}
+
+#endif // NMEA_SCANNER_X86
+
+ScanFn kernelFn(NMEAScanner::Kernel kernel) {
+    switch (kernel) {
+#ifdef NMEA_SCANNER_X86
+        case NMEAScanner::Kernel::AVX2: return scanAVX2;
+        case NMEAScanner::Kernel::SSE2: return scanSSE2;
+#endif
+        default: return scanScalar;
+    }
+}
+
+NMEAScanner::Kernel detectKernel() {
+#ifdef NMEA_SCANNER_X86
+    __builtin_cpu_init(); // May run before the CPU model is initialized
+#endif
+    if (NMEAScanner::isSupported(NMEAScanner::Kernel::AVX2)) return NMEAScanner::Kernel::AVX2;
+    if (NMEAScanner::isSupported(NMEAScanner::Kernel::SSE2)) return NMEAScanner::Kernel::SSE2;
+    return NMEAScanner::Kernel::Scalar;
+}
+
+// Resolved on first use (safe from other translation units' static init), then a plain indirect call
+NMEAScanner::Kernel activeKernelValue() {
+    static const NMEAScanner::Kernel kernel = detectKernel();
+    return kernel;
+}
+
+ScanFn activeScan() {
+    static const ScanFn fn = kernelFn(activeKernelValue());
+    return fn;
+}
+
+} // namespace
+
+NMEAScan NMEAScanner::scan(std::string_view s, uint32_t* commas, size_t maxCommas) {
+    return activeScan()(s, commas, maxCommas);
+}
+
+NMEAScan NMEAScanner::scanWith(Kernel kernel, std::string_view s, uint32_t* commas, size_t maxCommas) {
+    if (!isSupported(kernel)) kernel = Kernel::Scalar;
+    return kernelFn(kernel)(s, commas, maxCommas);
+}
+
+bool NMEAScanner::isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+#ifdef NMEA_SCANNER_X86
+        case Kernel::SSE2: return __builtin_cpu_supports("sse2");
+        case Kernel::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+NMEAScanner::Kernel NMEAScanner::activeKernel() {
+    return activeKernelValue();
+}
+
+const char* NMEAScanner::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX2: return "AVX2";
+        case Kernel::SSE2: return "SSE2";
+        default:           return "Scalar";
+    }
+}
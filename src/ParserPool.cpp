@@ -0,0 +1,194 @@
+#include "ParserPool.h"
+#include <algorithm>
+
+ParserPool::ParserPool(Config cfg) : config(cfg) {
+    config.batchSize = std::max<size_t>(1, config.batchSize);
+    size_t n = std::max<size_t>(1, config.workers);
+    for (size_t i = 0; i < n; ++i) {
+        workers.push_back(std::make_unique<Worker>(config.maxSources));
+        workers.back()->batch.resize(config.batchSize);
+    }
+}
+
+ParserPool::~ParserPool() {
+    stop();
+}
+
+void ParserPool::start() {
+    if (started) return;
+    started = true;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->thread = std::thread(&ParserPool::run, this, i);
+    }
+}
+
+void ParserPool::stop() {
+    if (!started) return;
+    started = false;
+
+    // 1. Release producers stuck on full mailboxes, then wake and join every worker
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(registryMtx);
+        for (auto& [id, lane] : lanes) lane->mailbox.close();
+    }
+    for (auto& w : workers) w->cv.notify_all();
+    for (auto& w : workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+
+    // 2. Nothing is running now: drain what is left and flush half-finished epochs
+    std::lock_guard<std::mutex> lock(registryMtx);
+    for (auto& [id, lane] : lanes) {
+        process(lane.get(), *workers[lane->home], true);
+        lane->fusion.flush();
+    }
+}
+
+ParserPool::Lane* ParserPool::lane(const std::string& sourceID) {
+    std::lock_guard<std::mutex> lock(registryMtx);
+    auto it = lanes.find(sourceID);
+    if (it != lanes.end()) return it->second.get();
+    if (lanes.size() >= config.maxSources) return nullptr; // Run queues could overflow
+
+    auto& slot = lanes[sourceID];
+    slot = std::make_unique<Lane>(config.laneCapacity, config.overflow);
+    slot->id = sourceID;
+    slot->home = std::hash<std::string>{}(sourceID) % workers.size();
+    slot->fusion = FixFusion(config.fusionTimeout);
+    slot->fusion.onFix([this](const GPSData& d) {
+        fixes++;
+        if (output) output(d);
+    });
+    return slot.get();
+}
+
+bool ParserPool::submit(Lane* lane, std::string sentence) {
+    if (lane == nullptr) return false;
+    bool queued = lane->mailbox.push(std::move(sentence));
+
+    // Only the first packet schedules the lane (also after a drop: older data may be waiting)
+    if (!lane->scheduled.exchange(true)) schedule(lane);
+    return queued;
+}
+
+// Lanes always go back to their home worker's run queue
+void ParserPool::schedule(Lane* lane) {
+    Worker& w = *workers[lane->home];
+    w.runQueue.emplace(lane); // Sized for every lane: never fails, never blocks
+    wake(w);
+}
+
+// Lock-free wake-up: notify only if the worker announced it is about to sleep.
+// A notify that lands between its last look and the wait is lost, but the wait
+// is short and timed, so that only costs a few milliseconds of latency.
+void ParserPool::wake(Worker& w) {
+    if (w.sleeping.load()) w.cv.notify_one();
+}
+
+void ParserPool::run(size_t index) {
+    Worker& self = *workers[index];
+    auto lastPoll = std::chrono::steady_clock::now();
+
+    while (!stopping) {
+        // 1. Own run queue first
+        Lane* next = nullptr;
+        self.runQueue.tryPop(next);
+
+        // 2. Idle: help the busiest worker
+        if (next == nullptr && config.workStealing) next = steal(index);
+
+        // 3. Still nothing: sleep briefly (timed, so fusion timeouts keep ticking)
+        if (next == nullptr) {
+            self.sleeping.store(true);
+            if (!self.runQueue.tryPop(next)) {
+                std::unique_lock<std::mutex> lock(self.mtx);
+                self.cv.wait_for(lock, std::chrono::milliseconds(config.workStealing ? 5 : 20));
+            }
+            self.sleeping.store(false);
+        }
+
+        if (next != nullptr) process(next, self, false);
+
+        // 4. Publish epochs that timed out on this worker's sources
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastPoll >= std::chrono::milliseconds(50)) {
+            pollHomeLanes(index);
+            lastPoll = now;
+        }
+    }
+}
+
+ParserPool::Lane* ParserPool::steal(size_t thief) {
+    // Victim = longest run queue (sizes are lock-free snapshots: a hint is enough)
+    size_t victim = thief;
+    size_t longest = 1; // Only steal when a worker has more than one lane waiting
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (i == thief) continue;
+        size_t size = workers[i]->runQueue.sizeApprox();
+        if (size > longest) {
+            longest = size;
+            victim = i;
+        }
+    }
+    if (victim == thief) return nullptr;
+
+    Lane* lane = nullptr;
+    if (!workers[victim]->runQueue.tryPop(lane)) return nullptr; // Owner got there first
+    workers[thief]->steals++;
+    return lane;
+}
+
+void ParserPool::process(Lane* lane, Worker& worker, bool drainAll) {
+    std::lock_guard<std::mutex> busy(lane->busy);
+
+    // 1. Take a batch out of the mailbox, 2. decode and fuse in arrival order
+    size_t n;
+    do {
+        n = lane->mailbox.popN(worker.batch.data(), worker.batch.size());
+        for (size_t i = 0; i < n; ++i) {
+            GPSData data;
+            if (lane->parser.decode(worker.batch[i], data)) {
+                if (data.ID.empty()) data.ID = lane->id; // AIS fixes already carry their MMSI
+                lane->fusion.add(data);
+            }
+        }
+        worker.sentences += n;
+    } while (drainAll && n > 0);
+    lane->fusion.poll();
+
+    // 3. More waiting? Requeue (back of the line, so other sources get a turn)
+    if (drainAll) return;
+    lane->scheduled.store(false);
+    // A producer that pushed while 'scheduled' was still set did not schedule us: recheck
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!lane->mailbox.empty() && !lane->scheduled.exchange(true)) schedule(lane);
+}
+
+void ParserPool::pollHomeLanes(size_t index) {
+    std::lock_guard<std::mutex> lock(registryMtx);
+    for (auto& [id, lane] : lanes) {
+        if (lane->home != index) continue;
+        // Skip lanes that are being decoded right now; they poll themselves
+        std::unique_lock<std::mutex> busy(lane->busy, std::try_to_lock);
+        if (busy.owns_lock()) lane->fusion.poll();
+    }
+}
+
+ParserPool::Stats ParserPool::stats() const {
+    Stats s;
+    for (const auto& w : workers) {
+        s.sentences += w->sentences;
+        s.steals += w->steals;
+    }
+    s.fixes = fixes;
+
+    std::lock_guard<std::mutex> lock(registryMtx);
+    for (const auto& [id, lane] : lanes) {
+        auto m = lane->mailbox.stats();
+        s.dropped += m.dropped;
+        s.evicted += m.evicted;
+        s.waits += m.waits;
+    }
+    return s;
+}
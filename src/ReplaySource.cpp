@@ -0,0 +1,348 @@
+#include "ReplaySource.h"
+#include "NMEANumber.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+constexpr size_t INDEX_STRIDE = 64 * 1024;
+
+// Which comma-separated field holds hhmmss.ss (0 = none)
+size_t utcField(std::string_view sentence) {
+    if (sentence.size() < 6) return 0;
+    std::string_view formatter = sentence.substr(3, 3);
+    if (formatter == "GGA" || formatter == "RMC" || formatter == "ZDA" || formatter == "GNS") return 1;
+    if (formatter == "GLL") return 5;
+    return 0;
+}
+
+std::string_view field(std::string_view sentence, size_t index) {
+    size_t start = 0;
+    for (size_t i = 0; i < index; ++i) {
+        start = sentence.find(',', start);
+        if (start == std::string_view::npos) return {};
+        start++;
+    }
+    size_t end = sentence.find_first_of(",*", start);
+    return sentence.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+}
+}
+
+ReplaySource::ReplaySource(Config cfg) : config(std::move(cfg)) {
+    if (config.pacing == Pacing::RealTime || config.speed <= 0) config.speed = 1.0;
+}
+
+ReplaySource::~ReplaySource() {
+    close();
+}
+
+bool ReplaySource::open() {
+    // 1. Map the whole file read-only; the page cache does the I/O
+    filefd = ::open(config.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (filefd < 0) {
+        perror("Replay Open Error");
+        return false;
+    }
+    struct stat st;
+    if (fstat(filefd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "Replay: Empty or unreadable file " << config.path << std::endl;
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, filefd, 0);
+    if (map == MAP_FAILED) {
+        perror("Replay mmap");
+        close();
+        return false;
+    }
+    data = static_cast<const char*>(map);
+    madvise(map, size, MADV_SEQUENTIAL); // Aggressive read-ahead, early page drop
+
+    // 2. Pacing timer for the reactor; fires at once so the first sentences flow
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    rewind();
+    stats_ = Stats{};
+    armTimer(Clock::now());
+
+    std::cout << "Replay: " << config.path << " (" << size / (1024 * 1024) << " MiB)" << std::endl;
+    return true;
+}
+
+void ReplaySource::close() {
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+    if (filefd >= 0) ::close(filefd);
+    if (timerfd >= 0) ::close(timerfd);
+    data = nullptr;
+    filefd = timerfd = -1;
+    size = 0;
+    index.clear();
+}
+
+// Decode one line starting at 'offset' (no state touched)
+bool ReplaySource::parseLine(size_t offset, Line& line) const {
+    if (offset >= size) return false;
+    const char* begin = data + offset;
+    const char* nl = static_cast<const char*>(std::memchr(begin, '\n', size - offset));
+    line.end = nl ? static_cast<size_t>(nl - data) + 1 : size;
+
+    std::string_view raw(begin, (nl ? nl : data + size) - begin);
+    while (!raw.empty() && (raw.back() == '\r' || raw.back() == '\n')) raw.remove_suffix(1);
+    line.sentence = {};
+    line.hasTime = false;
+    line.fromPrefix = false;
+
+    // 1. Optional logger timestamp: "<epoch seconds> <sentence>"
+    if (!raw.empty() && raw[0] >= '0' && raw[0] <= '9') {
+        double t = 0;
+        auto res = std::from_chars(raw.data(), raw.data() + raw.size(), t);
+        if (res.ec == std::errc()) {
+            line.hasTime = line.fromPrefix = true;
+            line.time = t;
+            raw.remove_prefix(static_cast<size_t>(res.ptr - raw.data()));
+            while (!raw.empty() && (raw[0] == ' ' || raw[0] == '\t' || raw[0] == ',')) raw.remove_prefix(1);
+        }
+    }
+
+    // 2. Anything that isn't a sentence (comments, blank lines) is skipped
+    if (raw.empty() || (raw[0] != '$' && raw[0] != '!')) return true;
+    line.sentence = raw;
+
+    // 3. No prefix: take the UTC field
+    if (!line.hasTime) {
+        size_t f = utcField(raw);
+        int32_t ms = 0;
+        if (f != 0 && NMEANumber::parseTimeMs(field(raw, f), ms)) {
+            line.hasTime = true;
+            line.time = ms / 1000.0;
+        }
+    }
+    return true;
+}
+
+double ReplaySource::Unwrap::apply(const Line& line) {
+    if (!line.fromPrefix) {
+        if (lastRaw >= 0 && line.time < lastRaw - 43200) dayOffset += 86400; // Crossed midnight
+        lastRaw = line.time;
+    }
+    return line.time + (line.fromPrefix ? 0 : dayOffset);
+}
+
+// Decode the next sentence once; unwrap state advances exactly once per line
+bool ReplaySource::peek() {
+    if (havePeek) return true;
+    if (data == nullptr) return false;
+    Line line;
+    while (parseLine(cursor, line)) {
+        if (line.sentence.empty()) {
+            cursor = line.end;
+            continue;
+        }
+        if (line.hasTime) {
+            line.time = unwrap.apply(line);
+            if (!haveStart) {
+                startTime = lastTime = line.time;
+                haveStart = true;
+            }
+        } else {
+            line.time = lastTime; // Inherit
+        }
+        peeked = line;
+        havePeek = true;
+        dueValid = false;
+        return true;
+    }
+    return false;
+}
+
+void ReplaySource::advance() {
+    auto now = Clock::now();
+    if (config.pacing != Pacing::MaxSpeed && dueValid && now > peekedDue) {
+        stats_.maxLagMs = std::max(stats_.maxLagMs, std::chrono::duration<double, std::milli>(now - peekedDue).count());
+    }
+    lastTime = peeked.time;
+    cursor = peeked.end;
+    havePeek = false;
+    stats_.sentences++;
+    stats_.bytes += peeked.sentence.size();
+}
+
+ReplaySource::Clock::time_point ReplaySource::dueTime() {
+    if (dueValid) return peekedDue;
+    dueValid = true;
+    auto now = Clock::now();
+    if (config.pacing == Pacing::MaxSpeed) return peekedDue = now;
+
+    double t = peeked.time;
+    if (!anchored) {
+        anchorWall = now;
+        anchorLog = t;
+        anchored = true;
+    }
+    // Long silence in the recording: skip most of it
+    double gap = t - lastTime;
+    double maxGap = config.maxGap.count() / 1000.0;
+    if (maxGap > 0 && gap > maxGap) anchorLog += gap - maxGap;
+
+    auto offset = std::chrono::duration<double>((t - anchorLog) / config.speed);
+    return peekedDue = anchorWall + std::chrono::duration_cast<Clock::duration>(offset);
+}
+
+bool ReplaySource::next(std::string_view& sentence) {
+    if (!peek()) {
+        if (!config.loop || cursor == 0) return false;
+        rewind();
+        stats_.loops++;
+        if (!peek()) return false;
+    }
+    std::this_thread::sleep_until(dueTime());
+    sentence = peeked.sentence;
+    advance();
+    return true;
+}
+
+void ReplaySource::rewind() {
+    cursor = 0;
+    havePeek = false;
+    dueValid = false;
+    anchored = false;
+    unwrap = Unwrap{};
+    haveStart = false;
+    startTime = lastTime = 0;
+}
+
+// One linear pass over the mapping (memchr speed); only needed for seek()/duration()
+void ReplaySource::buildIndex() {
+    if (!index.empty() || data == nullptr) return;
+
+    Unwrap u;
+    Line line;
+    bool first = true;
+    double start = 0;
+    size_t lastIndexed = 0;
+    for (size_t off = 0; parseLine(off, line); off = line.end) {
+        if (!line.hasTime || line.sentence.empty()) continue;
+        Unwrap before = u;      // State a reader starting at 'off' must resume with
+        double t = u.apply(line);
+        if (first) {
+            start = t;
+            first = false;
+        }
+        if (index.empty() || off - lastIndexed >= INDEX_STRIDE) {
+            index.push_back({t - start, off, before});
+            lastIndexed = off;
+        }
+        endTime = t - start;
+    }
+}
+
+bool ReplaySource::seek(double seconds) {
+    buildIndex();
+    if (index.empty()) return false;
+
+    // 1. Last index entry at or before the target, then walk forward
+    auto it = std::upper_bound(index.begin(), index.end(), seconds,
+                               [](double t, const IndexEntry& e) { return t < e.time; });
+    if (it != index.begin()) --it;
+
+    rewind();
+    peek(); // Establishes startTime from the first timed sentence
+    double start = startTime;
+    cursor = it->offset;
+    unwrap = it->unwrap;
+    havePeek = false;
+
+    while (peek() && peeked.time - start < seconds) advance();
+    stats_.sentences = 0; // Skipped lines were not delivered
+    stats_.bytes = 0;
+    startTime = start;
+    lastTime = havePeek ? peeked.time : lastTime;
+    anchored = false; // Pacing restarts from here
+    dueValid = false;
+    if (timerfd >= 0) armTimer(Clock::now());
+    return havePeek;
+}
+
+double ReplaySource::duration() {
+    buildIndex();
+    return endTime;
+}
+
+size_t ReplaySource::readChunk(char* buf, size_t cap) {
+    // Wait for the first line, then add whatever else is already due
+    std::string_view first;
+    if (cap == 0 || !next(first)) return 0;
+    size_t n = std::min(first.size(), cap - 1);
+    if (n < first.size()) stats_.truncated++;
+    std::memcpy(buf, first.data(), n);
+    buf[n++] = '\n';
+
+    auto now = Clock::now();
+    while (peek() && dueTime() <= now && n + peeked.sentence.size() + 1 <= cap) {
+        std::memcpy(buf + n, peeked.sentence.data(), peeked.sentence.size());
+        n += peeked.sentence.size();
+        buf[n++] = '\n';
+        advance();
+    }
+    return n;
+}
+
+std::string ReplaySource::readLine() {
+    std::string_view sentence;
+    return next(sentence) ? std::string(sentence) : std::string();
+}
+
+IPollableSource::ReadResult ReplaySource::tryRead(char* buf, size_t cap, size_t& n) {
+    uint64_t expirations;
+    while (::read(timerfd, &expirations, sizeof(expirations)) > 0) {} // Clear readiness
+
+    // 1. Copy every line that is due and fits
+    n = 0;
+    auto now = Clock::now();
+    for (;;) {
+        if (!peek()) {
+            if (!config.loop || cursor == 0) break;
+            rewind();
+            stats_.loops++;
+            if (!peek()) break;
+        }
+        if (dueTime() > now) break;
+        size_t len = peeked.sentence.size();
+        if (n + len + 1 > cap) {
+            if (n > 0 || cap == 0) break; // Next read
+            // Longer than the whole buffer: it would never fit, so cut it as readChunk() does
+            len = cap - 1;
+            stats_.truncated++;
+        }
+        std::memcpy(buf + n, peeked.sentence.data(), len);
+        n += len;
+        buf[n++] = '\n';
+        advance();
+    }
+
+    // 2. Wake the reactor when the next line is due (or right away to report the end)
+    bool more = peek();
+    if (n == 0 && !more) return ReadResult::Closed;
+    armTimer(more ? dueTime() : now);
+    return n > 0 ? ReadResult::Data : ReadResult::WouldBlock;
+}
+
+bool ReplaySource::hasBuffered() const {
+    return havePeek && dueValid && peekedDue <= Clock::now();
+}
+
+void ReplaySource::armTimer(Clock::time_point when) {
+    // steady_clock is CLOCK_MONOTONIC, so its epoch matches the timer's
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+    if (ns <= 0) ns = 1; // 0 would disarm
+    itimerspec spec{};
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+    timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
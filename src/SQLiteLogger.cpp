@@ -1,49 +1,355 @@
 #include "SQLiteLogger.h"
+#include <algorithm>
+#include <iostream>
+#include "TrackSchema.h"
+#include "TrackSimplify.h"
 
-void SQLiteLogger::initTable() {
-    // Basic Schema: ID, Timestamp, Lat, Lon, Speed
-    const char* sql = "CREATE TABLE IF NOT EXISTS tracklog (" \
-                      "id INTEGER PRIMARY KEY AUTOINCREMENT," \
-                      "timestamp TEXT," \
-                      "lat REAL," \
-                      "lon REAL," \
-                      "speed REAL);";
+namespace {
+int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}
+
+SQLiteLogger::SQLiteLogger(const std::string& dbPath) : SQLiteLogger([&dbPath] {
+    Config cfg;
+    cfg.path = dbPath;
+    return cfg;
+}()) {}
+
+SQLiteLogger::SQLiteLogger(Config cfg)
+    : config(std::move(cfg)),
+      writer(config.queueCapacity, std::min<size_t>(std::max<size_t>(config.batchRows, 1), 256)) {
+    if (config.partitioning == Partitioning::None) {
+        // Single file: open now, so a bad path is reported at startup
+        auto p = openPartition(TrackPartitions::fileFor(config.path, Partitioning::None, 0));
+        if (!p) return;
+        partitions.push_back(std::move(p));
+    }
+    writer.start([this](GPSData* batch, size_t n) { writeBatch(batch, n); },
+                 [this] {
+                     commitAll(); // Shutdown: everything queued is on disk
+                     closePartitions();
+                 });
+
+    if (config.partitioning != Partitioning::None && config.maintenanceInterval.count() > 0 &&
+        (config.retention.count() > 0 || config.compactAfter.count() > 0)) {
+        maintainer = std::thread(&SQLiteLogger::maintenanceLoop, this);
+    }
+}
+
+SQLiteLogger::~SQLiteLogger() {
+    stop();
+}
 
+SQLiteLogger::Partition::~Partition() {
+    for (sqlite3_stmt* stmt : {insert, internInsert, internSelect}) sqlite3_finalize(stmt);
+    if (db) {
+        sqlite3_close(db);
+        std::cout << "DB: Closed " << file.path << std::endl;
+    }
+}
+
+std::unique_ptr<SQLiteLogger::Partition> SQLiteLogger::openPartition(const TrackPartitions::File& file) {
+    auto p = std::make_unique<Partition>();
+    p->file = file;
+
+    // 1. Open Database
+    if (sqlite3_open(file.path.c_str(), &p->db) != SQLITE_OK) {
+        std::cerr << "DB Error: " << sqlite3_errmsg(p->db) << std::endl;
+        errors++;
+        return nullptr;
+    }
+    std::cout << "DB: Opened " << file.path << std::endl;
+    sqlite3_busy_timeout(p->db, 5000); // Compaction may hold the lock for a moment
+
+    // 2. Durability: WAL lets a commit be one sequential append instead of a journal rewrite
+    static const char* const SYNC[] = {"PRAGMA synchronous=OFF;", "PRAGMA synchronous=NORMAL;",
+                                       "PRAGMA synchronous=FULL;"};
+    exec(p->db, "PRAGMA journal_mode=WAL;");
+    exec(p->db, SYNC[static_cast<int>(config.durability)]);
+    if (!TrackSchema::migrate(p->db)) {
+        errors++;
+        return nullptr;
+    }
+
+    // 3. Prepare statements once; the writer only binds and steps them
+    const char* sql[] = {
+        "INSERT INTO fixes (source, time_ms, lat, lon, altitude, fix_quality, satellites,"
+        " speed, course, type, talker, valid) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+        "INSERT OR IGNORE INTO sources (name) VALUES (?);",
+        "SELECT id FROM sources WHERE name = ?;"};
+    sqlite3_stmt** stmts[] = {&p->insert, &p->internInsert, &p->internSelect};
+    for (int i = 0; i < 3; ++i) {
+        if (sqlite3_prepare_v2(p->db, sql[i], -1, stmts[i], nullptr) != SQLITE_OK) {
+            std::cerr << "DB Prepare Error: " << sqlite3_errmsg(p->db) << std::endl;
+            errors++;
+            return nullptr;
+        }
+    }
+    return p;
+}
+
+SQLiteLogger::Partition* SQLiteLogger::partitionFor(int64_t timeMs) {
+    // 1. Already open (almost always the last one used)
+    for (auto it = partitions.rbegin(); it != partitions.rend(); ++it) {
+        if (timeMs >= (*it)->file.startMs && timeMs < (*it)->file.endMs) {
+            if (it != partitions.rbegin()) std::iter_swap(it, partitions.rbegin());
+            return partitions.back().get();
+        }
+    }
+
+    // 2. New period: retire the least recently used file, open the new one. Under openMtx,
+    // so maintain() never deletes or compacts a file between our check and our open.
+    std::lock_guard<std::mutex> lock(openMtx);
+    if (partitions.size() >= MAX_OPEN) {
+        commitPartition(*partitions.front());
+        openPaths.erase(partitions.front()->file.path);
+        partitions.erase(partitions.begin());
+    }
+    auto p = openPartition(TrackPartitions::fileFor(config.path, config.partitioning, timeMs));
+    if (!p) return nullptr;
+    openPaths.insert(p->file.path);
+    partitions.push_back(std::move(p));
+    return partitions.back().get();
+}
+
+void SQLiteLogger::closePartitions() {
+    std::lock_guard<std::mutex> lock(openMtx);
+    partitions.clear();
+    openPaths.clear();
+}
+
+bool SQLiteLogger::exec(sqlite3* db, const char* sql) {
     char* errMsg = 0;
     // sqlite3_exec is fine for simple statements with no variables
-    int rc = sqlite3_exec(db, sql, 0, 0, &errMsg);
-    
-    if (rc != SQLITE_OK) {
+    if (sqlite3_exec(db, sql, 0, 0, &errMsg) != SQLITE_OK) {
         std::cerr << "SQL Error: " << errMsg << std::endl;
         sqlite3_free(errMsg);
+        errors++;
+        return false;
     }
+    return true;
 }
 
 void SQLiteLogger::log(const GPSData& data) {
-    // The Query using '?' placeholders
-    const char* sql = "INSERT INTO tracklog (timestamp, lat, lon, speed) VALUES (?, ?, ?, ?);";
-    
-    sqlite3_stmt* stmt;
+    writer.push(GPSData(data)); // Full: counted as dropped, parsing keeps going
+}
+
+void SQLiteLogger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(maintMtx);
+        maintStop = true;
+    }
+    maintCv.notify_one();
+    if (maintainer.joinable()) maintainer.join();
+
+    writer.stop();
+    closePartitions(); // Closes the databases (if the writer never ran)
+}
+
+void SQLiteLogger::writeBatch(GPSData* batch, size_t n) {
+    // 1. Group commit: one transaction (per partition) spans many batches
+    if (n > 0 && groupRows == 0) groupOpened = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) insertRow(batch[i]);
+
+    // 2. Close the group when it is big or old enough
+    if (groupRows >= config.batchRows ||
+        (groupRows > 0 && std::chrono::steady_clock::now() - groupOpened >= config.batchInterval)) {
+        commitAll();
+    }
+}
+
+void SQLiteLogger::commitPartition(Partition& p) {
+    if (p.pending == 0) return;
+    if (exec(p.db, "COMMIT;")) {
+        rows += p.pending;
+        commits++;
+    }
+    groupRows -= std::min(groupRows, p.pending);
+    p.pending = 0;
+}
+
+void SQLiteLogger::commitAll() {
+    for (auto& p : partitions) commitPartition(*p);
+    groupRows = 0;
+}
+
+int64_t SQLiteLogger::sourceKey(Partition& p, const std::string& name) {
+    // 1. Cached: the common case, no SQL at all
+    auto it = p.sourceIds.find(name);
+    if (it != p.sourceIds.end()) return it->second;
+
+    // 2. First sighting (in this file and process): insert if new, then look up its key
+    sqlite3_bind_text(p.internInsert, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_STATIC);
+    sqlite3_step(p.internInsert);
+    sqlite3_reset(p.internInsert);
+
+    int64_t key = -1;
+    sqlite3_bind_text(p.internSelect, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_STATIC);
+    if (sqlite3_step(p.internSelect) == SQLITE_ROW) key = sqlite3_column_int64(p.internSelect, 0);
+    sqlite3_reset(p.internSelect);
+    if (key >= 0) p.sourceIds.emplace(name, key);
+    return key;
+}
 
-    // 1. Prepare (Compile) the SQL
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, 0) != SQLITE_OK) {
-        std::cerr << "DB Prepare Error: " << sqlite3_errmsg(db) << std::endl;
+void SQLiteLogger::insertRow(const GPSData& data) {
+    int64_t timeMs = TrackSchema::epochMs(data, wallClockMs());
+    Partition* p = partitionFor(timeMs);
+    if (!p) {
+        errors++;
         return;
     }
+    int64_t source = sourceKey(*p, data.ID);
+    if (source < 0) {
+        errors++;
+        return;
+    }
+    if (p->pending == 0 && !exec(p->db, "BEGIN;")) return;
 
-    // 2. Bind Values to the '?' placeholders
-    // (Note: We just store timestamp as string for now to keep it simple)
-    // Index starts at 1, not 0 in SQLite!
-    sqlite3_bind_text(stmt, 1, "123519", -1, SQLITE_STATIC); // TODO: Pass real time string
-    sqlite3_bind_double(stmt, 2, data.latitude);
-    sqlite3_bind_double(stmt, 3, data.longitude);
-    sqlite3_bind_double(stmt, 4, data.speed); // Only valid if GPRMC, else 0
+    // 1. Bind Values to the '?' placeholders (index starts at 1, not 0 in SQLite!)
+    sqlite3_stmt* insert = p->insert;
+    sqlite3_bind_int64(insert, 1, source);
+    sqlite3_bind_int64(insert, 2, timeMs);
+    sqlite3_bind_double(insert, 3, data.latitude);
+    sqlite3_bind_double(insert, 4, data.longitude);
+    sqlite3_bind_double(insert, 5, data.altitude);
+    sqlite3_bind_int(insert, 6, data.fixQuality);
+    sqlite3_bind_int(insert, 7, data.satellites);
+    sqlite3_bind_double(insert, 8, data.speed);   // Only valid if RMC was fused in, else 0
+    sqlite3_bind_double(insert, 9, data.course);
+    sqlite3_bind_text(insert, 10, data.type.c_str(), static_cast<int>(data.type.size()), SQLITE_STATIC);
+    sqlite3_bind_text(insert, 11, data.talker.c_str(), static_cast<int>(data.talker.size()), SQLITE_STATIC);
+    sqlite3_bind_int(insert, 12, data.isValid ? 1 : 0);
 
-    // 3. Execute
-    if (sqlite3_step(stmt) != SQLITE_DONE) {
-        std::cerr << "DB Step Error: " << sqlite3_errmsg(db) << std::endl;
+    // 2. Execute
+    if (sqlite3_step(insert) != SQLITE_DONE) {
+        std::cerr << "DB Step Error: " << sqlite3_errmsg(p->db) << std::endl;
+        errors++;
     }
 
-    // 4. Cleanup (Critical!)
+    // 3. Reset for the next row (the statement stays compiled)
+    sqlite3_reset(insert);
+    p->pending++;
+    groupRows++;
+}
+
+void SQLiteLogger::maintenanceLoop() {
+    std::unique_lock<std::mutex> lock(maintMtx);
+    while (!maintStop) {
+        lock.unlock();
+        maintain(wallClockMs());
+        lock.lock();
+        maintCv.wait_for(lock, config.maintenanceInterval, [this] { return maintStop; });
+    }
+}
+
+void SQLiteLogger::maintain(int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(passMtx);
+    if (config.partitioning == Partitioning::None) return;
+
+    const int64_t retentionMs = std::chrono::duration_cast<std::chrono::milliseconds>(config.retention).count();
+    const int64_t compactMs = std::chrono::duration_cast<std::chrono::milliseconds>(config.compactAfter).count();
+
+    for (const auto& f : TrackPartitions::list(config.path, config.partitioning)) {
+        // A late or replayed fix may have reopened an old period: the writer's files stay
+        std::lock_guard<std::mutex> open(openMtx);
+        if (openPaths.count(f.path)) continue;
+
+        // 1. Retention: whole files go, no DELETE/VACUUM churn
+        if (retentionMs > 0 && f.endMs <= nowMs - retentionMs) {
+            TrackPartitions::remove(f.path);
+            partitionsDeleted++;
+            std::cout << "DB: Retired " << f.path << std::endl;
+            continue;
+        }
+        // 2. Compaction: once per partition, after its period is well over
+        if (compactMs > 0 && f.endMs <= nowMs - compactMs && compact(f.path)) partitionsCompacted++;
+    }
+}
+
+bool SQLiteLogger::compact(const std::string& path) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        return false;
+    }
+    sqlite3_busy_timeout(db, 5000);
+
+    auto queryText = [db](const char* sql) {
+        std::string out;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW &&
+            sqlite3_column_text(stmt, 0)) {
+            out = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+        return out;
+    };
+
+    // 1. Older files may predate the meta table; already compacted ones are skipped
+    bool done = !TrackSchema::migrate(db) || !queryText("SELECT value FROM meta WHERE key = 'compacted_m';").empty();
+    if (done || !exec(db, "BEGIN;")) {
+        sqlite3_close(db);
+        return false;
+    }
+
+    // 2. Douglas-Peucker per source, over its whole track in this partition
+    std::vector<int64_t> sources;
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(db, "SELECT id FROM sources;", -1, &stmt, nullptr);
+    while (sqlite3_step(stmt) == SQLITE_ROW) sources.push_back(sqlite3_column_int64(stmt, 0));
     sqlite3_finalize(stmt);
-}
\ No newline at end of file
+
+    sqlite3_stmt* select;
+    sqlite3_stmt* remove;
+    sqlite3_prepare_v2(db, "SELECT id, lat, lon FROM fixes WHERE source = ? ORDER BY time_ms;", -1, &select, nullptr);
+    sqlite3_prepare_v2(db, "DELETE FROM fixes WHERE id = ?;", -1, &remove, nullptr);
+    uint64_t removed = 0;
+    for (int64_t source : sources) {
+        std::vector<int64_t> ids;
+        std::vector<TrackPoint> points;
+        sqlite3_bind_int64(select, 1, source);
+        while (sqlite3_step(select) == SQLITE_ROW) {
+            ids.push_back(sqlite3_column_int64(select, 0));
+            points.push_back({sqlite3_column_double(select, 1), sqlite3_column_double(select, 2)});
+        }
+        sqlite3_reset(select);
+
+        std::vector<bool> keep = simplifyTrack(points, config.compactToleranceM);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (keep[i]) continue;
+            sqlite3_bind_int64(remove, 1, ids[i]); // Trigger drops its R*Tree entry too
+            if (sqlite3_step(remove) == SQLITE_DONE) removed++;
+            sqlite3_reset(remove);
+        }
+    }
+    sqlite3_finalize(select);
+    sqlite3_finalize(remove);
+
+    // 3. Mark, commit, give the space back
+    std::string mark = "INSERT OR REPLACE INTO meta VALUES ('compacted_m', '" +
+                       std::to_string(config.compactToleranceM) + "');";
+    bool ok = exec(db, mark.c_str()) && exec(db, "COMMIT;");
+    if (!ok) exec(db, "ROLLBACK;");
+    if (ok) {
+        exec(db, "VACUUM;");
+        exec(db, "PRAGMA wal_checkpoint(TRUNCATE);");
+        rowsCompacted += removed;
+        std::cout << "DB: Compacted " << path << " (-" << removed << " fixes)" << std::endl;
+    }
+    sqlite3_close(db);
+    return ok;
+}
+
+SQLiteLogger::Stats SQLiteLogger::stats() const {
+    Stats s;
+    s.rows = rows;
+    s.commits = commits;
+    s.dropped = writer.queueStats().dropped;
+    s.errors = errors;
+    s.partitionsDeleted = partitionsDeleted;
+    s.partitionsCompacted = partitionsCompacted;
+    s.rowsCompacted = rowsCompacted;
+    return s;
+}
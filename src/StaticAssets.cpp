@@ -0,0 +1,302 @@
+#include "StaticAssets.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#ifdef NMEA_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef NMEA_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace {
+bool readWhole(const std::string& path, std::string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st {};
+    bool ok = ::fstat(fd, &st) == 0;
+    if (ok) {
+        out.resize(static_cast<size_t>(st.st_size));
+        size_t got = 0;
+        while (got < out.size()) {
+            ssize_t n = ::read(fd, &out[got], out.size() - got);
+            if (n <= 0) break;
+            got += static_cast<size_t>(n);
+        }
+        out.resize(got);
+    }
+    ::close(fd);
+    return ok;
+}
+
+bool isDirectory(const std::string& path) {
+    struct stat st {};
+    return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+std::string lowerExtension(std::string_view filename) {
+    size_t dot = filename.rfind('.');
+    if (dot == std::string_view::npos) return "";
+    std::string ext(filename.substr(dot + 1));
+    for (char& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext;
+}
+
+// Binary formats (images, fonts) are already compressed: not worth a variant
+bool compressible(const std::string& mime) {
+    return mime.compare(0, 5, "text/") == 0 || mime.find("javascript") != std::string::npos ||
+           mime.find("json") != std::string::npos || mime.find("xml") != std::string::npos ||
+           mime == "application/wasm" || mime == "application/manifest+json";
+}
+
+std::string strongETag(const std::string& content) {
+    uint64_t h = 1469598103934665603ull; // FNV-1a 64
+    for (unsigned char c : content) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "\"%016llx-%zx\"", static_cast<unsigned long long>(h), content.size());
+    return buf;
+}
+
+// "\"tag\"" -> "\"tag-gz\"": a compressed variant is different bytes, so it needs its own tag
+std::string variantETag(const std::string& etag, const char* suffix) {
+    return etag.substr(0, etag.size() - 1) + suffix + "\"";
+}
+
+std::string gzipCompress(const std::string& in) {
+#ifdef NMEA_HAVE_ZLIB
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) return "";
+    std::string out(deflateBound(&zs, static_cast<uLong>(in.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END ? out : "";
+#else
+    (void)in;
+    return "";
+#endif
+}
+
+std::string brotliCompress(const std::string& in) {
+#ifdef NMEA_HAVE_BROTLI
+    size_t size = BrotliEncoderMaxCompressedSize(in.size());
+    if (size == 0) return "";
+    std::string out(size, '\0');
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, in.size(),
+                               reinterpret_cast<const uint8_t*>(in.data()), &size,
+                               reinterpret_cast<uint8_t*>(&out[0]))) {
+        return "";
+    }
+    out.resize(size);
+    return out;
+#else
+    (void)in;
+    return "";
+#endif
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// Calls fn(item) for each comma-separated, trimmed item
+template <typename Fn>
+void forEachItem(std::string_view list, Fn&& fn) {
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        fn(trim(list.substr(0, comma)));
+        if (comma == std::string_view::npos) break;
+        list.remove_prefix(comma + 1);
+    }
+}
+
+bool equalsNoCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+// Weight the client gives 'coding' in Accept-Encoding: -1 if not mentioned (falls back to "*")
+double codingWeight(std::string_view header, std::string_view coding) {
+    double weight = -1.0, star = -1.0;
+    forEachItem(header, [&](std::string_view item) {
+        size_t semi = item.find(';');
+        std::string_view name = trim(item.substr(0, semi));
+        double q = 1.0;
+        if (semi != std::string_view::npos) {
+            std::string_view param = trim(item.substr(semi + 1));
+            if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                q = std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+            }
+        }
+        if (equalsNoCase(name, coding)) weight = q;
+        else if (name == "*") star = q;
+    });
+    return weight >= 0.0 ? weight : star;
+}
+}
+
+size_t StaticAssets::load(const std::string& root) {
+    assets.clear();
+    totalBytes = 0;
+    if (!root.empty()) scan(root, "");
+    return assets.size();
+}
+
+void StaticAssets::scan(const std::string& dir, const std::string& urlPrefix) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    while (dirent* e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name.empty() || name[0] == '.') continue; // ".", "..", dotfiles
+
+        std::string path = dir + "/" + name;
+        if (isDirectory(path)) {
+            scan(path, urlPrefix + "/" + name);
+            continue;
+        }
+        std::string content;
+        if (readWhole(path, content)) add(urlPrefix + "/" + name, std::move(content));
+    }
+    closedir(d);
+}
+
+void StaticAssets::add(const std::string& urlPath, std::string content) {
+    std::string_view filename = urlPath;
+    filename.remove_prefix(urlPath.rfind('/') + 1);
+
+    Asset a;
+    a.mime = mimeType(filename);
+    a.etag = strongETag(content);
+    // Vite only content-hashes what it emits under assets/; index.html must always revalidate
+    bool hashed = urlPath.compare(0, 8, "/assets/") == 0 && isHashedName(filename);
+    a.cacheControl = hashed ? "public, max-age=31536000, immutable" : "no-cache";
+
+    // Keep a variant only if it is actually smaller
+    if (compressible(a.mime)) {
+        a.gzip = gzipCompress(content);
+        if (a.gzip.size() >= content.size()) a.gzip.clear();
+        a.brotli = brotliCompress(content);
+        if (a.brotli.size() >= content.size()) a.brotli.clear();
+        if (!a.gzip.empty()) a.gzipETag = variantETag(a.etag, "-gz");
+        if (!a.brotli.empty()) a.brotliETag = variantETag(a.etag, "-br");
+    }
+    a.identity = std::move(content);
+
+    totalBytes += a.identity.size() + a.gzip.size() + a.brotli.size();
+    assets[urlPath] = std::move(a);
+}
+
+const StaticAssets::Asset* StaticAssets::find(std::string_view path) const {
+    if (path.empty() || path == "/") path = "/index.html";
+    auto it = assets.find(std::string(path));
+    return it == assets.end() ? nullptr : &it->second;
+}
+
+StaticAssets::Reply StaticAssets::serve(std::string_view path, std::string_view acceptEncoding,
+                                        std::string_view ifNoneMatch) const {
+    Reply r;
+    r.asset = find(path);
+    if (!r.asset) return r;
+
+    // 1. Smallest variant the client accepts: brotli, then gzip, then identity
+    const Asset& a = *r.asset;
+    r.body = &a.identity;
+    r.etag = &a.etag;
+    if (!a.brotli.empty() && codingWeight(acceptEncoding, "br") > 0.0) {
+        r.body = &a.brotli;
+        r.etag = &a.brotliETag;
+        r.encoding = "br";
+    } else if (!a.gzip.empty() && codingWeight(acceptEncoding, "gzip") > 0.0) {
+        r.body = &a.gzip;
+        r.etag = &a.gzipETag;
+        r.encoding = "gzip";
+    }
+
+    // 2. Revalidation: the browser holds some variant of the current content (weak
+    // comparison, as If-None-Match allows), whichever encoding it was fetched with
+    bool match = false;
+    forEachItem(ifNoneMatch, [&](std::string_view tag) {
+        if (tag.compare(0, 2, "W/") == 0) tag.remove_prefix(2);
+        if (tag.empty()) return;
+        if (tag == "*" || tag == a.etag || tag == a.gzipETag || tag == a.brotliETag) match = true;
+    });
+    r.status = match ? 304 : 200;
+    if (match) r.body = nullptr;
+    return r;
+}
+
+std::string StaticAssets::mimeType(std::string_view filename) {
+    static const std::pair<const char*, const char*> TYPES[] = {
+        {"html", "text/html; charset=utf-8"},
+        {"htm", "text/html; charset=utf-8"},
+        {"js", "application/javascript; charset=utf-8"},
+        {"mjs", "application/javascript; charset=utf-8"},
+        {"css", "text/css; charset=utf-8"},
+        {"json", "application/json"},
+        {"map", "application/json"},
+        {"webmanifest", "application/manifest+json"},
+        {"txt", "text/plain; charset=utf-8"},
+        {"svg", "image/svg+xml"},
+        {"png", "image/png"},
+        {"jpg", "image/jpeg"},
+        {"jpeg", "image/jpeg"},
+        {"gif", "image/gif"},
+        {"webp", "image/webp"},
+        {"ico", "image/x-icon"},
+        {"woff", "font/woff"},
+        {"woff2", "font/woff2"},
+        {"ttf", "font/ttf"},
+        {"wasm", "application/wasm"},
+    };
+    std::string ext = lowerExtension(filename);
+    for (const auto& t : TYPES) {
+        if (ext == t.first) return t.second;
+    }
+    return "application/octet-stream";
+}
+
+bool StaticAssets::isHashedName(std::string_view filename) {
+    // <name>-<hash>.<ext>, the hash being 8+ characters of Vite's base64url alphabet. A hash
+    // that itself contains '-' reads as too short: the file just revalidates (safe side).
+    size_t dot = filename.find('.');
+    size_t dash = filename.rfind('-', dot);
+    if (dot == std::string_view::npos || dash == std::string_view::npos || dot - dash - 1 < 8) return false;
+    for (size_t i = dash + 1; i < dot; ++i) {
+        char c = filename[i];
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') return false;
+    }
+    return true;
+}
+
+std::string StaticAssets::locate(const std::string& configured) {
+    if (!configured.empty()) return configured;
+
+    // 1. Next to the installed binary: <prefix>/bin/nmea_app -> <prefix>/frontend/dist
+    char exe[4096];
+    ssize_t n = ::readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (n > 0) {
+        std::string dir(exe, static_cast<size_t>(n));
+        dir.resize(dir.rfind('/'));
+        std::string candidate = dir + "/../frontend/dist";
+        if (isDirectory(candidate)) return candidate;
+    }
+
+    // 2. The old working-directory convention (build/ inside the source tree, /data in Docker)
+    return "../frontend/dist";
+}
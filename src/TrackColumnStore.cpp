@@ -0,0 +1,376 @@
+#include "TrackColumnStore.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace ColumnFormat;
+
+namespace {
+enum Column { TIME, LAT, LON, ALT, SPEED, COURSE, SATS, QUALITY };
+
+void putVarint(std::string& out, int64_t value) {
+    uint64_t v = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); // Zig-zag
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+bool getVarint(const char*& p, const char* end, int64_t& value) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+            return true;
+        }
+    }
+    return false; // Truncated or overlong
+}
+
+bool writeAll(int fd, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readExact(int fd, void* buf, size_t len, off_t at) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, at);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        at += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+}
+
+TrackColumnStore::TrackColumnStore(Config cfg)
+    : config(std::move(cfg)), writer(config.queueCapacity, 256) {
+    if (!openFiles()) return;
+    lastFlush = std::chrono::steady_clock::now();
+    writer.start([this](GPSData* batch, size_t n) { writeBatch(batch, n); },
+                 [this] {
+                     flushAll();
+                     fdatasync(datafd);
+                     fdatasync(indexfd);
+                 });
+}
+
+TrackColumnStore::~TrackColumnStore() {
+    stop();
+    for (int fd : {datafd, indexfd, vesselfd}) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+bool TrackColumnStore::openFiles() {
+    if (mkdir(config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror("Tracks: mkdir");
+        return false;
+    }
+    const std::string base = config.directory + "/tracks";
+    datafd = ::open((base + ".dat").c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    indexfd = ::open((base + ".idx").c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    vesselfd = ::open((base + ".vessels").c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (datafd < 0 || indexfd < 0 || vesselfd < 0) {
+        perror("Tracks: open");
+        return false;
+    }
+
+    // 1. Vessel keys: "<key> <name>" lines, key = line number. A torn last line (crash
+    // mid-write) is cut off, or the next name appended would be glued onto it.
+    struct stat st;
+    if (fstat(vesselfd, &st) == 0 && st.st_size > 0) {
+        std::string text(static_cast<size_t>(st.st_size), '\0');
+        if (readExact(vesselfd, &text[0], text.size(), 0)) {
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t nl = text.find('\n', pos);
+                if (nl == std::string::npos) break; // Torn last line
+                size_t sp = text.find(' ', pos);
+                if (sp != std::string::npos && sp < nl) {
+                    std::string name = text.substr(sp + 1, nl - sp - 1);
+                    vesselKeys.emplace(name, static_cast<uint32_t>(vesselNames.size()));
+                    vesselNames.push_back(name);
+                }
+                pos = nl + 1;
+            }
+            if (pos < text.size() && ftruncate(vesselfd, static_cast<off_t>(pos)) != 0) {
+                perror("Tracks: truncate vessels");
+                return false;
+            }
+        }
+    }
+
+    // 2. Block index. A torn trailing entry is cut off too: appends must stay aligned.
+    if (fstat(indexfd, &st) == 0) {
+        index.resize(static_cast<size_t>(st.st_size) / sizeof(ColumnIndexEntry));
+        off_t whole = static_cast<off_t>(index.size() * sizeof(ColumnIndexEntry));
+        if (st.st_size > whole && ftruncate(indexfd, whole) != 0) {
+            perror("Tracks: truncate index");
+            return false;
+        }
+        if (!readExact(indexfd, index.data(), index.size() * sizeof(ColumnIndexEntry), 0)) index.clear();
+    }
+    std::cout << "Tracks: Opened " << config.directory << " (" << index.size() << " blocks)" << std::endl;
+    return true;
+}
+
+void TrackColumnStore::stop() {
+    writer.stop(); // Files stay open for queries until destruction
+}
+
+void TrackColumnStore::log(const GPSData& data) {
+    writer.push(GPSData(data)); // Full: counted as dropped, parsing keeps going
+}
+
+void TrackColumnStore::writeBatch(GPSData* batch, size_t n) {
+    for (size_t i = 0; i < n; ++i) append(batch[i]);
+
+    // Partial blocks reach disk (and queries) at least every flushInterval
+    if (std::chrono::steady_clock::now() - lastFlush >= config.flushInterval) {
+        flushAll();
+        lastFlush = std::chrono::steady_clock::now();
+    }
+}
+
+uint32_t TrackColumnStore::vesselKey(const std::string& name) {
+    std::lock_guard<std::mutex> lock(indexMtx);
+    auto it = vesselKeys.find(name);
+    if (it != vesselKeys.end()) return it->second;
+
+    uint32_t key = static_cast<uint32_t>(vesselNames.size());
+    std::string line = std::to_string(key) + " " + name + "\n";
+    if (!writeAll(vesselfd, line.data(), line.size())) writeErrors++;
+    vesselKeys.emplace(name, key);
+    vesselNames.push_back(name);
+    return key;
+}
+
+void TrackColumnStore::append(const GPSData& data) {
+    auto it = open.find(data.ID);
+    if (it == open.end()) {
+        it = open.emplace(data.ID, OpenBlock{}).first;
+        it->second.vessel = vesselKey(data.ID);
+    }
+    OpenBlock& b = it->second;
+
+    // 1. Fixed-point values, one per column
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t v[COLUMNS];
+    v[TIME] = TrackSchema::epochMs(data, nowMs);
+    v[LAT] = data.latE7();
+    v[LON] = data.lonE7();
+    v[ALT] = std::llround(data.altitude * 10.0);
+    v[SPEED] = std::llround(data.speed * 100.0);
+    v[COURSE] = std::llround(data.course * 100.0);
+    v[SATS] = data.satellites;
+    v[QUALITY] = data.isValid ? data.fixQuality : -1;
+
+    // 2. Delta to the previous fix of this block (the first one is stored whole)
+    for (size_t c = 0; c < COLUMNS; ++c) {
+        putVarint(b.columns[c], v[c] - b.last[c]);
+        b.last[c] = v[c];
+    }
+
+    // 3. Block bounds for the index
+    ColumnIndexEntry& e = b.bounds;
+    if (b.count == 0) {
+        e.minMs = e.maxMs = v[TIME];
+        e.minLatE7 = e.maxLatE7 = static_cast<int32_t>(v[LAT]);
+        e.minLonE7 = e.maxLonE7 = static_cast<int32_t>(v[LON]);
+    }
+    e.minMs = std::min(e.minMs, v[TIME]);
+    e.maxMs = std::max(e.maxMs, v[TIME]);
+    e.minLatE7 = std::min<int32_t>(e.minLatE7, static_cast<int32_t>(v[LAT]));
+    e.maxLatE7 = std::max<int32_t>(e.maxLatE7, static_cast<int32_t>(v[LAT]));
+    e.minLonE7 = std::min<int32_t>(e.minLonE7, static_cast<int32_t>(v[LON]));
+    e.maxLonE7 = std::max<int32_t>(e.maxLonE7, static_cast<int32_t>(v[LON]));
+
+    if (++b.count >= config.blockFixes) flushBlock(b);
+}
+
+void TrackColumnStore::flushBlock(OpenBlock& b) {
+    if (b.count == 0) return;
+
+    // 1. Header + columns in one write
+    ColumnBlockHeader h{};
+    h.magic = BLOCK_MAGIC;
+    h.vessel = b.vessel;
+    h.count = b.count;
+    std::string out(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (size_t c = 0; c < COLUMNS; ++c) {
+        reinterpret_cast<ColumnBlockHeader*>(&out[0])->columnBytes[c] = static_cast<uint32_t>(b.columns[c].size());
+    }
+    for (size_t c = 0; c < COLUMNS; ++c) out += b.columns[c];
+
+    // 2. Data first, then the index entry that makes it visible
+    ColumnIndexEntry e = b.bounds;
+    e.vessel = b.vessel;
+    e.count = b.count;
+    e.bytes = static_cast<uint32_t>(out.size());
+    off_t at = lseek(datafd, 0, SEEK_END);
+    e.offset = static_cast<uint64_t>(at);
+    if (at < 0 || !writeAll(datafd, out.data(), out.size()) || !writeAll(indexfd, &e, sizeof(e))) {
+        writeErrors++;
+    } else {
+        std::lock_guard<std::mutex> lock(indexMtx);
+        index.push_back(e);
+    }
+    fixes += b.count;
+    blocks++;
+    bytes += out.size();
+
+    // 3. Start over (capacity is kept for the next block)
+    b.count = 0;
+    for (size_t c = 0; c < COLUMNS; ++c) {
+        b.columns[c].clear();
+        b.last[c] = 0;
+    }
+}
+
+void TrackColumnStore::flushAll() {
+    for (auto& entry : open) flushBlock(entry.second);
+}
+
+bool TrackColumnStore::decodeBlock(const ColumnIndexEntry& entry, std::vector<StoredFix>& out) const {
+    std::string buf(entry.bytes, '\0');
+    if (entry.bytes < sizeof(ColumnBlockHeader) || !readExact(datafd, &buf[0], buf.size(), static_cast<off_t>(entry.offset))) {
+        return false;
+    }
+    ColumnBlockHeader h;
+    std::memcpy(&h, buf.data(), sizeof(h));
+    if (h.magic != BLOCK_MAGIC || h.count != entry.count) return false;
+
+    // 1. Column start offsets
+    const char* cursor[COLUMNS];
+    const char* end[COLUMNS];
+    const char* p = buf.data() + sizeof(h);
+    for (size_t c = 0; c < COLUMNS; ++c) {
+        cursor[c] = p;
+        p += h.columnBytes[c];
+        end[c] = p;
+    }
+    if (p > buf.data() + buf.size()) return false;
+
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(indexMtx);
+        if (h.vessel < vesselNames.size()) name = vesselNames[h.vessel];
+    }
+
+    // 2. Walk all columns in step, undoing the deltas
+    int64_t v[COLUMNS] = {};
+    for (uint32_t i = 0; i < h.count; ++i) {
+        for (size_t c = 0; c < COLUMNS; ++c) {
+            int64_t delta;
+            if (!getVarint(cursor[c], end[c], delta)) return false;
+            v[c] += delta;
+        }
+        StoredFix f;
+        f.timeMs = v[TIME];
+        GPSData& d = f.data;
+        d.ID = name;
+        TrackSchema::setTime(d, v[TIME]);
+        d.latitudeE7 = static_cast<int32_t>(v[LAT]);
+        d.longitudeE7 = static_cast<int32_t>(v[LON]);
+        d.latitude = v[LAT] / 1e7;
+        d.longitude = v[LON] / 1e7;
+        d.altitude = v[ALT] / 10.0;
+        d.speed = v[SPEED] / 100.0;
+        d.course = v[COURSE] / 100.0;
+        d.satellites = static_cast<int>(v[SATS]);
+        d.isValid = v[QUALITY] >= 0;
+        d.fixQuality = d.isValid ? static_cast<int>(v[QUALITY]) : 0;
+        out.push_back(std::move(f));
+    }
+    return true;
+}
+
+std::vector<TrackColumnStore::StoredFix> TrackColumnStore::track(const std::string& sourceID, int64_t fromMs,
+                                                                 int64_t toMs) {
+    // 1. Candidate blocks from the in-memory index
+    std::vector<ColumnIndexEntry> hits;
+    {
+        std::lock_guard<std::mutex> lock(indexMtx);
+        auto it = vesselKeys.find(sourceID);
+        if (it == vesselKeys.end()) return {};
+        for (const auto& e : index) {
+            if (e.vessel == it->second && e.maxMs >= fromMs && e.minMs <= toMs) hits.push_back(e);
+        }
+    }
+
+    // 2. Decode them, keep the window
+    std::vector<StoredFix> out, block;
+    for (const auto& e : hits) {
+        block.clear();
+        if (!decodeBlock(e, block)) continue;
+        for (auto& f : block) {
+            if (f.timeMs >= fromMs && f.timeMs <= toMs) out.push_back(std::move(f));
+        }
+    }
+    std::stable_sort(out.begin(), out.end(), [](const StoredFix& a, const StoredFix& b) { return a.timeMs < b.timeMs; });
+    return out;
+}
+
+void TrackColumnStore::scanBox(double minLat, double minLon, double maxLat, double maxLon, int64_t fromMs,
+                               int64_t toMs, const std::function<void(const StoredFix&)>& visit) {
+    const int32_t lat0 = static_cast<int32_t>(std::floor(minLat * 1e7)), lat1 = static_cast<int32_t>(std::ceil(maxLat * 1e7));
+    const int32_t lon0 = static_cast<int32_t>(std::floor(minLon * 1e7)), lon1 = static_cast<int32_t>(std::ceil(maxLon * 1e7));
+
+    std::vector<ColumnIndexEntry> hits;
+    {
+        std::lock_guard<std::mutex> lock(indexMtx);
+        for (const auto& e : index) {
+            if (e.maxMs >= fromMs && e.minMs <= toMs && e.maxLatE7 >= lat0 && e.minLatE7 <= lat1 &&
+                e.maxLonE7 >= lon0 && e.minLonE7 <= lon1) {
+                hits.push_back(e);
+            }
+        }
+    }
+
+    std::vector<StoredFix> block;
+    for (const auto& e : hits) {
+        block.clear();
+        if (!decodeBlock(e, block)) continue;
+        for (const auto& f : block) {
+            if (f.timeMs >= fromMs && f.timeMs <= toMs && f.data.latitude >= minLat && f.data.latitude <= maxLat &&
+                f.data.longitude >= minLon && f.data.longitude <= maxLon) {
+                visit(f);
+            }
+        }
+    }
+}
+
+TrackColumnStore::Stats TrackColumnStore::stats() const {
+    Stats s;
+    s.fixes = fixes;
+    s.blocks = blocks;
+    s.bytes = bytes;
+    s.dropped = writer.queueStats().dropped;
+    s.writeErrors = writeErrors;
+    return s;
+}
@@ -0,0 +1,99 @@
+#include "TrackPartitions.h"
+#include <dirent.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace {
+// "dir/voyage_data.db" -> {"dir", "voyage_data", ".db"}
+void splitPath(const std::string& base, std::string& dir, std::string& stem, std::string& ext) {
+    size_t slash = base.rfind('/');
+    dir = (slash == std::string::npos) ? "." : base.substr(0, slash);
+    std::string name = (slash == std::string::npos) ? base : base.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    stem = (dot == std::string::npos || dot == 0) ? name : name.substr(0, dot);
+    ext = (dot == std::string::npos || dot == 0) ? "" : name.substr(dot);
+}
+}
+
+int64_t TrackPartitions::periodMs(Partitioning p) {
+    switch (p) {
+        case Partitioning::Hourly: return 3600000;
+        case Partitioning::Daily: return 86400000;
+        default: return std::numeric_limits<int64_t>::max();
+    }
+}
+
+TrackPartitions::File TrackPartitions::fileFor(const std::string& basePath, Partitioning p, int64_t timeMs) {
+    File f;
+    if (p == Partitioning::None) {
+        f.path = basePath;
+        f.startMs = std::numeric_limits<int64_t>::min();
+        f.endMs = std::numeric_limits<int64_t>::max();
+        return f;
+    }
+
+    // 1. Period boundaries (floor, so pre-1970 times still land in the right period)
+    int64_t period = periodMs(p);
+    f.startMs = (timeMs / period - (timeMs % period < 0)) * period;
+    f.endMs = f.startMs + period;
+
+    // 2. Name: UTC date (and hour)
+    time_t secs = static_cast<time_t>(f.startMs / 1000);
+    tm utc{};
+    gmtime_r(&secs, &utc);
+    char stamp[16];
+    strftime(stamp, sizeof(stamp), p == Partitioning::Hourly ? "%Y%m%d%H" : "%Y%m%d", &utc);
+
+    std::string dir, stem, ext;
+    splitPath(basePath, dir, stem, ext);
+    f.path = (basePath.find('/') == std::string::npos ? "" : dir + "/") + stem + "-" + stamp + ext;
+    return f;
+}
+
+std::vector<TrackPartitions::File> TrackPartitions::list(const std::string& basePath, Partitioning p) {
+    std::vector<File> out;
+    if (p == Partitioning::None) {
+        out.push_back(fileFor(basePath, p, 0));
+        return out;
+    }
+
+    std::string dir, stem, ext;
+    splitPath(basePath, dir, stem, ext);
+    const size_t digits = (p == Partitioning::Hourly) ? 10 : 8;
+    const std::string prefix = stem + "-";
+
+    DIR* d = opendir(dir.c_str());
+    if (!d) return out;
+    while (dirent* e = readdir(d)) {
+        // 1. Shape: <stem>-<digits><ext>, nothing else (e.g. not the -wal/-shm files)
+        std::string name = e->d_name;
+        if (name.size() != prefix.size() + digits + ext.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(prefix.size() + digits, ext.size(), ext) != 0) {
+            continue;
+        }
+        std::string stamp = name.substr(prefix.size(), digits);
+        if (stamp.find_first_not_of("0123456789") != std::string::npos) continue;
+
+        // 2. Period start from the stamp
+        tm utc{};
+        utc.tm_year = std::stoi(stamp.substr(0, 4)) - 1900;
+        utc.tm_mon = std::stoi(stamp.substr(4, 2)) - 1;
+        utc.tm_mday = std::stoi(stamp.substr(6, 2));
+        utc.tm_hour = (digits == 10) ? std::stoi(stamp.substr(8, 2)) : 0;
+        int64_t startMs = static_cast<int64_t>(timegm(&utc)) * 1000;
+
+        File f = fileFor(basePath, p, startMs);
+        if (f.path.substr(f.path.size() - name.size()) == name) out.push_back(f); // Canonical names only
+    }
+    closedir(d);
+
+    std::sort(out.begin(), out.end(), [](const File& a, const File& b) { return a.startMs < b.startMs; });
+    return out;
+}
+
+void TrackPartitions::remove(const std::string& path) {
+    for (const char* suffix : {"", "-wal", "-shm"}) std::remove((path + suffix).c_str());
+}
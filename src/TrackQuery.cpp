@@ -0,0 +1,151 @@
+#include "TrackQuery.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+// Merges per-partition results: the newest fix of each source wins
+void keepLatest(std::map<std::string, TrackSchema::StoredFix>& bySource, TrackSchema::StoredFix&& fix) {
+    auto it = bySource.find(fix.data.ID);
+    if (it == bySource.end()) bySource.emplace(fix.data.ID, std::move(fix));
+    else if (fix.timeMs >= it->second.timeMs) it->second = std::move(fix);
+}
+}
+
+TrackQuery::TrackQuery(const std::string& dbPath, Partitioning p) : basePath(dbPath), partitioning(p) {
+    if (partitioning == Partitioning::None) shardsFor(0, 0); // Open now, like before partitioning
+}
+
+TrackQuery::~TrackQuery() = default;
+
+TrackQuery::Shard::~Shard() {
+    sqlite3_finalize(trackStmt);
+    sqlite3_finalize(boxStmt);
+    sqlite3_finalize(latestStmt);
+    if (db) sqlite3_close(db);
+}
+
+bool TrackQuery::Shard::open() {
+    if (sqlite3_open_v2(file.path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::cerr << "DB Error: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_busy_timeout(db, 1000); // WAL checkpoints can briefly lock readers out
+
+    const std::string cols = TrackSchema::SELECT_COLUMNS;
+    // 1. Track: range scan on (source, time_ms)
+    trackStmt = prepare("SELECT " + cols + " FROM fixes f JOIN sources s ON s.id = f.source"
+                        " WHERE s.name = ?1 AND f.time_ms BETWEEN ?2 AND ?3"
+                        " ORDER BY f.time_ms LIMIT ?4;");
+    // 2. Box: R*Tree overlap (its float bounds are rounded outward), then the exact test.
+    //    SQLite returns the bare columns of the row holding MAX() in each group.
+    boxStmt = prepare("SELECT " + cols + ", MAX(f.time_ms) FROM fixes_rtree r"
+                      " JOIN fixes f ON f.id = r.id JOIN sources s ON s.id = f.source"
+                      " WHERE r.max_lat >= ?1 AND r.min_lat <= ?3 AND r.max_lon >= ?2 AND r.min_lon <= ?4"
+                      " AND f.lat BETWEEN ?1 AND ?3 AND f.lon BETWEEN ?2 AND ?4"
+                      " AND f.time_ms BETWEEN ?5 AND ?6"
+                      " GROUP BY f.source ORDER BY s.name;");
+    // 3. Latest: one index probe per source
+    latestStmt = prepare("SELECT " + cols + " FROM sources s JOIN fixes f ON f.id ="
+                         " (SELECT id FROM fixes WHERE source = s.id ORDER BY time_ms DESC LIMIT 1)"
+                         " ORDER BY s.name;");
+    return trackStmt && boxStmt && latestStmt;
+}
+
+sqlite3_stmt* TrackQuery::Shard::prepare(const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "DB Prepare Error: " << sqlite3_errmsg(db) << std::endl;
+    }
+    return stmt;
+}
+
+std::vector<TrackQuery::StoredFix> TrackQuery::Shard::collect(sqlite3_stmt* stmt) {
+    std::vector<StoredFix> out;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) out.push_back(TrackSchema::readRow(stmt));
+    if (rc != SQLITE_DONE) std::cerr << "DB Step Error: " << sqlite3_errmsg(db) << std::endl;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return out;
+}
+
+std::vector<TrackQuery::Shard*> TrackQuery::shardsFor(int64_t fromMs, int64_t toMs) {
+    // 1. What exists now (retention may have deleted files since the last call)
+    auto files = TrackPartitions::list(basePath, partitioning);
+    for (auto it = shards.begin(); it != shards.end();) {
+        bool exists = std::any_of(files.begin(), files.end(), [&](const auto& f) { return f.path == it->first; });
+        it = exists ? std::next(it) : shards.erase(it);
+    }
+
+    // 2. Open the overlapping ones on first use
+    std::vector<Shard*> out;
+    for (const auto& f : files) {
+        if (f.endMs <= fromMs || f.startMs > toMs) continue;
+        auto& shard = shards[f.path];
+        if (!shard) {
+            auto s = std::make_unique<Shard>();
+            s->file = f;
+            if (!s->open()) {
+                shards.erase(f.path);
+                continue;
+            }
+            shard = std::move(s);
+        }
+        out.push_back(shard.get());
+    }
+    return out;
+}
+
+bool TrackQuery::isOpen() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return partitioning != Partitioning::None || !shards.empty();
+}
+
+std::vector<TrackQuery::StoredFix> TrackQuery::track(const std::string& sourceID, int64_t fromMs, int64_t toMs,
+                                                     size_t limit) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<StoredFix> out;
+    // Shards come oldest first, so appending keeps time order and honours 'limit' early
+    for (Shard* s : shardsFor(fromMs, toMs)) {
+        sqlite3_stmt* stmt = s->trackStmt;
+        sqlite3_bind_text(stmt, 1, sourceID.c_str(), static_cast<int>(sourceID.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 2, fromMs);
+        sqlite3_bind_int64(stmt, 3, toMs);
+        sqlite3_bind_int64(stmt, 4, limit == 0 ? -1 : static_cast<sqlite3_int64>(limit - out.size())); // -1: no limit
+        auto part = s->collect(stmt);
+        out.insert(out.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        if (limit != 0 && out.size() >= limit) break;
+    }
+    return out;
+}
+
+std::vector<TrackQuery::StoredFix> TrackQuery::inBox(double minLat, double minLon, double maxLat, double maxLon,
+                                                     int64_t fromMs, int64_t toMs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::map<std::string, StoredFix> bySource; // Latest per source over all partitions, sorted by name
+    for (Shard* s : shardsFor(fromMs, toMs)) {
+        sqlite3_stmt* stmt = s->boxStmt;
+        sqlite3_bind_double(stmt, 1, minLat);
+        sqlite3_bind_double(stmt, 2, minLon);
+        sqlite3_bind_double(stmt, 3, maxLat);
+        sqlite3_bind_double(stmt, 4, maxLon);
+        sqlite3_bind_int64(stmt, 5, fromMs);
+        sqlite3_bind_int64(stmt, 6, toMs);
+        for (auto& fix : s->collect(stmt)) keepLatest(bySource, std::move(fix));
+    }
+    std::vector<StoredFix> out;
+    for (auto& entry : bySource) out.push_back(std::move(entry.second));
+    return out;
+}
+
+std::vector<TrackQuery::StoredFix> TrackQuery::latest() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::map<std::string, StoredFix> bySource;
+    for (Shard* s : shardsFor(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max())) {
+        for (auto& fix : s->collect(s->latestStmt)) keepLatest(bySource, std::move(fix));
+    }
+    std::vector<StoredFix> out;
+    for (auto& entry : bySource) out.push_back(std::move(entry.second));
+    return out;
+}
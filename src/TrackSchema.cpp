@@ -0,0 +1,173 @@
+#include "TrackSchema.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+constexpr int64_t DAY_MS = 86400000;
+
+struct Migration {
+    int version;
+    const char* sql;
+};
+
+// Append only: never edit a step that has shipped, add a new one
+const Migration MIGRATIONS[] = {
+    // v1: full fixes with epoch time, interned sources, (source, time) and R*Tree indexes.
+    // The v0 'tracklog' table (hardcoded time, no source) is left untouched.
+    {1,
+     "CREATE TABLE sources ("
+     "  id INTEGER PRIMARY KEY,"
+     "  name TEXT NOT NULL UNIQUE);"
+     "CREATE TABLE fixes ("
+     "  id INTEGER PRIMARY KEY,"
+     "  source INTEGER NOT NULL REFERENCES sources(id),"
+     "  time_ms INTEGER NOT NULL,"
+     "  lat REAL NOT NULL,"
+     "  lon REAL NOT NULL,"
+     "  altitude REAL,"
+     "  fix_quality INTEGER,"
+     "  satellites INTEGER,"
+     "  speed REAL,"
+     "  course REAL,"
+     "  type TEXT,"
+     "  talker TEXT,"
+     "  valid INTEGER NOT NULL);"
+     "CREATE INDEX fixes_source_time ON fixes(source, time_ms);"
+     "CREATE VIRTUAL TABLE fixes_rtree USING rtree(id, min_lat, max_lat, min_lon, max_lon);"
+     "CREATE TRIGGER fixes_rtree_insert AFTER INSERT ON fixes BEGIN"
+     "  INSERT INTO fixes_rtree VALUES (new.id, new.lat, new.lat, new.lon, new.lon);"
+     "END;"
+     "CREATE TRIGGER fixes_rtree_delete AFTER DELETE ON fixes BEGIN"
+     "  DELETE FROM fixes_rtree WHERE id = old.id;"
+     "END;"},
+    // v2: per-database bookkeeping (e.g. whether a partition was compacted)
+    {2,
+     "CREATE TABLE meta ("
+     "  key TEXT PRIMARY KEY,"
+     "  value TEXT);"},
+};
+
+bool exec(sqlite3* db, const std::string& sql) {
+    char* errMsg = 0;
+    if (sqlite3_exec(db, sql.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL Error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+// Proleptic Gregorian date <-> days since 1970-01-01 (H. Hinnant's algorithms)
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civilFromDays(int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+}
+
+bool TrackSchema::migrate(sqlite3* db) {
+    // 1. Where are we?
+    int current = 0;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) current = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    if (current > VERSION) {
+        std::cerr << "DB: Schema v" << current << " is newer than this build (v" << VERSION << ")" << std::endl;
+        return false;
+    }
+
+    // 2. Apply each missing step atomically, version bump included
+    for (const Migration& m : MIGRATIONS) {
+        if (m.version <= current) continue;
+        if (!exec(db, "BEGIN;")) return false;
+        if (!exec(db, m.sql) || !exec(db, "PRAGMA user_version = " + std::to_string(m.version) + ";")) {
+            exec(db, "ROLLBACK;");
+            return false;
+        }
+        if (!exec(db, "COMMIT;")) return false;
+        std::cout << "DB: Migrated schema to v" << m.version << std::endl;
+    }
+    return true;
+}
+
+int64_t TrackSchema::epochMs(const GPSData& data, int64_t nowMs) {
+    int64_t timeOfDay = std::llround(data.timestamp * 1000.0);
+    unsigned dd, mm, yy;
+    if (data.date.size() == 6 && std::sscanf(data.date.c_str(), "%2u%2u%2u", &dd, &mm, &yy) == 3 && mm >= 1 &&
+        mm <= 12 && dd >= 1 && dd <= 31) {
+        // RMC dates are two-digit years: 80..99 -> 19xx (pre-GPS dates don't occur)
+        int64_t year = yy >= 80 ? 1900 + yy : 2000 + yy;
+        return daysFromCivil(year, mm, dd) * DAY_MS + timeOfDay;
+    }
+    if (data.timestamp <= 0.0) return nowMs;
+
+    // No date: nearest day to 'now' (within +-12 h)
+    int64_t t = floorDiv(nowMs, DAY_MS) * DAY_MS + timeOfDay;
+    if (t - nowMs > DAY_MS / 2) t -= DAY_MS;
+    else if (nowMs - t > DAY_MS / 2) t += DAY_MS;
+    return t;
+}
+
+void TrackSchema::setTime(GPSData& data, int64_t timeMs) {
+    int64_t day = floorDiv(timeMs, DAY_MS);
+    data.timestamp = static_cast<double>(timeMs - day * DAY_MS) / 1000.0;
+
+    int y;
+    unsigned m, d;
+    civilFromDays(day, y, m, d);
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "%02u%02u%02d", d, m, (y % 100 + 100) % 100);
+    data.date = buf;
+}
+
+const char* const TrackSchema::SELECT_COLUMNS =
+    "s.name, f.time_ms, f.lat, f.lon, f.altitude, f.fix_quality, f.satellites, "
+    "f.speed, f.course, f.type, f.talker, f.valid";
+
+TrackSchema::StoredFix TrackSchema::readRow(sqlite3_stmt* stmt) {
+    auto text = [stmt](int col) {
+        const unsigned char* t = sqlite3_column_text(stmt, col);
+        return t ? std::string(reinterpret_cast<const char*>(t)) : std::string();
+    };
+
+    StoredFix row;
+    GPSData& d = row.data;
+    d.ID = text(0);
+    row.timeMs = sqlite3_column_int64(stmt, 1);
+    setTime(d, row.timeMs);
+    d.latitude = sqlite3_column_double(stmt, 2);
+    d.longitude = sqlite3_column_double(stmt, 3);
+    d.latitudeE7 = static_cast<int32_t>(std::llround(d.latitude * 1e7));
+    d.longitudeE7 = static_cast<int32_t>(std::llround(d.longitude * 1e7));
+    d.altitude = sqlite3_column_double(stmt, 4);
+    d.fixQuality = sqlite3_column_int(stmt, 5);
+    d.satellites = sqlite3_column_int(stmt, 6);
+    d.speed = sqlite3_column_double(stmt, 7);
+    d.course = sqlite3_column_double(stmt, 8);
+    d.type = text(9);
+    d.talker = text(10);
+    d.isValid = sqlite3_column_int(stmt, 11) != 0;
+    return row;
+}
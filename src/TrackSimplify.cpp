@@ -0,0 +1,61 @@
+#include "TrackSimplify.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+constexpr double EARTH_RADIUS_M = 6371008.8;
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+struct XY {
+    double x, y;
+};
+
+// Distance of p from segment a-b, in the projection's metres
+double segmentDistance(XY p, XY a, XY b) {
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double len2 = dx * dx + dy * dy;
+    double t = len2 > 0.0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+}
+
+std::vector<bool> simplifyTrack(const std::vector<TrackPoint>& points, double toleranceM) {
+    const size_t n = points.size();
+    std::vector<bool> keep(n, n <= 2 || toleranceM <= 0.0);
+    if (n <= 2 || toleranceM <= 0.0) return keep;
+
+    // 1. Project to metres around the track's first point
+    double cosLat = std::cos(points[0].lat * DEG_TO_RAD);
+    std::vector<XY> xy(n);
+    for (size_t i = 0; i < n; ++i) {
+        double dLon = points[i].lon - points[0].lon;
+        if (dLon > 180.0) dLon -= 360.0; // Antimeridian
+        if (dLon < -180.0) dLon += 360.0;
+        xy[i] = {dLon * DEG_TO_RAD * cosLat * EARTH_RADIUS_M, (points[i].lat - points[0].lat) * DEG_TO_RAD * EARTH_RADIUS_M};
+    }
+
+    // 2. Iterative split (an explicit stack: day-long tracks would overflow recursion)
+    keep[0] = keep[n - 1] = true;
+    std::vector<std::pair<size_t, size_t>> stack{{0, n - 1}};
+    while (!stack.empty()) {
+        auto [first, last] = stack.back();
+        stack.pop_back();
+
+        double worst = 0.0;
+        size_t index = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            double d = segmentDistance(xy[i], xy[first], xy[last]);
+            if (d > worst) {
+                worst = d;
+                index = i;
+            }
+        }
+        if (worst > toleranceM) {
+            keep[index] = true;
+            stack.emplace_back(first, index);
+            stack.emplace_back(index, last);
+        }
+    }
+    return keep;
+}
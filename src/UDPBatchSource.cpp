@@ -0,0 +1,174 @@
+#include "UDPBatchSource.h"
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+UDPBatchSource::UDPBatchSource(Config cfg) : config(cfg), port(cfg.port) {
+    if (config.batch == 0) config.batch = 1;
+    if (config.slotBytes == 0) config.slotBytes = 2048;
+
+    // 1. Allocate everything once: the hot path never touches the heap
+    controlBytes = CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+    slab = std::make_unique<char[]>(config.batch * config.slotBytes);
+    control = std::make_unique<char[]>(config.batch * controlBytes);
+    headers.resize(config.batch);
+    iovecs.resize(config.batch);
+    received.resize(config.batch);
+
+    // 2. Point each header at its own slot of the slab
+    for (size_t i = 0; i < config.batch; ++i) {
+        iovecs[i].iov_base = slab.get() + i * config.slotBytes;
+        iovecs[i].iov_len = config.slotBytes;
+        std::memset(&headers[i], 0, sizeof(mmsghdr));
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+UDPBatchSource::~UDPBatchSource() {
+    close();
+}
+
+bool UDPBatchSource::open() {
+    // 1. Create UDP Socket
+    if ((sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+        std::cerr << "UDP: Socket creation failed" << std::endl;
+        return false;
+    }
+
+    // 2. Options: must be set before bind() for SO_REUSEPORT to take effect
+    int one = 1;
+    if (config.reusePort && setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+        perror("UDP SO_REUSEPORT");
+    }
+    if (config.kernelTimestamps && setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) < 0) {
+        perror("UDP SO_TIMESTAMPNS"); // Not fatal: datagrams just carry no timestamp
+    }
+    setsockopt(sockfd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one)); // Best effort drop counter
+    if (config.receiveBufferBytes > 0) {
+        setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &config.receiveBufferBytes, sizeof(config.receiveBufferBytes));
+    }
+
+    // 3. Bind to Port
+    sockaddr_in servaddr{};
+    servaddr.sin_family = AF_INET;
+    servaddr.sin_addr.s_addr = INADDR_ANY; // Listen on all interfaces
+    servaddr.sin_port = htons(static_cast<uint16_t>(config.port));
+    if (bind(sockfd, (const sockaddr*)&servaddr, sizeof(servaddr)) < 0) {
+        perror("UDP Bind Error");
+        ::close(sockfd);
+        sockfd = -1;
+        return false;
+    }
+
+    // Port 0 asks the kernel for a free port: remember which one we got
+    socklen_t len = sizeof(servaddr);
+    if (getsockname(sockfd, (sockaddr*)&servaddr, &len) == 0) port = ntohs(servaddr.sin_port);
+
+    std::cout << "UDP: Listening on port " << port << " (batch " << config.batch << ")" << std::endl;
+    return true;
+}
+
+void UDPBatchSource::close() {
+    if (sockfd < 0) return;
+    ::shutdown(sockfd, SHUT_RDWR); // Wakes a reader blocked in recvmmsg()
+    ::close(sockfd);
+    sockfd = -1;
+}
+
+size_t UDPBatchSource::receiveBatch() {
+    count = cursor = 0;
+    if (sockfd < 0) return 0;
+
+    // 1. Reset the per-call fields the kernel overwrites
+    for (size_t i = 0; i < config.batch; ++i) {
+        msghdr& h = headers[i].msg_hdr;
+        h.msg_control = control.get() + i * controlBytes;
+        h.msg_controllen = controlBytes;
+        h.msg_flags = 0;
+    }
+
+    // 2. One syscall: wait for the first datagram, then drain what is already queued
+    int n;
+    do {
+        n = recvmmsg(sockfd, headers.data(), static_cast<unsigned>(config.batch), MSG_WAITFORONE, nullptr);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) stats_.errors++;
+        return 0;
+    }
+    stats_.syscalls++;
+
+    // 3. Describe each datagram: payload view + ancillary data
+    for (int i = 0; i < n; ++i) {
+        msghdr& h = headers[i].msg_hdr;
+        UDPDatagram& d = received[i];
+        d.data = std::string_view(static_cast<const char*>(iovecs[i].iov_base), headers[i].msg_len);
+        d.truncated = (h.msg_flags & MSG_TRUNC) != 0;
+        d.kernelTimeNs = 0;
+        if (d.truncated) stats_.truncated++;
+
+        for (cmsghdr* c = CMSG_FIRSTHDR(&h); c != nullptr; c = CMSG_NXTHDR(&h, c)) {
+            if (c->cmsg_level != SOL_SOCKET) continue;
+            if (c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                d.kernelTimeNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+            } else if (c->cmsg_type == SO_RXQ_OVFL) {
+                // Running total of datagrams the kernel dropped on this socket
+                uint32_t drops;
+                std::memcpy(&drops, CMSG_DATA(c), sizeof(drops));
+                if (drops > lastDropCounter) stats_.kernelDrops += drops - lastDropCounter;
+                lastDropCounter = drops;
+            }
+        }
+    }
+
+    count = static_cast<size_t>(n);
+    stats_.datagrams += count;
+    return count;
+}
+
+size_t UDPBatchSource::readChunk(char* buf, size_t cap) {
+    const UDPDatagram* next = nextDatagram();
+    if (next == nullptr) return 0;
+
+    const UDPDatagram& d = *next;
+    lastTimeNs = d.kernelTimeNs;
+    size_t n = std::min(d.data.size(), cap);
+    std::memcpy(buf, d.data.data(), n);
+    return n;
+}
+
+IPollableSource::ReadResult UDPBatchSource::tryRead(char* buf, size_t cap, size_t& n) {
+    if (cursor == count && receiveBatch() == 0) {
+        bool idle = sockfd >= 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        return idle ? ReadResult::WouldBlock : ReadResult::Closed;
+    }
+
+    const UDPDatagram& d = received[cursor++];
+    lastTimeNs = d.kernelTimeNs;
+    n = std::min(d.data.size(), cap);
+    std::memcpy(buf, d.data.data(), n);
+    return ReadResult::Data;
+}
+
+std::string UDPBatchSource::readLine() {
+    const UDPDatagram* d = nextDatagram();
+    if (d == nullptr) return std::string();
+    lastTimeNs = d->kernelTimeNs;
+    return std::string(d->data);
+}
+
+// Next non-empty datagram, refilling the batch when it runs dry (0 bytes means "error" to readers)
+const UDPDatagram* UDPBatchSource::nextDatagram() {
+    for (;;) {
+        if (cursor == count && receiveBatch() == 0) return nullptr;
+        const UDPDatagram& d = received[cursor++];
+        if (!d.data.empty()) return &d;
+    }
+}
@@ -0,0 +1,388 @@
+#include "WebFeed.h"
+#include "FixJson.h"
+#include <algorithm>
+
+namespace {
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// "[fix,fix,...]": one JSON array per frame
+WebFeed::Buffer jsonFrame(const std::vector<std::pair<uint32_t, const GPSData*>>& updates) {
+    auto frame = std::make_shared<std::string>();
+    frame->reserve(2 + updates.size() * 200); // A fix is ~170 bytes
+    frame->push_back('[');
+    for (const auto& u : updates) {
+        if (frame->size() > 1) frame->push_back(',');
+        FixJson::append(*frame, *u.second);
+    }
+    frame->push_back(']');
+    return frame;
+}
+}
+
+WebFeed::WebFeed(Config cfg)
+    : config(cfg), positions(cfg.gridCellDeg), tickGrid(cfg.gridCellDeg), clients(std::make_shared<const ClientList>()) {
+    if (config.maxInFlight == 0) config.maxInFlight = 1;
+}
+
+WebFeed::~WebFeed() {
+    stop();
+}
+
+void WebFeed::start() {
+    if (ticker.joinable() || config.tick.count() <= 0) return;
+    stopping = false;
+    ticker = std::thread(&WebFeed::run, this);
+}
+
+void WebFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(tickMtx);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (ticker.joinable()) ticker.join();
+}
+
+void WebFeed::run() {
+    std::unique_lock<std::mutex> lock(tickMtx);
+    while (!stopping) {
+        cv.wait_for(lock, config.tick, [this] { return stopping.load(); });
+        if (stopping) break;
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void WebFeed::publish(const GPSData& fix) {
+    published++;
+    if (std::atomic_load(&clients)->empty()) return; // Nobody watching
+
+    std::lock_guard<std::mutex> lock(latestMtx);
+    auto it = latest.try_emplace(fix.ID, fix);
+    if (!it.second) {
+        it.first->second = fix;
+        coalesced++;
+    }
+}
+
+uint64_t WebFeed::addClient(SendFn send, CloseFn close) {
+    auto client = std::make_shared<Client>();
+    client->send = std::move(send);
+    client->close = std::move(close);
+
+    std::lock_guard<std::mutex> lock(listMtx);
+    client->id = nextId++;
+    auto next = std::make_shared<ClientList>(*clients);
+    next->push_back(client);
+    std::atomic_store(&clients, std::shared_ptr<const ClientList>(std::move(next)));
+    return client->id;
+}
+
+void WebFeed::removeClient(uint64_t id) {
+    std::lock_guard<std::mutex> lock(listMtx);
+    auto next = std::make_shared<ClientList>();
+    for (const auto& c : *clients) {
+        if (c->id != id) {
+            next->push_back(c);
+            continue;
+        }
+        // Waits out a send in progress; the feed thread skips it from here on
+        std::lock_guard<std::mutex> clientLock(c->mtx);
+        c->gone = true;
+        c->pending.clear();
+    }
+    std::atomic_store(&clients, std::shared_ptr<const ClientList>(std::move(next)));
+}
+
+std::shared_ptr<WebFeed::Client> WebFeed::find(uint64_t id) const {
+    auto list = std::atomic_load(&clients);
+    for (const auto& c : *list) {
+        if (c->id == id) return c;
+    }
+    return nullptr;
+}
+
+void WebFeed::acknowledge(uint64_t id) {
+    auto c = find(id);
+    if (!c) return;
+    std::lock_guard<std::mutex> lock(c->mtx);
+    if (c->inFlight > 0) c->inFlight--;
+    if (c->inFlight < config.maxInFlight) c->stalledSinceMs = 0;
+}
+
+void WebFeed::setProtocol(uint64_t id, Protocol protocol) {
+    auto c = find(id);
+    if (!c) return;
+    std::lock_guard<std::mutex> lock(c->mtx);
+    c->protocol = protocol;
+    c->sent.clear(); // Binary starts over with named, absolute records
+}
+
+void WebFeed::setFlowControl(uint64_t id, FlowControl flow) {
+    auto c = find(id);
+    if (!c) return;
+    std::lock_guard<std::mutex> lock(c->mtx);
+    c->flow = flow;
+    c->inFlight = 0;
+    c->stalledSinceMs = 0;
+}
+
+void WebFeed::subscribe(uint64_t id, Subscription sub) {
+    auto c = find(id);
+    if (!c) return;
+    // Sorted and unique: the feed thread binary-searches it as vessels arrive
+    std::sort(sub.vessels.begin(), sub.vessels.end());
+    sub.vessels.erase(std::unique(sub.vessels.begin(), sub.vessels.end()), sub.vessels.end());
+    std::lock_guard<std::mutex> lock(c->mtx);
+    c->sub = std::move(sub);
+    c->resubscribed = true;
+    c->nextDueMs = 0;
+}
+
+uint32_t WebFeed::handleFor(const std::string& id) {
+    auto it = handles.find(id);
+    if (it != handles.end()) return it->second;
+    uint32_t handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+        names[handle] = id;
+    } else {
+        handle = static_cast<uint32_t>(names.size());
+        names.push_back(id);
+        lastFix.emplace_back();
+        lastSeenMs.push_back(0);
+    }
+    lastSeenMs[handle] = nowMs();
+    handles.emplace(id, handle);
+    liveVessels = handles.size();
+    return handle;
+}
+
+// Frees the handles of vessels silent for vesselTimeout (checked at most once a second)
+void WebFeed::expireSilent(int64_t now, std::vector<uint32_t>& freed) {
+    freed.clear();
+    if (config.vesselTimeout.count() <= 0 || now < nextSweepMs) return;
+    nextSweepMs = now + std::min<int64_t>(1000, config.vesselTimeout.count());
+    for (uint32_t h = 0; h < names.size(); ++h) {
+        if (names[h].empty() || now - lastSeenMs[h] < config.vesselTimeout.count()) continue;
+        handles.erase(names[h]);
+        names[h].clear();
+        lastFix[h] = GPSData();
+        positions.erase(h);
+        freeHandles.push_back(h);
+        freed.push_back(h);
+    }
+    expired += freed.size();
+    liveVessels = handles.size();
+}
+
+bool WebFeed::windowOpen(Client& c, int64_t now) const {
+    if (c.flow == FlowControl::Ack) return c.inFlight < config.maxInFlight;
+    if (config.maxBytesPerSec == 0) return true;
+    if (now - c.budgetStartMs >= 1000) {
+        c.budgetStartMs = now;
+        c.budgetBytes = 0;
+    }
+    return c.budgetBytes < config.maxBytesPerSec;
+}
+
+void WebFeed::send(Client& c, const Buffer& frame, bool binary) {
+    if (c.flow == FlowControl::Ack) c.inFlight++;
+    else c.budgetBytes += frame->size();
+    frames++;
+    bytes += frame->size();
+    c.send(frame, binary);
+}
+
+// JSON frames can be shared between clients (sharedJson); binary ones carry per-client deltas
+void WebFeed::sendFrame(Client& c, const std::vector<Update>& updates, Buffer* sharedJson) {
+    if (c.protocol == Protocol::Json) {
+        if (!sharedJson) {
+            send(c, jsonFrame(updates), false);
+            return;
+        }
+        if (!*sharedJson) *sharedJson = jsonFrame(updates);
+        send(c, *sharedJson, false);
+        return;
+    }
+
+    std::string frame(1, static_cast<char>(WireFormat::VERSION));
+    for (const auto& u : updates) {
+        WireFormat::State now = WireFormat::toState(*u.second);
+        auto it = c.sent.find(u.first);
+        if (!WireFormat::encode(frame, u.first, names[u.first], now, it == c.sent.end() ? nullptr : &it->second)) {
+            continue; // Unchanged since the last frame
+        }
+        if (it == c.sent.end()) c.sent.emplace(u.first, std::move(now));
+        else it->second = std::move(now);
+    }
+    if (frame.size() > 1) send(c, std::make_shared<const std::string>(std::move(frame)), true);
+}
+
+// Feed thread: resolves the vessel list and queues the current state of everything that
+// newly matches, so a moved viewport fills in without waiting for those vessels to report.
+// IDs the feed has not seen take no handle: they resolve when the vessel first reports.
+void WebFeed::applySubscription(Client& c) {
+    c.resubscribed = false;
+    c.followed.clear();
+    for (const auto& id : c.sub.vessels) {
+        auto it = handles.find(id);
+        if (it != handles.end()) c.followed.push_back(it->second);
+    }
+
+    std::vector<uint32_t> matching;
+    if (!c.sub.filters()) {
+        for (uint32_t h = 0; h < lastFix.size(); ++h) matching.push_back(h);
+    } else {
+        if (c.sub.hasBox) positions.query(c.sub.box, matching);
+        matching.insert(matching.end(), c.followed.begin(), c.followed.end());
+    }
+    for (uint32_t h : matching) {
+        if (!lastFix[h].ID.empty()) c.pending.try_emplace(h, lastFix[h]); // Keeps a newer pending fix
+    }
+}
+
+// This tick's updates that match the client's filter: box hits from the tick grid, then the
+// followed vessels that updated (tickIndex: handle -> update index, -1 = no update)
+void WebFeed::route(const Client& c, const std::vector<Update>& updates, const std::vector<int32_t>& tickIndex,
+                    std::vector<Update>& out) const {
+    out.clear();
+    if (c.sub.hasBox) {
+        std::vector<uint32_t> hits;
+        tickGrid.query(c.sub.box, hits);
+        for (uint32_t i : hits) out.push_back(updates[i]);
+    }
+    for (uint32_t h : c.followed) {
+        int32_t i = h < tickIndex.size() ? tickIndex[h] : -1;
+        if (i < 0) continue;
+        const GPSData& fix = *updates[static_cast<size_t>(i)].second;
+        if (c.sub.hasBox && c.sub.box.contains(fix.latitude, fix.longitude)) continue; // Already a box hit
+        out.push_back(updates[static_cast<size_t>(i)]);
+    }
+}
+
+void WebFeed::flush() {
+    // 1. Take this tick's updates (already newest-per-vessel) and index them
+    std::unordered_map<std::string, GPSData> fixes;
+    {
+        std::lock_guard<std::mutex> lock(latestMtx);
+        fixes.swap(latest);
+    }
+    int64_t now = nowMs();
+    std::vector<Update> updates;
+    std::vector<uint32_t> arrived; // Vessels reporting for the first time (or again after expiry)
+    updates.reserve(fixes.size());
+    tickGrid.clear();
+    for (const auto& f : fixes) {
+        uint32_t h = handleFor(f.first);
+        if (lastFix[h].ID.empty()) arrived.push_back(h);
+        lastFix[h] = f.second;
+        lastSeenMs[h] = now;
+        positions.insert(h, f.second.latitude, f.second.longitude);
+        tickGrid.insert(static_cast<uint32_t>(updates.size()), f.second.latitude, f.second.longitude);
+        updates.emplace_back(h, &f.second);
+    }
+    std::vector<int32_t> tickIndex(names.size(), -1);
+    for (size_t i = 0; i < updates.size(); ++i) tickIndex[updates[i].first] = static_cast<int32_t>(i);
+    std::vector<uint32_t> freed;
+    expireSilent(now, freed);
+
+    // 2. Unfiltered JSON clients that keep up share one frame; backlogged, rate-limited or
+    // filtered ones get their own
+    auto list = std::atomic_load(&clients);
+    Buffer shared;
+    std::vector<Update> routed;
+    for (const auto& c : *list) {
+        std::lock_guard<std::mutex> lock(c->mtx);
+        if (c->gone) continue;
+        // A freed handle may come back as another vessel: it starts over with NAME
+        for (uint32_t h : freed) {
+            c->sent.erase(h);
+            c->pending.erase(h);
+            c->followed.erase(std::remove(c->followed.begin(), c->followed.end(), h), c->followed.end());
+        }
+        if (c->resubscribed) {
+            applySubscription(*c);
+        } else if (!c->sub.vessels.empty()) {
+            // Followed vessels resolve when they report
+            for (uint32_t h : arrived) {
+                if (std::binary_search(c->sub.vessels.begin(), c->sub.vessels.end(), names[h])) c->followed.push_back(h);
+            }
+        }
+
+        bool filtered = c->sub.filters();
+        if (filtered) route(*c, updates, tickIndex, routed);
+        const std::vector<Update>& mine = filtered ? routed : updates;
+        bool open = windowOpen(*c, now);
+        bool due = now >= c->nextDueMs;
+        int64_t interval = c->sub.maxRate > 0 ? static_cast<int64_t>(1000.0 / c->sub.maxRate) : 0;
+
+        if (open && due && c->pending.empty()) {
+            c->stalledSinceMs = 0; // Keeping up
+            if (!mine.empty()) {
+                sendFrame(*c, mine, filtered ? nullptr : &shared);
+                c->nextDueMs = now + interval;
+            }
+            continue;
+        }
+
+        for (const auto& u : mine) {
+            auto it = c->pending.try_emplace(u.first, *u.second);
+            if (!it.second) {
+                it.first->second = *u.second;
+                coalesced++;
+            }
+        }
+
+        if (open) {
+            if (!due) continue; // Rate limit: keep coalescing
+            std::vector<Update> view;
+            view.reserve(c->pending.size());
+            for (const auto& p : c->pending) view.emplace_back(p.first, &p.second);
+            sendFrame(*c, view, nullptr);
+            c->pending.clear();
+            c->nextDueMs = now + interval;
+            continue;
+        }
+
+        // 3. Window shut: give the client laggardTimeout to catch up (plain clients: to get
+        // back under budget without a backlog)
+        if (c->stalledSinceMs == 0) {
+            c->stalledSinceMs = now;
+        } else if (now - c->stalledSinceMs >= config.laggardTimeout.count()) {
+            c->gone = true;
+            c->pending.clear();
+            disconnected++;
+            c->close(); // Transport reports the close later; removeClient() tidies up
+        }
+    }
+}
+
+WebFeed::Stats WebFeed::stats() const {
+    Stats s;
+    s.published = published;
+    s.coalesced = coalesced;
+    s.frames = frames;
+    s.bytes = bytes;
+    s.disconnected = disconnected;
+    s.vessels = liveVessels;
+    s.expired = expired;
+    auto list = std::atomic_load(&clients);
+    for (const auto& c : *list) {
+        std::lock_guard<std::mutex> lock(c->mtx);
+        if (c->gone) continue;
+        s.clients++;
+        if (c->protocol == Protocol::Binary) s.binaryClients++;
+        if (c->sub.filters()) s.subscribed++;
+        if (c->flow == FlowControl::None) s.plainClients++;
+        bool shut = c->flow == FlowControl::Ack ? c->inFlight >= config.maxInFlight
+                                                : config.maxBytesPerSec > 0 && c->budgetBytes >= config.maxBytesPerSec;
+        if (shut) s.backlogged++;
+    }
+    return s;
+}
@@ -1,80 +1,104 @@
 #include "WebServer.h"
 #include <algorithm>
-#include <fstream>  // <--- NEW
-#include <sstream>  // <--- NEW
+#include <cstdint>
+#include <iostream>
+#include <nlohmann/json.hpp>
+namespace {
+// Crow keeps a void* per connection: ours is the feed's client ID
+uint64_t clientId(crow::websocket::connection& conn) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(conn.userdata()));
+}
 
-// Helper to read file content from disk
-std::string readFile(const std::string& path) {
-    std::ifstream in(path, std::ios::in | std::ios::binary);
-    if (in) {
-        std::ostringstream contents;
-        contents << in.rdbuf();
-        in.close();
-        return contents.str();
+// Malformed parts are ignored: an unusable bbox means no box filter, and so on
+WebFeed::Subscription parseSubscription(const nlohmann::json& j) {
+    WebFeed::Subscription sub;
+    auto bbox = j.find("bbox");
+    if (bbox != j.end() && bbox->is_array() && bbox->size() == 4 &&
+        std::all_of(bbox->begin(), bbox->end(), [](const nlohmann::json& v) { return v.is_number(); })) {
+        sub.hasBox = GeoGrid::makeBox((*bbox)[0].get<double>(), (*bbox)[1].get<double>(), (*bbox)[2].get<double>(),
+                                      (*bbox)[3].get<double>(), sub.box);
+    }
+    auto vessels = j.find("vessels");
+    if (vessels != j.end() && vessels->is_array()) {
+        for (const auto& v : *vessels) {
+            if (v.is_string()) sub.vessels.push_back(v.get<std::string>());
+        }
     }
-    return "";
+    auto maxRate = j.find("maxRate");
+    if (maxRate != j.end() && maxRate->is_number()) sub.maxRate = std::max(0.0, maxRate->get<double>());
+    return sub;
+}
 }
 
-WebServer::WebServer() {
-    // 1. Root Route: Serve the React "index.html"
-    // Note: We assume the "dist" folder is next to the executable
-    CROW_ROUTE(app, "/")([](const crow::request&, crow::response& res){
-        std::string content = readFile("../frontend/dist/index.html");
-        if (content.empty()) {
-            res.code = 404;
-            res.write("Error: frontend/dist/index.html not found. Did you run 'npm run build'?");
-        } else {
-            res.set_header("Content-Type", "text/html");
-            res.write(content);
-        }
-        res.end();
-    });
+WebServer::WebServer() : WebServer(WebFeed::Config{}) {}
 
-    // 2. Assets Route: Serve JS/CSS/IMG files
-    // Catch-all for anything inside /assets/
-    CROW_ROUTE(app, "/assets/<string>")([](const crow::request&, crow::response& res, std::string filename){
-        std::string path = "../frontend/dist/assets/" + filename;
-        std::string content = readFile(path);
-        
-        if (content.empty()) {
-            res.code = 404;
-            res.write("Not Found");
-        } else {
-            // MIME Type detection
-            if (filename.find(".js") != std::string::npos) {
-                res.set_header("Content-Type", "application/javascript");
-            } else if (filename.find(".css") != std::string::npos) {
-                res.set_header("Content-Type", "text/css");
-            } else if (filename.find(".png") != std::string::npos) {
-                res.set_header("Content-Type", "image/png");
-            } else if (filename.find(".jpg") != std::string::npos || filename.find(".jpeg") != std::string::npos) {
-                res.set_header("Content-Type", "image/jpeg");
-            } else if (filename.find(".svg") != std::string::npos) {
-                res.set_header("Content-Type", "image/svg+xml");
-            }
-            res.write(content);
-        }
-        res.end();
+WebServer::WebServer(WebFeed::Config feedConfig, const std::string& webRoot) : feed(feedConfig) {
+    // 0. The dashboard, loaded and precompressed once; requests never touch the disk
+    std::string root = StaticAssets::locate(webRoot);
+    if (assets.load(root) == 0) {
+        std::cerr << "[Web] No dashboard files in " << root << " (did you run 'npm run build'?)" << std::endl;
+    }
+
+    // 1. Root Route: Serve the React "index.html"
+    CROW_ROUTE(app, "/")([this](const crow::request& req, crow::response& res){
+        serveAsset(req, res, "/index.html");
     });
 
-    // 3. WebSocket Route
+    // 2. WebSocket Route
+    // Frames are JSON arrays of updates, or WireFormat binary frames after the client sent
+    // {"protocol":"binary"}. send_text() and send_binary() only queue on the connection's
+    // I/O thread; a client that sent {"flow":"ack"} answers each frame with "ack", and the
+    // feed keeps at most a few unacknowledged frames for it, so that queue stays short.
+    // Other clients are only held to a byte budget per second (see WebFeed.h).
     CROW_WEBSOCKET_ROUTE(app, "/ws")
         .onopen([this](crow::websocket::connection& conn) {
-            std::lock_guard<std::mutex> lock(mtx);
-            connections.push_back(&conn);
+            uint64_t id = feed.addClient(
+                [&conn](const WebFeed::Buffer& frame, bool binary) {
+                    if (binary) conn.send_binary(*frame);
+                    else conn.send_text(*frame);
+                },
+                [&conn]() { conn.close("Too far behind"); });
+            conn.userdata(reinterpret_cast<void*>(static_cast<uintptr_t>(id)));
         })
         .onclose([this](crow::websocket::connection& conn, std::string reason) {
-            std::lock_guard<std::mutex> lock(mtx);
-            connections.erase(
-                std::remove(connections.begin(), connections.end(), &conn), 
-                connections.end()
-            );
+            (void)reason;
+            feed.removeClient(clientId(conn));
         })
-        .onmessage([](crow::websocket::connection&, std::string data, bool is_binary) {
-            // Ignore input
-            (void)data; (void)is_binary;
+        .onmessage([this](crow::websocket::connection& conn, std::string data, bool is_binary) {
+            if (is_binary) return;
+            if (data == "ack") { // Hot path: no parsing
+                feed.acknowledge(clientId(conn));
+                return;
+            }
+
+            // Control messages: {"protocol":"binary"|"json"}, {"flow":"ack"|"none"},
+            // {"subscribe":{"bbox":[west,south,east,north],"vessels":["id",...],"maxRate":N}}
+            auto msg = nlohmann::json::parse(data, nullptr, false);
+            if (!msg.is_object()) return;
+            auto protocol = msg.find("protocol");
+            if (protocol != msg.end() && protocol->is_string()) {
+                feed.setProtocol(clientId(conn), *protocol == "binary" ? WebFeed::Protocol::Binary : WebFeed::Protocol::Json);
+            }
+            auto flow = msg.find("flow");
+            if (flow != msg.end() && flow->is_string()) {
+                feed.setFlowControl(clientId(conn), *flow == "ack" ? WebFeed::FlowControl::Ack : WebFeed::FlowControl::None);
+            }
+            auto subscribe = msg.find("subscribe");
+            if (subscribe != msg.end() && subscribe->is_object()) {
+                feed.subscribe(clientId(conn), parseSubscription(*subscribe));
+            }
         });
+
+    // 3. Everything else in the build: /assets/*, nested paths, top-level files (/vite.svg, ...)
+    // Registered last: when several rules match, Crow takes the earliest, so "/" and "/ws"
+    // win over this catch-all. Lookups only hit the in-memory table.
+    CROW_ROUTE(app, "/<path>")([this](const crow::request& req, crow::response& res, std::string path){
+        serveAsset(req, res, "/" + path);
+    });
+
+    feed.start();
 }
+
 void WebServer::run() {
     // std::cout << "[Web] Starting Server on Port 8080..." << std::endl;
     app.loglevel(crow::LogLevel::Warning);
@@ -89,11 +113,28 @@ void WebServer::run() {
     }
 }
 
-void WebServer::broadcast(const std::string& message) {
-    std::lock_guard<std::mutex> lock(mtx);
-    
-    // Loop through all active connections and send data
-    for (auto* conn : connections) {
-        conn->send_text(message);
+void WebServer::serveAsset(const crow::request& req, crow::response& res, const std::string& path) {
+    StaticAssets::Reply reply =
+        assets.serve(path, req.get_header_value("Accept-Encoding"), req.get_header_value("If-None-Match"));
+    if (reply.status == 404) {
+        res.code = 404;
+        res.write(assets.size() == 0 ? "Error: frontend/dist not found. Did you run 'npm run build'?" : "Not Found");
+        res.end();
+        return;
+    }
+
+    res.code = reply.status;
+    res.set_header("ETag", *reply.etag);
+    res.set_header("Cache-Control", reply.asset->cacheControl);
+    res.set_header("Vary", "Accept-Encoding");
+    if (reply.status == 200) {
+        res.set_header("Content-Type", reply.asset->mime);
+        if (reply.encoding) res.set_header("Content-Encoding", reply.encoding);
+        res.body = *reply.body;
     }
-}
\ No newline at end of file
+    res.end();
+}
+
+void WebServer::broadcast(const GPSData& fix) {
+    feed.publish(fix);
+}
@@ -0,0 +1,123 @@
+#include "WireFormat.h"
+#include <cmath>
+
+using namespace WireFormat;
+
+namespace {
+struct NumericField {
+    uint32_t bit;
+    int64_t State::*member;
+};
+
+// Bit order = wire order
+const NumericField NUMERIC[] = {
+    {LAT, &State::latE7},   {LON, &State::lonE7},   {TIME, &State::timeMs}, {SPEED, &State::speed},
+    {COURSE, &State::course}, {ALT, &State::altDm}, {SATS, &State::sats},   {VALID, &State::valid},
+};
+
+void putUVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putVarint(std::string& out, int64_t value) {
+    putUVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); // Zig-zag
+}
+
+void putString(std::string& out, const std::string& s) {
+    putUVarint(out, s.size());
+    out.append(s);
+}
+
+bool getUVarint(const char*& p, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false; // Truncated or overlong
+}
+
+bool getString(const char*& p, const char* end, std::string& s) {
+    uint64_t len;
+    if (!getUVarint(p, end, len) || len > static_cast<uint64_t>(end - p)) return false;
+    s.assign(p, static_cast<size_t>(len));
+    p += len;
+    return true;
+}
+}
+
+State WireFormat::toState(const GPSData& data) {
+    State s;
+    s.latE7 = data.latE7();
+    s.lonE7 = data.lonE7();
+    s.timeMs = std::llround(data.timestamp * 1000.0);
+    s.speed = std::llround(data.speed * 100.0);
+    s.course = std::llround(data.course * 100.0);
+    s.altDm = std::llround(data.altitude * 10.0);
+    s.sats = data.satellites;
+    s.valid = data.isValid ? 1 : 0;
+    s.type = data.type;
+    return s;
+}
+
+bool WireFormat::encode(std::string& frame, uint32_t handle, const std::string& name, const State& now,
+                        const State* last) {
+    static const State ZERO;
+    const State& base = last ? *last : ZERO;
+
+    // 1. Which fields changed?
+    uint32_t mask = last ? 0u : static_cast<uint32_t>(NAME);
+    if (now.type != base.type) mask |= TYPE;
+    for (const auto& f : NUMERIC) {
+        if (now.*f.member != base.*f.member) mask |= f.bit;
+    }
+    if (mask == 0) return false;
+
+    // 2. Record: handle, mask, strings, then numeric deltas in bit order
+    putUVarint(frame, handle);
+    putUVarint(frame, mask);
+    if (mask & NAME) putString(frame, name);
+    if (mask & TYPE) putString(frame, now.type);
+    for (const auto& f : NUMERIC) {
+        if (mask & f.bit) putVarint(frame, now.*f.member - base.*f.member);
+    }
+    return true;
+}
+
+bool WireFormat::decode(std::string_view frame, std::unordered_map<uint32_t, Vessel>& vessels,
+                        std::vector<uint32_t>& updated) {
+    const char* p = frame.data();
+    const char* end = p + frame.size();
+    if (p == end || static_cast<uint8_t>(*p++) != VERSION) return false;
+
+    while (p < end) {
+        uint64_t handle, mask;
+        if (!getUVarint(p, end, handle) || !getUVarint(p, end, mask)) return false;
+
+        auto it = vessels.find(static_cast<uint32_t>(handle));
+        if (mask & NAME) {
+            Vessel fresh; // A named record starts over from zero
+            if (!getString(p, end, fresh.name)) return false;
+            it = vessels.insert_or_assign(static_cast<uint32_t>(handle), std::move(fresh)).first;
+        } else if (it == vessels.end()) {
+            return false; // Delta against a state we never had
+        }
+        Vessel& v = it->second;
+
+        if ((mask & TYPE) && !getString(p, end, v.state.type)) return false;
+        for (const auto& f : NUMERIC) {
+            if (!(mask & f.bit)) continue;
+            uint64_t z;
+            if (!getUVarint(p, end, z)) return false;
+            int64_t delta = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+            v.state.*f.member = static_cast<int64_t>(static_cast<uint64_t>(v.state.*f.member) + static_cast<uint64_t>(delta));
+        }
+        updated.push_back(static_cast<uint32_t>(handle));
+    }
+    return true;
+}
@@ -2,6 +2,7 @@
 #include <vector>
 #include <chrono>
 #include "NMEAParser.h"
+#include "NMEAScanner.h"
 
 int main() {
     NMEAParser parser;
@@ -12,7 +13,8 @@ int main() {
     std::vector<std::string> data(1000000, sample);
 
     // 2. Measure Parsing Time
-    std::cout << "Starting Benchmark..." << std::endl;
+    std::cout << "Starting Benchmark (" << NMEAScanner::kernelName(NMEAScanner::activeKernel())
+              << " scanner)..." << std::endl;
     auto start = std::chrono::high_resolution_clock::now();
 
     volatile double prevent_opt = 0; // Prevent compiler from optimizing away the loop
@@ -27,5 +29,16 @@ int main() {
     std::cout << "Parsed 1,000,000 lines in: " << diff.count() << " seconds" << std::endl;
     std::cout << "Average throughput: " << (1000000 / diff.count()) << " msg/sec" << std::endl;
 
+    // 3. Measure Batch (Columnar) Parsing
+    std::vector<std::string_view> views(data.begin(), data.end());
+    GPSBatch batch;
+    start = std::chrono::high_resolution_clock::now();
+    NMEAParser::parseBatch(views.data(), views.size(), batch);
+    end = std::chrono::high_resolution_clock::now();
+    diff = end - start;
+
+    std::cout << "Batch parsed " << batch.validCount() << " lines in: " << diff.count() << " seconds" << std::endl;
+    std::cout << "Batch throughput: " << (1000000 / diff.count()) << " msg/sec" << std::endl;
+
     return 0;
 }
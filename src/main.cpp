@@ -1,26 +1,33 @@
+#include <charconv>
 #include <csignal>
+#include <cstdlib>
+#include <cerrno>
+#include <sys/stat.h>
 #include <iostream>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <string>
+#include <vector>
 
 // --- INCLUDE ORDER MATTERS FOR MACROS ---
 #include "JSONUtils.h"
 #include "WebServer.h"
 #include "NMEAParser.h"
 #include "NMEASource.h"
-#include "SafeQueue.h"
+#include "UDPBatchSource.h"
+#include "BufferedSerialSource.h"
+#include "ReplaySource.h"
+#include "NMEAReactor.h"
+#include "ParserPool.h"
+#include "NMEARelay.h"
+#include "CaptureRecorder.h"
 #include "SQLiteLogger.h"
+#include "TrackColumnStore.h"
 #include "GPSDashboard.h" // NCurses last to avoid "OK" conflict
 
-struct RawPacket {
-    std::string sourceID;
-    std::string nmeaString;
-};
-
 // 1. Global handles for cleanup
 std::atomic<bool> running(true);
-SafeQueue<RawPacket> buffer;
 
 // 2. Minimalist Signal Handler (no global source)
 void signalHandler(int signum) {
@@ -28,62 +35,241 @@ void signalHandler(int signum) {
     running = false;
 }
 
-void gpsReaderTask(std::string id,INMEASource* source, SafeQueue<RawPacket>& queue) {
-    // Producer is silent (no cout) to protect TUI
-    while (running) {
-        std::string line = source->readLine();
-        if (!line.empty()) {
-            // Wrap the data with the ID
-            queue.push({ id, line });
-        } else {
-            //Read Failure (e.g., source closed)
-            break;
-        }
-    }
+// Whole-string integer in [lo, hi]: no signs, junk or overflow slipping through as atoi would
+bool parseInt(const std::string& text, long lo, long hi, long& out) {
+    const char* end = text.data() + text.size();
+    auto res = std::from_chars(text.data(), end, out);
+    return !text.empty() && res.ec == std::errc() && res.ptr == end && out >= lo && out <= hi;
 }
 
-void dataProcessorTask(NMEAParser* parser, SafeQueue<RawPacket>& queue) {
-    RawPacket packet;
-    while (running) {
-        if (!queue.waitAndPop(packet)) break; 
+void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] [[name=]source ...]\n"
+              << "Sources: udp:PORT | serial:DEVICE[@BAUD] | tcp:HOST:PORT | replay:FILE[@SPEED|@max]\n"
+              << "Options: --relay-tcp=PORT --relay-udp=HOST:PORT --relay-dedup-ms=N --capture=DIR[@zlib]\n"
+              << "         --db-dir=DIR --db-partition=hourly|daily --db-retention-days=N --db-compact-days=N\n"
+              << "         --db-backend=columnar --ws-tick-ms=N --ws-max-inflight=N --ws-budget-kb=N --web-root=DIR" << std::endl;
+}
 
-        GPSData data = parser->parse(packet.nmeaString);
-        data.ID = packet.sourceID;
+// Source spec: [name=]udp:PORT | [name=]serial:DEVICE[@BAUD] | [name=]tcp:HOST:PORT
+//              [name=]replay:FILE[@SPEED|@max]
+// Returns nullptr (and says why) if the spec is malformed
+std::unique_ptr<IPollableSource> makeSource(const std::string& spec) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) {
+        std::cerr << "Bad source spec: " << spec << std::endl;
+        return nullptr;
+    }
+    std::string kind = spec.substr(0, colon);
+    std::string arg = spec.substr(colon + 1);
+    long port = 0;
 
-        // Trigger observers (DB, Web, TUI)
-        parser->notifyListeners(data);
+    if (kind == "udp") {
+        if (parseInt(arg, 1, 65535, port)) return std::make_unique<UDPBatchSource>(static_cast<int>(port));
+    }
+    if (kind == "serial") {
+        size_t at = arg.find('@'); // Baud defaults to NMEA's 4800
+        long baud = 4800;
+        if (at == std::string::npos || parseInt(arg.substr(at + 1), 1, 4000000, baud)) {
+            return std::make_unique<BufferedSerialSource>(arg.substr(0, at), static_cast<int>(baud));
+        }
+    }
+    if (kind == "replay") {
+        // Recorded log: original timing, N x faster, or flat out
+        size_t at = arg.rfind('@');
+        ReplaySource::Config cfg;
+        cfg.path = arg.substr(0, at);
+        bool ok = true;
+        if (at != std::string::npos) {
+            std::string speed = arg.substr(at + 1);
+            cfg.pacing = (speed == "max") ? ReplaySource::Pacing::MaxSpeed : ReplaySource::Pacing::Scaled;
+            if (speed != "max") {
+                char* end = nullptr;
+                cfg.speed = std::strtod(speed.c_str(), &end);
+                ok = !speed.empty() && *end == '\0' && cfg.speed > 0.0;
+            }
+        }
+        if (ok) return std::make_unique<ReplaySource>(cfg);
     }
+    if (kind == "tcp") {
+        size_t portSep = arg.rfind(':');
+        if (portSep != std::string::npos && parseInt(arg.substr(portSep + 1), 1, 65535, port)) {
+            return std::make_unique<TCPSource>(arg.substr(0, portSep), static_cast<int>(port));
+        }
+    }
+    std::cerr << "Bad source spec: " << spec << std::endl;
+    return nullptr;
 }
 
-int main() {
+int main(int argc, char** argv) {
     // Register Signals
     std::signal(SIGINT, signalHandler); 
     std::signal(SIGTERM, signalHandler);
 
-    NMEAParser parser;
+    NMEAParser parser; // Event bus: observers subscribe here
+
+    // Parser workers, sharded by source. Each lane decodes and fuses GGA + RMC of the
+    // same epoch into one fix, then publishes it through the parser's listeners.
+    ParserPool::Config poolConfig;
+    poolConfig.workers = std::max(1u, std::thread::hardware_concurrency() / 2);
+    poolConfig.workStealing = true; // Let idle workers pick up sources from a busy one
+    poolConfig.fusionTimeout = std::chrono::milliseconds(200);
+    poolConfig.overflow = OverflowPolicy::DropOldest; // Live feed: a stale fix is worth less than a fresh one
+    ParserPool pool(poolConfig);
+    pool.onFix([&parser](const GPSData& d) { parser.notifyListeners(d); });
 
     // -----------------------------------------------------
     // CONFIGURATION PHASE (Standard Terminal)
     // -----------------------------------------------------
     std::cout << "=== NMEA ENGINE SETUP ===" << std::endl;
-    auto source1 = std::make_unique<UDPSource>(10110); // Source 2: A secondary UDP stream (A Drone Boat)
-    auto source2 = std::make_unique<UDPSource>(10111); // Different port!
+    // Sources come from the command line; without any, listen on the two classic UDP ports.
+    // Relay options: --relay-tcp=PORT, --relay-udp=HOST:PORT (repeatable), --relay-dedup-ms=N
+    // Capture: --capture=DIR[@zlib]
+    // Track database: --db-dir=DIR (default: voyage_data.db here, or ./tracks for columnar)
+    //                 --db-partition=hourly|daily, --db-retention-days=N, --db-compact-days=N (SQLite only)
+    //                 --db-backend=columnar (compact per-vessel column blocks instead of SQLite)
+    // Web feed: --ws-tick-ms=N (coalescing period), --ws-max-inflight=N (unacknowledged frames per {"flow":"ack"} client)
+    //           --ws-budget-kb=N (KiB/s per client without acks, 0 = unbounded)
+    // Dashboard: --web-root=DIR (built frontend; default: next to the binary, then ../frontend/dist)
+    std::vector<std::string> specs;
+    NMEARelay::Config relayConfig;
+    CaptureRecorder::Config captureConfig;
+    SQLiteLogger::Config dbConfig;
+    WebFeed::Config feedConfig;
+    std::string webRoot;
+    std::string dbDir;
+    bool columnar = false;
+    bool sqliteOnly = false; // Partitioning/retention/compaction given: the column store has none
+    captureConfig.directory.clear();
+    bool badArgs = false;
+    // Value of --name=N, which must be an integer in [lo, hi]
+    auto intArg = [&badArgs](const std::string& arg, long lo, long hi) {
+        long v = 0;
+        if (!parseInt(arg.substr(arg.find('=') + 1), lo, hi, v)) {
+            std::cerr << "Bad value in " << arg << " (expected " << lo << ".." << hi << ")" << std::endl;
+            badArgs = true;
+        }
+        return v;
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--relay-tcp=", 0) == 0) relayConfig.tcpPort = static_cast<int>(intArg(arg, 0, 65535));
+        else if (arg.rfind("--relay-udp=", 0) == 0) relayConfig.udpTargets.push_back(arg.substr(12));
+        else if (arg.rfind("--relay-dedup-ms=", 0) == 0) relayConfig.dedupWindow = std::chrono::milliseconds(intArg(arg, 0, 3600000));
+        else if (arg.rfind("--capture=", 0) == 0) {
+            std::string dir = arg.substr(10);
+            size_t at = dir.rfind('@');
+            if (at != std::string::npos && dir.substr(at + 1) == "zlib") captureConfig.codec = CaptureFormat::Codec::Zlib;
+            captureConfig.directory = dir.substr(0, at);
+        }
+        else if (arg == "--db-backend=columnar") columnar = true;
+        else if (arg.rfind("--db-dir=", 0) == 0) dbDir = arg.substr(9);
+        else if (arg == "--db-partition=hourly" || arg == "--db-partition=daily") {
+            dbConfig.partitioning = arg == "--db-partition=daily" ? Partitioning::Daily : Partitioning::Hourly;
+            sqliteOnly = true;
+        }
+        else if (arg.rfind("--db-retention-days=", 0) == 0) {
+            dbConfig.retention = std::chrono::hours(24 * intArg(arg, 0, 36500));
+            sqliteOnly = true;
+        }
+        else if (arg.rfind("--db-compact-days=", 0) == 0) {
+            dbConfig.compactAfter = std::chrono::hours(24 * intArg(arg, 0, 36500));
+            sqliteOnly = true;
+        }
+        else if (arg.rfind("--ws-tick-ms=", 0) == 0) feedConfig.tick = std::chrono::milliseconds(intArg(arg, 1, 60000));
+        else if (arg.rfind("--ws-max-inflight=", 0) == 0) feedConfig.maxInFlight = static_cast<size_t>(intArg(arg, 1, 4096));
+        else if (arg.rfind("--ws-budget-kb=", 0) == 0) feedConfig.maxBytesPerSec = static_cast<size_t>(intArg(arg, 0, 1048576)) * 1024;
+        else if (arg.rfind("--web-root=", 0) == 0) webRoot = arg.substr(11);
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option " << arg << std::endl;
+            badArgs = true;
+        }
+        else specs.push_back(arg);
+    }
+    if (columnar && sqliteOnly) {
+        std::cerr << "--db-partition, --db-retention-days and --db-compact-days need the SQLite backend" << std::endl;
+        badArgs = true;
+    }
+    if (badArgs) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (specs.empty()) specs = {"Alpha=udp:10110", "Bravo=udp:10111"};
+
+    // Raw output stage: validated sentences out to plotters/autopilots (idle without clients)
+    bool relayEnabled = relayConfig.tcpPort >= 0 || !relayConfig.udpTargets.empty();
+    NMEARelay relay(relayConfig);
+    if (relayEnabled && !relay.start()) {
+        std::cerr << "Failed to start relay" << std::endl;
+        return -1;
+    }
 
-    if (!source1->open() || !source2->open()) {
-        std::cerr << "Failed to open UDP ports!" << std::endl;
+    // Raw capture: every chunk as received, written from its own thread
+    bool captureEnabled = !captureConfig.directory.empty();
+    CaptureRecorder recorder(captureConfig);
+    if (captureEnabled && !recorder.start()) {
+        std::cerr << "Failed to start capture in " << captureConfig.directory << std::endl;
         return -1;
     }
 
-    SQLiteLogger dbLogger("voyage_data.db");
-    WebServer webServer;
+    // All sources share a few reactor threads: thread count follows cores, not receivers
+    NMEAReactor::Config reactorConfig;
+    reactorConfig.threads = std::max(1u, std::min(2u, std::thread::hardware_concurrency() / 2));
+    NMEAReactor reactor(reactorConfig);
+    if (captureEnabled) {
+        reactor.onRaw([&recorder](const std::string& id, uint64_t receivedNs, std::string_view bytes) {
+            recorder.record(id, receivedNs, bytes);
+        });
+    }
+
+    for (const auto& spec : specs) {
+        size_t eq = spec.find('=');
+        std::string id = (eq == std::string::npos) ? spec : spec.substr(0, eq);
+        auto source = makeSource(eq == std::string::npos ? spec : spec.substr(eq + 1));
+        if (!source) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (!source->open()) {
+            std::cerr << "Failed to open source " << spec << std::endl;
+            return -1;
+        }
+
+        ParserPool::Lane* lane = pool.lane(id); // Resolve the shard once, not per packet
+        bool added = reactor.add(id, std::move(source), [&pool, &relay, relayEnabled, lane](std::string_view sentence) {
+            if (relayEnabled) relay.publish(lane->id, sentence);
+            pool.submit(lane, std::string(sentence));
+        });
+        if (!added) {
+            std::cerr << "Failed to add source " << spec << " to the reactor" << std::endl;
+            return -1;
+        }
+    }
+
+    std::unique_ptr<ITrackLogger> dbLogger;
+    if (columnar) {
+        TrackColumnStore::Config columnConfig;
+        if (!dbDir.empty()) columnConfig.directory = dbDir;
+        dbLogger = std::make_unique<TrackColumnStore>(columnConfig);
+    } else {
+        // SQLite does not create directories: the column store makes its own
+        if (!dbDir.empty()) {
+            if (::mkdir(dbDir.c_str(), 0755) != 0 && errno != EEXIST) {
+                std::cerr << "Failed to create " << dbDir << std::endl;
+                return -1;
+            }
+            dbConfig.path = dbDir + "/" + dbConfig.path;
+        }
+        dbLogger = std::make_unique<SQLiteLogger>(dbConfig);
+    }
+    WebServer webServer(feedConfig, webRoot);
 
     // Wire up Observers
     parser.onFix([&webServer](const GPSData& d) {
-        if (d.isValid) webServer.broadcast(GPSDataToJson(d));
+        if (d.isValid) webServer.broadcast(d);
     });
     
     parser.onFix([&dbLogger](const GPSData& d) {
-        if (d.isValid) dbLogger.log(d);
+        if (d.isValid) dbLogger->log(d);
     });
 
     // -----------------------------------------------------
@@ -98,11 +284,8 @@ int main() {
         });
 
         // Launch Threads
-        // std::thread producer(gpsReaderTask, "alpha", globalSource.get(), std::ref(buffer));
-        // Launch TWO Producers
-        std::thread t1(gpsReaderTask, "Alpha", source1.get(), std::ref(buffer));
-        std::thread t2(gpsReaderTask, "Bravo", source2.get(), std::ref(buffer));
-        std::thread consumer(dataProcessorTask, &parser, std::ref(buffer));
+        pool.start(); // Observers are wired, workers may publish from here on
+        reactor.start();
         std::thread webThread([&webServer](){ webServer.run(); });
 
     
@@ -119,18 +302,17 @@ int main() {
         // --- CLEANUP SEQUENCE ---
         // We join threads HERE while TUI is still active (or just blank)
         // so we don't print "Joined" on top of the dashboard.
-                // 1. Wake up Consumers
-        buffer.shutdown(); 
-
-        // 2. Wake up Producers (CRITICAL FIX)
-        // Closing the socket forces recvfrom() to return error, 
-        // allowing t1 and t2 to exit their while loops.
-        source1->close();
-        source2->close();
-        // 3. Join Threads
-        if (t1.joinable()) t1.join();
-        if (t2.joinable()) t2.join();
-        if (consumer.joinable()) consumer.join();
+        // 1. Stop the Reactor
+        // Its threads wake on an eventfd, so no socket is closed under a blocked reader.
+        reactor.stop();
+        relay.stop(); // No more input: close relay clients
+        recorder.stop(); // Writes the last partial block
+
+        // 2. Stop Parser Workers
+        // Drains what the producers queued and flushes pending epochs
+        // while the dashboard observer is still alive.
+        pool.stop();
+        dbLogger->stop(); // Commits the last group
 
         // WebServer is tricky to stop cleanly without internal support, 
         // but detaching allows us to exit main.
@@ -14,7 +14,7 @@ void producer() {
 
 void consumer(int& sum) {
     for (int i = 0; i < NUM_ITEMS; ++i) {
-        int val;
+        int val = 0;
         q.waitAndPop(val);
         sum += val;
     }
@@ -0,0 +1,56 @@
+#pragma once
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Test scratch directory under /tmp, removed with everything in it when the test ends.
+// Databases (with their -wal/-shm files), capture segments and dashboard trees all live
+// inside one, so nothing needs its own cleanup.
+struct TempDir {
+    std::string path;
+
+    explicit TempDir(const char* tag = "nmea") {
+        std::string name = std::string("/tmp/") + tag + "_testXXXXXX";
+        path = mkdtemp(&name[0]);
+    }
+    ~TempDir() { removeTree(path); }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    // Path of 'rel' inside the directory (nothing is created)
+    std::string file(const std::string& rel) const { return path + "/" + rel; }
+
+    // Writes 'contents' to 'rel' (parent directories must exist, see mkdir()); returns its path
+    std::string write(const std::string& rel, const std::string& contents) const {
+        std::string p = file(rel);
+        std::ofstream(p, std::ios::binary | std::ios::trunc) << contents;
+        return p;
+    }
+
+    std::string mkdir(const std::string& rel) const {
+        std::string p = file(rel);
+        ::mkdir(p.c_str(), 0755);
+        return p;
+    }
+
+private:
+    static void removeTree(const std::string& dir) {
+        if (DIR* d = opendir(dir.c_str())) {
+            while (dirent* e = readdir(d)) {
+                std::string name = e->d_name;
+                if (name == "." || name == "..") continue;
+                std::string p = dir + "/" + name;
+                struct stat st {};
+                if (lstat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) removeTree(p);
+                else std::remove(p.c_str());
+            }
+            closedir(d);
+        }
+        rmdir(dir.c_str());
+    }
+};
@@ -0,0 +1,96 @@
+// Broadcast serialization benchmark: nlohmann DOM (GPSDataToJson) vs FixJson.
+// Usage: bench_json [fixes]   (default 1000000)
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "FixJson.h"
+#include "JSONUtils.h"
+
+// Count heap allocations made by the code under test
+static std::atomic<uint64_t> allocations{0};
+
+// noinline: keeps GCC from pairing the inlined malloc/free with new/delete (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+std::vector<GPSData> makeFleet(int count) {
+    std::vector<GPSData> fixes(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        GPSData& d = fixes[static_cast<size_t>(i)];
+        d.ID = "Vessel" + std::to_string(i % 200);
+        d.type = "GNRMC";
+        d.isValid = true;
+        d.latitude = 48.1173 + i * 1.3e-6;
+        d.longitude = 11.516666 - i * 7.1e-7;
+        d.speed = 5.0 + (i % 97) * 0.13;
+        d.course = (i % 3600) * 0.1;
+        d.altitude = 12.5;
+        d.satellites = 8 + i % 5;
+        d.timestamp = 43200.0 + i * 0.1;
+    }
+    return fixes;
+}
+
+template <typename Fn>
+void run(const char* name, const std::vector<GPSData>& fixes, Fn&& serialize) {
+    size_t bytes = 0;
+    serialize(fixes[0], bytes); // Warm-up (thread-local buffer)
+    uint64_t allocs0 = allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (const auto& d : fixes) serialize(d, bytes);
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double allocsPerFix = double(allocations.load() - allocs0) / fixes.size();
+    std::printf("%-22s %8.0f ns/fix  %6.2f allocs/fix  %5.1f MB/s\n", name, s * 1e9 / fixes.size(), allocsPerFix,
+                bytes / s / 1e6);
+}
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    auto fixes = makeFleet(count);
+
+    run("GPSDataToJson", fixes, [](const GPSData& d, size_t& bytes) { bytes += GPSDataToJson(d).size(); });
+    run("FixJson::write", fixes, [](const GPSData& d, size_t& bytes) { bytes += FixJson::write(d).size(); });
+
+    // Batch form: 200 fixes per frame, as one feed tick would send them
+    const size_t batch = 200;
+    std::string frame;
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t allocs0 = allocations.load();
+    size_t frames = 0;
+    for (size_t i = 0; i + batch <= fixes.size(); i += batch, ++frames) {
+        frame.clear();
+        frame.push_back('[');
+        for (size_t j = i; j < i + batch; ++j) {
+            if (j > i) frame.push_back(',');
+            frame += GPSDataToJson(fixes[j]);
+        }
+        frame.push_back(']');
+    }
+    double dom = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t domAllocs = allocations.load() - allocs0;
+
+    t0 = std::chrono::steady_clock::now();
+    allocs0 = allocations.load();
+    for (size_t i = 0; i + batch <= fixes.size(); i += batch) FixJson::writeArray(&fixes[i], batch);
+    double fast = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t fastAllocs = allocations.load() - allocs0;
+
+    if (frames > 0) {
+        std::printf("%-22s %8.1f us/frame %6.1f allocs/frame\n", "batch (DOM)", dom * 1e6 / frames,
+                    double(domAllocs) / frames);
+        std::printf("%-22s %8.1f us/frame %6.1f allocs/frame\n", "batch (writeArray)", fast * 1e6 / frames,
+                    double(fastAllocs) / frames);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Persistence benchmark: the same synthetic 10 Hz fleet through both ITrackLogger backends.
+// Usage: bench_logger [vessels] [seconds]   (defaults: 20 vessels, 600 s -> 120k fixes)
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "SQLiteLogger.h"
+#include "TrackColumnStore.h"
+#include "TrackSchema.h"
+
+namespace {
+uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+uint64_t directorySize(const std::string& dir) {
+    uint64_t total = 0;
+    if (DIR* d = opendir(dir.c_str())) {
+        while (dirent* e = readdir(d)) {
+            if (e->d_name[0] != '.') total += fileSize(dir + "/" + e->d_name);
+        }
+        closedir(d);
+    }
+    return total;
+}
+
+void removeDirectory(const std::string& dir) {
+    if (DIR* d = opendir(dir.c_str())) {
+        while (dirent* e = readdir(d)) {
+            if (e->d_name[0] != '.') std::remove((dir + "/" + e->d_name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(dir.c_str());
+}
+
+// Vessels steaming on slowly turning courses, one fix every 100 ms each
+void feed(ITrackLogger& logger, int vessels, int seconds) {
+    const int64_t t0 = 1700006400000;
+    for (int tick = 0; tick < seconds * 10; ++tick) {
+        for (int v = 0; v < vessels; ++v) {
+            double heading = 0.3 * v + tick * 1e-4;
+            GPSData d;
+            d.ID = "V" + std::to_string(v);
+            d.type = "GPRMC";
+            d.talker = "GP";
+            d.isValid = true;
+            d.fixQuality = 1;
+            d.satellites = 9;
+            d.latitude = 54.0 + v * 0.01 + tick * 5e-7 * std::cos(heading);
+            d.longitude = 10.0 + tick * 5e-7 * std::sin(heading);
+            d.speed = 10.0 + (tick % 7) * 0.1;
+            d.course = std::fmod(heading * 57.29578, 360.0);
+            TrackSchema::setTime(d, t0 + tick * 100);
+            logger.log(d);
+        }
+    }
+    logger.stop();
+}
+
+void run(const char* name, const std::string& dir, int vessels, int seconds,
+         const std::function<std::unique_ptr<ITrackLogger>()>& make) {
+    removeDirectory(dir);
+    mkdir(dir.c_str(), 0755);
+
+    auto logger = make();
+    auto start = std::chrono::steady_clock::now();
+    feed(*logger, vessels, seconds);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double fixes = static_cast<double>(vessels) * seconds * 10;
+    uint64_t bytes = directorySize(dir);
+    std::printf("%-10s %10.0f fixes/s %12llu bytes %8.1f bytes/fix\n", name, fixes / secs,
+                static_cast<unsigned long long>(bytes), bytes / fixes);
+    logger.reset();
+    removeDirectory(dir);
+}
+}
+
+int main(int argc, char** argv) {
+    int vessels = argc > 1 ? std::atoi(argv[1]) : 20;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 600;
+
+    run("sqlite", "/tmp/bench_sqlite", vessels, seconds, [] {
+        SQLiteLogger::Config cfg;
+        cfg.path = "/tmp/bench_sqlite/track.db";
+        cfg.queueCapacity = 1 << 20; // Measure write throughput, not drops
+        return std::make_unique<SQLiteLogger>(cfg);
+    });
+    run("columnar", "/tmp/bench_columnar", vessels, seconds, [] {
+        TrackColumnStore::Config cfg;
+        cfg.directory = "/tmp/bench_columnar";
+        cfg.queueCapacity = 1 << 20;
+        return std::make_unique<TrackColumnStore>(cfg);
+    });
+    return 0;
+}
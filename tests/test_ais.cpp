@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "AISDecoder.h"
+#include "NMEAParser.h"
+
+// Reference values cross-checked against an independent bit-level decoder
+namespace {
+const char* TYPE1 = "!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C";
+const char* TYPE18 = "!AIVDM,1,1,,B,B5NJ;PP005l4ot5Isbl03wsUkP06,0*75";
+const char* TYPE19 = "!AIVDM,1,1,,B,C5N3SRgPEnJGEBT>NhWAwwo862PaLELTBJ:V00000000S0D:R220,0*0B";
+const char* TYPE5_1 = "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C";
+const char* TYPE5_2 = "!AIVDM,2,2,1,A,88888888880,2*25";
+const char* TYPE24A = "!AIVDM,1,1,,A,H42O55i18tMET00000000000000,2*6D";
+const char* TYPE24B = "!AIVDM,1,1,,A,H42O55lti4hhhilD3nink000?050,0*40";
+}
+
+class AISTest : public ::testing::Test {
+protected:
+    AISDecoder decoder;
+    const AISVessel* vessel = nullptr;
+
+    AISDecoder::Update feed(const char* sentence, uint64_t nowMs = 1000) {
+        return decoder.decodeSentence(sentence, nowMs, vessel);
+    }
+};
+
+// 1. Armor Tests
+TEST_F(AISTest, ArmorTableCoversBothRanges) {
+    EXPECT_EQ(AISDecoder::armorValue('0'), 0);
+    EXPECT_EQ(AISDecoder::armorValue('W'), 39);
+    EXPECT_EQ(AISDecoder::armorValue('`'), 40);
+    EXPECT_EQ(AISDecoder::armorValue('w'), 63);
+    EXPECT_EQ(AISDecoder::armorValue('X'), 0xFF);
+    EXPECT_EQ(AISDecoder::armorValue('x'), 0xFF);
+}
+
+// 2. Position Report Tests
+TEST_F(AISTest, DecodesClassAPosition) {
+    ASSERT_EQ(feed(TYPE1), AISDecoder::Update::Position);
+    ASSERT_NE(vessel, nullptr);
+    EXPECT_EQ(vessel->mmsi, 366053209u);
+    EXPECT_EQ(vessel->positionClass, 'A');
+    EXPECT_EQ(vessel->navStatus, 3);
+    EXPECT_EQ(vessel->latitudeE7, 378021183);   // 37.8021183
+    EXPECT_EQ(vessel->longitudeE7, -1223416183); // -122.3416183
+    EXPECT_DOUBLE_EQ(vessel->speed, 0.0);
+    EXPECT_DOUBLE_EQ(vessel->course, 219.3);
+    EXPECT_EQ(vessel->heading, 1);
+}
+
+TEST_F(AISTest, DecodesClassBPositions) {
+    ASSERT_EQ(feed(TYPE18), AISDecoder::Update::Position);
+    EXPECT_EQ(vessel->mmsi, 367430530u);
+    EXPECT_EQ(vessel->positionClass, 'B');
+    EXPECT_EQ(vessel->heading, 511);
+    EXPECT_EQ(vessel->latitudeE7, 377850350);
+
+    ASSERT_EQ(feed(TYPE19), AISDecoder::Update::Position);
+    EXPECT_EQ(vessel->mmsi, 367059850u);
+    EXPECT_DOUBLE_EQ(vessel->speed, 8.7);
+    EXPECT_DOUBLE_EQ(vessel->course, 335.9);
+    EXPECT_STREQ(vessel->name, "CAPT.J.RIMES");
+    EXPECT_EQ(vessel->shipType, 70);
+    EXPECT_EQ(vessel->toStern, 21);
+}
+
+// 3. Static Data and Reassembly Tests
+TEST_F(AISTest, ReassemblesTwoFragmentStaticReport) {
+    EXPECT_EQ(feed(TYPE5_1), AISDecoder::Update::None); // Waiting for fragment 2
+    EXPECT_EQ(vessel, nullptr);
+
+    ASSERT_EQ(feed(TYPE5_2), AISDecoder::Update::Static);
+    EXPECT_EQ(vessel->mmsi, 351759000u);
+    EXPECT_EQ(vessel->imo, 9134270u);
+    EXPECT_STREQ(vessel->callsign, "3FOF8");
+    EXPECT_STREQ(vessel->name, "EVER DIADEM");
+    EXPECT_STREQ(vessel->destination, "NEW YORK");
+    EXPECT_EQ(vessel->shipType, 70);
+    EXPECT_EQ(vessel->toBow, 225);
+    EXPECT_EQ(vessel->toStarboard, 31);
+    EXPECT_DOUBLE_EQ(vessel->draught, 12.2);
+}
+
+TEST_F(AISTest, MergesType24PartsIntoOneRecord) {
+    ASSERT_EQ(feed(TYPE24A), AISDecoder::Update::Static);
+    ASSERT_EQ(feed(TYPE24B), AISDecoder::Update::Static);
+
+    const AISVessel* v = decoder.find(271041815);
+    ASSERT_NE(v, nullptr);
+    EXPECT_STREQ(v->name, "PROGUY");
+    EXPECT_STREQ(v->callsign, "TC6163");
+    EXPECT_EQ(v->shipType, 60);
+    EXPECT_EQ(v->toStern, 15);
+    EXPECT_EQ(decoder.vessels().size(), 1u);
+}
+
+TEST_F(AISTest, DropsOutOfOrderAndExpiredFragments) {
+    // Second fragment without the first
+    EXPECT_EQ(feed(TYPE5_2), AISDecoder::Update::None);
+    EXPECT_EQ(decoder.stats().fragmentsDropped, 1u);
+
+    // First fragment, then the second arrives after the timeout
+    feed(TYPE5_1, 1000);
+    EXPECT_EQ(feed(TYPE5_2, 1000 + AISDecoder::DEFAULT_TIMEOUT_MS + 1), AISDecoder::Update::None);
+    EXPECT_EQ(decoder.stats().timeouts, 1u);
+    EXPECT_EQ(decoder.find(351759000), nullptr);
+}
+
+TEST_F(AISTest, PendingSlotsAreBounded) {
+    // More concurrent partial messages than slots: oldest get evicted, never grows
+    for (int i = 0; i < 40; ++i) {
+        decoder.decodeFragment("2", "1", std::to_string(i % 10), (i / 10) % 2 ? "A" : "B",
+                               "55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8", "0",
+                               1000 + i, vessel);
+    }
+    EXPECT_EQ(decoder.stats().fragmentsDropped, 40u - AISDecoder::MAX_PENDING);
+}
+
+TEST_F(AISTest, RejectsBadArmorAndEnvelope) {
+    EXPECT_EQ(decoder.decodeFragment("1", "1", "", "A", "15M67FC000G?ufbE`FepT@3n00S~", "0", 0, vessel),
+              AISDecoder::Update::None);
+    EXPECT_EQ(decoder.decodeFragment("1", "2", "", "A", "15M67FC000G?ufbE`FepT@3n00Sa", "0", 0, vessel),
+              AISDecoder::Update::None);
+    EXPECT_EQ(decoder.stats().errors, 2u);
+}
+
+// 4. Parser Integration
+TEST_F(AISTest, ParserEmitsAISPositionsAsFixes) {
+    NMEAParser parser;
+    GPSData data = parser.parse(TYPE1);
+
+    EXPECT_TRUE(data.isValid);
+    EXPECT_EQ(data.type, "AIVDM");
+    EXPECT_EQ(data.talker, "AI");
+    EXPECT_EQ(data.ID, "366053209");
+    EXPECT_NEAR(data.latitude, 37.8021183, 1e-7);
+    EXPECT_NEAR(data.longitude, -122.3416183, 1e-7);
+
+    // Static data updates the vessel table but is not a fix
+    EXPECT_FALSE(parser.parse(TYPE24A).isValid);
+    EXPECT_NE(parser.ais().find(271041815), nullptr);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "StaticAssets.h"
+#include "TempDir.h"
+#ifdef NMEA_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef NMEA_HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+
+namespace {
+std::string bigScript() {
+    std::string js;
+    for (int i = 0; i < 400; ++i) js += "export const vessel" + std::to_string(i) + " = { lat: 48.1, lon: 11.5 };\n";
+    return js;
+}
+}
+
+TEST(StaticAssetsTest, LoadsOnceAndServesWithCachingHeaders) {
+    TempDir dist("assets"); // A miniature frontend/dist
+    dist.mkdir("assets");
+    dist.write("index.html", "<!doctype html><div id=root></div>");
+    dist.write("assets/index-B3xk9_aZ.js", bigScript());
+    dist.write("assets/logo-C0ffee12.png", std::string("\x89PNG\r\n\x1a\n", 8) + std::string(64, '\x01'));
+    dist.write(".hidden", "secret");
+
+    StaticAssets assets;
+    ASSERT_EQ(assets.load(dist.path), 3u);
+    EXPECT_EQ(assets.find("/.hidden"), nullptr);
+    EXPECT_EQ(assets.find("/"), assets.find("/index.html"));
+
+    // 1. MIME and cache policy: the entry page revalidates, hashed bundles are immutable
+    const StaticAssets::Asset* index = assets.find("/index.html");
+    const StaticAssets::Asset* js = assets.find("/assets/index-B3xk9_aZ.js");
+    const StaticAssets::Asset* png = assets.find("/assets/logo-C0ffee12.png");
+    ASSERT_TRUE(index && js && png);
+    EXPECT_EQ(index->mime, "text/html; charset=utf-8");
+    EXPECT_EQ(js->mime, "application/javascript; charset=utf-8");
+    EXPECT_EQ(png->mime, "image/png");
+    EXPECT_EQ(index->cacheControl, "no-cache");
+    EXPECT_EQ(js->cacheControl, "public, max-age=31536000, immutable");
+    EXPECT_TRUE(png->gzip.empty() && png->brotli.empty()); // Not compressible
+
+    // 2. Changing the file changes the ETag once reloaded
+    std::string oldTag = index->etag;
+    dist.write("index.html", "<!doctype html><div id=app></div>");
+    assets.load(dist.path);
+    EXPECT_NE(assets.find("/index.html")->etag, oldTag);
+
+    // 3. Conditional requests
+    js = assets.find("/assets/index-B3xk9_aZ.js");
+    EXPECT_EQ(assets.serve("/assets/index-B3xk9_aZ.js", "", js->etag).status, 304);
+    EXPECT_EQ(assets.serve("/assets/index-B3xk9_aZ.js", "", "\"stale\", W/" + js->etag).status, 304);
+    EXPECT_EQ(assets.serve("/assets/index-B3xk9_aZ.js", "", "\"stale\"").status, 200);
+    EXPECT_EQ(assets.serve("/assets/missing.js", "gzip", "").status, 404);
+}
+
+TEST(StaticAssetsTest, PicksTheBestAcceptedEncoding) {
+    TempDir dist("assets"); // A miniature frontend/dist
+    dist.mkdir("assets");
+    const std::string script = bigScript();
+    dist.write("assets/index-B3xk9_aZ.js", script);
+    StaticAssets assets;
+    ASSERT_EQ(assets.load(dist.path), 1u);
+    const std::string path = "/assets/index-B3xk9_aZ.js";
+
+    StaticAssets::Reply plain = assets.serve(path, "", "");
+    EXPECT_EQ(plain.status, 200);
+    EXPECT_EQ(plain.encoding, nullptr);
+    EXPECT_EQ(*plain.body, script);
+    EXPECT_EQ(*plain.etag, plain.asset->etag);
+    EXPECT_EQ(assets.serve(path, "gzip;q=0, br;q=0", "").encoding, nullptr);
+
+#ifdef NMEA_HAVE_ZLIB
+    StaticAssets::Reply gz = assets.serve(path, "gzip, deflate", "");
+    ASSERT_STREQ(gz.encoding, "gzip");
+    EXPECT_LT(gz.body->size(), script.size() / 4);
+
+    // Each variant has its own tag, and any of them revalidates the content
+    const std::string& gzTag = *gz.etag;
+    EXPECT_NE(gzTag, plain.asset->etag);
+    EXPECT_EQ(gzTag.substr(gzTag.size() - 4), "-gz\"");
+    StaticAssets::Reply again = assets.serve(path, "gzip", "W/" + gzTag);
+    EXPECT_EQ(again.status, 304);
+    EXPECT_EQ(*again.etag, gzTag);
+    StaticAssets::Reply other = assets.serve(path, "", gzTag); // Now asking for identity
+    EXPECT_EQ(other.status, 304);
+    EXPECT_EQ(*other.etag, plain.asset->etag);
+
+    std::string out(script.size() + 1, '\0');
+    z_stream zs{};
+    ASSERT_EQ(inflateInit2(&zs, 16 + MAX_WBITS), Z_OK);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(gz.body->data()));
+    zs.avail_in = static_cast<uInt>(gz.body->size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    EXPECT_EQ(inflate(&zs, Z_FINISH), Z_STREAM_END);
+    out.resize(zs.total_out);
+    inflateEnd(&zs);
+    EXPECT_EQ(out, script);
+#endif
+
+#ifdef NMEA_HAVE_BROTLI
+    StaticAssets::Reply br = assets.serve(path, "gzip, deflate, br", "");
+    ASSERT_STREQ(br.encoding, "br");
+    EXPECT_EQ(*br.etag, br.asset->brotliETag);
+    EXPECT_NE(br.asset->brotliETag, br.asset->gzipETag);
+    EXPECT_EQ(assets.serve(path, "br", br.asset->brotliETag).status, 304);
+    EXPECT_STREQ(assets.serve(path, "br;q=0, *", "").encoding, "gzip"); // Explicit refusal beats the wildcard
+
+    std::string decoded(script.size() + 1, '\0');
+    size_t size = decoded.size();
+    ASSERT_EQ(BrotliDecoderDecompress(br.body->size(), reinterpret_cast<const uint8_t*>(br.body->data()), &size,
+                                      reinterpret_cast<uint8_t*>(&decoded[0])),
+              BROTLI_DECODER_RESULT_SUCCESS);
+    decoded.resize(size);
+    EXPECT_EQ(decoded, script);
+#endif
+}
+
+TEST(StaticAssetsTest, MimeTypesAndHashedNames) {
+    EXPECT_EQ(StaticAssets::mimeType("app.CSS"), "text/css; charset=utf-8");
+    EXPECT_EQ(StaticAssets::mimeType("font.woff2"), "font/woff2");
+    EXPECT_EQ(StaticAssets::mimeType("a.json.gz"), "application/octet-stream");
+    EXPECT_EQ(StaticAssets::mimeType("README"), "application/octet-stream");
+
+    EXPECT_TRUE(StaticAssets::isHashedName("index-B3xk9_aZ.js"));
+    EXPECT_TRUE(StaticAssets::isHashedName("vendor-react-DLmWn8Qz.js"));
+    EXPECT_FALSE(StaticAssets::isHashedName("index.js"));
+    EXPECT_FALSE(StaticAssets::isHashedName("index-abc.js"));
+}
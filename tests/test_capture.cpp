@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "CaptureRecorder.h"
+#include "TempDir.h"
+
+namespace {
+std::string sentence(int i) {
+    return "$GPGGA,1200" + std::to_string(10 + i % 50) + ".00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+}
+
+const uint64_t T0 = 1700000000000000000ull;
+
+// Records 'count' packets 1 ms apart, alternating two sources
+void recordAll(CaptureRecorder& rec, int count) {
+    for (int i = 0; i < count; ++i) rec.record(i % 2 ? "Bravo" : "Alpha", T0 + i * 1000000ull, sentence(i));
+}
+
+std::vector<RawPacket> readAll(const std::string& dir) {
+    std::vector<RawPacket> out;
+    for (const auto& seg : CaptureReader::segments(dir)) {
+        CaptureReader reader;
+        EXPECT_TRUE(reader.open(seg));
+        RawPacket p;
+        while (reader.next(p)) out.push_back(p);
+    }
+    return out;
+}
+
+void roundTrip(CaptureFormat::Codec codec) {
+    TempDir dir("capture");
+    CaptureRecorder::Config cfg;
+    cfg.directory = dir.path;
+    cfg.blockBytes = 4096;
+    cfg.segmentBytes = 2048; // Force several segments, even with compressed blocks
+    cfg.codec = codec;
+    CaptureRecorder rec(cfg);
+    ASSERT_TRUE(rec.start());
+    recordAll(rec, 2000);
+    rec.stop();
+
+    auto stats = rec.stats();
+    EXPECT_EQ(stats.packets, 2000u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_GT(stats.segments, 1u);
+    EXPECT_EQ(CaptureReader::segments(dir.path).size(), stats.segments);
+
+    auto packets = readAll(dir.path);
+    ASSERT_EQ(packets.size(), 2000u);
+    for (int i = 0; i < 2000; i += 199) {
+        EXPECT_EQ(packets[i].sourceID, i % 2 ? "Bravo" : "Alpha");
+        EXPECT_EQ(packets[i].receivedNs, T0 + i * 1000000ull);
+        EXPECT_EQ(packets[i].nmeaString, sentence(i));
+    }
+}
+}
+
+TEST(CaptureTest, RoundTripAcrossSegments) {
+    roundTrip(CaptureFormat::Codec::None);
+}
+
+TEST(CaptureTest, CompressedRoundTrip) {
+    if (!CaptureFormat::codecAvailable(CaptureFormat::Codec::Zlib)) GTEST_SKIP() << "built without zlib";
+    roundTrip(CaptureFormat::Codec::Zlib);
+}
+
+TEST(CaptureTest, SparseIndexSeeksToTimeWindow) {
+    TempDir dir("capture");
+    CaptureRecorder::Config cfg;
+    cfg.directory = dir.path;
+    cfg.blockBytes = 8192;
+    CaptureRecorder rec(cfg);
+    ASSERT_TRUE(rec.start());
+    recordAll(rec, 5000);
+    rec.stop();
+
+    auto segs = CaptureReader::segments(dir.path);
+    ASSERT_EQ(segs.size(), 1u);
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(segs[0]));
+    // One entry per block, not per packet
+    EXPECT_EQ(reader.indexEntries(), rec.stats().blocks);
+    EXPECT_LT(reader.indexEntries(), 5000u / 50);
+
+    // Packet 3210 is mid-block: seek lands at or before it, never after
+    const uint64_t target = T0 + 3210 * 1000000ull;
+    ASSERT_TRUE(reader.seek(target));
+    RawPacket p;
+    ASSERT_TRUE(reader.next(p));
+    EXPECT_LE(p.receivedNs, target);
+    EXPECT_GT(p.receivedNs + 200 * 1000000ull, target); // Within one block of it
+    while (p.receivedNs < target && reader.next(p)) {}
+    EXPECT_EQ(p.receivedNs, target);
+}
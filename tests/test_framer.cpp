@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "NMEAFramer.h"
+#include "NMEAParser.h"
+
+namespace {
+const std::string GGA = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+const std::string RMC = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A";
+}
+
+// Fixture collects every emitted sentence as an owned string
+class FramerTest : public ::testing::Test {
+protected:
+    NMEAFramer framer;
+    std::vector<std::string> out;
+
+    void feed(const std::string& chunk) {
+        framer.feed(chunk, [this](std::string_view s) { out.emplace_back(s); });
+    }
+};
+
+// 1. Chunking Tests
+TEST_F(FramerTest, SplitsMultiSentenceDatagram) {
+    feed(GGA + "\r\n" + RMC + "\r\n");
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0], GGA);
+    EXPECT_EQ(out[1], RMC);
+    EXPECT_EQ(framer.stats().framingErrors, 0u);
+}
+
+TEST_F(FramerTest, ReassemblesSentenceAcrossEveryChunkBoundary) {
+    std::string stream = GGA + "\r\n" + RMC + "\r\n";
+    for (size_t cut = 1; cut < stream.size(); ++cut) {
+        NMEAFramer f;
+        std::vector<std::string> got;
+        auto collect = [&got](std::string_view s) { got.emplace_back(s); };
+        f.feed(stream.data(), cut, collect);
+        f.feed(stream.data() + cut, stream.size() - cut, collect);
+
+        ASSERT_EQ(got.size(), 2u) << "cut at " << cut;
+        EXPECT_EQ(got[0], GGA);
+        EXPECT_EQ(got[1], RMC);
+    }
+}
+
+TEST_F(FramerTest, ByteAtATimeMatchesWholeBuffer) {
+    std::string stream = GGA + "\n" + RMC + "\n";
+    for (char c : stream) feed(std::string(1, c));
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1], RMC);
+}
+
+TEST_F(FramerTest, EmitsViewsIntoTheChunkWhenPossible) {
+    std::string chunk = GGA + "\r\n";
+    const char* seen = nullptr;
+    framer.feed(chunk, [&seen](std::string_view s) { seen = s.data(); });
+    EXPECT_EQ(seen, chunk.data());
+}
+
+TEST_F(FramerTest, EndOfMessageClosesUnterminatedSentence) {
+    feed(GGA); // Datagram without CR/LF
+    EXPECT_TRUE(out.empty());
+
+    framer.endOfMessage([this](std::string_view s) { out.emplace_back(s); });
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], GGA);
+}
+
+// 2. Resync and Error Tests
+TEST_F(FramerTest, ResyncsOnGarbageAndTruncation) {
+    // Garbage run, then a sentence cut short by the next '$'
+    feed("\x01\x02noise" + GGA.substr(0, 20) + RMC + "\r\n");
+
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], RMC);
+    EXPECT_EQ(framer.stats().framingErrors, 2u);
+    EXPECT_EQ(framer.stats().bytesDiscarded, 7u + 20u);
+}
+
+TEST_F(FramerTest, DropsOverlongSentences) {
+    std::string tooLong = "$GPXXX," + std::string(100, 'A') + "*00";
+    feed(tooLong + "\r\n" + GGA + "\r\n");
+
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], GGA);
+    EXPECT_EQ(framer.stats().framingErrors, 1u);
+
+    // An exactly-82-byte sentence (80 + CR/LF) still passes
+    out.clear();
+    feed("$" + std::string(79, 'A') + "\r\n");
+    ASSERT_EQ(out.size(), 1u);
+}
+
+TEST_F(FramerTest, RecognisesAISStartCharacter) {
+    std::string ais = "!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C";
+    feed(ais + "\r\n");
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0], ais);
+}
+
+TEST_F(FramerTest, FramedSentencesParse) {
+    NMEAParser parser;
+    int valid = 0;
+    framer.feed(GGA + "\r\n" + RMC + "\r\n", [&](std::string_view s) {
+        if (parser.parse(s).isValid) valid++;
+    });
+    EXPECT_EQ(valid, 2);
+}
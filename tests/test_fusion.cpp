@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "FixFusion.h"
+
+namespace {
+const char* GGA = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+const char* RMC = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A";
+const char* GGA_NEXT = "$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4D";
+const char* AIS = "!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C";
+}
+
+// Fixture: decode sentences for a named source and collect what fusion emits
+class FusionTest : public ::testing::Test {
+protected:
+    NMEAParser parser;
+    FixFusion fusion{std::chrono::milliseconds(100)};
+    std::vector<GPSData> out;
+    FixFusion::Clock::time_point t0 = FixFusion::Clock::now();
+
+    void SetUp() override {
+        fusion.onFix([this](const GPSData& d) { out.push_back(d); });
+    }
+
+    void feed(const char* sentence, const std::string& source, int atMs = 0) {
+        GPSData data;
+        ASSERT_TRUE(parser.decode(sentence, data));
+        if (data.ID.empty()) data.ID = source;
+        fusion.add(data, t0 + std::chrono::milliseconds(atMs));
+    }
+};
+
+// 1. Merge Tests
+TEST_F(FusionTest, MergesGGAAndRMCIntoOneFix) {
+    feed(GGA, "Alpha");
+    EXPECT_TRUE(out.empty()); // Half an epoch: wait for RMC
+
+    feed(RMC, "Alpha");
+    ASSERT_EQ(out.size(), 1u);
+    const GPSData& fix = out[0];
+    EXPECT_EQ(fix.ID, "Alpha");
+    EXPECT_EQ(fix.type, "GPGGA+GPRMC");
+    EXPECT_EQ(fix.satellites, 8);          // From GGA
+    EXPECT_NEAR(fix.altitude, 545.4, 0.01); // From GGA
+    EXPECT_NEAR(fix.speed, 22.4, 0.01);     // From RMC
+    EXPECT_NEAR(fix.course, 84.4, 0.01);    // From RMC
+    EXPECT_EQ(fix.date, "230394");
+    EXPECT_EQ(fusion.stats().complete, 1u);
+}
+
+TEST_F(FusionTest, SourcesAreFusedIndependently) {
+    feed(GGA, "Alpha");
+    feed(GGA, "Bravo");
+    feed(RMC, "Bravo");
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].ID, "Bravo");
+
+    feed(RMC, "Alpha");
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1].ID, "Alpha");
+}
+
+// 2. Emission Trigger Tests
+TEST_F(FusionTest, EmitsOnEpochRollover) {
+    feed(GGA, "Alpha");
+    feed(GGA_NEXT, "Alpha"); // No RMC for 12:35:19, and 12:35:20 has started
+
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].type, "GPGGA");
+    EXPECT_DOUBLE_EQ(out[0].timestamp, 45319.0);
+    EXPECT_EQ(fusion.stats().rollovers, 1u);
+}
+
+TEST_F(FusionTest, EmitsOnTimeout) {
+    feed(RMC, "Alpha", 0);
+    fusion.poll(t0 + std::chrono::milliseconds(50));
+    EXPECT_TRUE(out.empty());
+
+    fusion.poll(t0 + std::chrono::milliseconds(100));
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].type, "GPRMC");
+    EXPECT_EQ(out[0].fixQuality, 1); // RMC status 'A' when no GGA arrived
+    EXPECT_EQ(fusion.stats().timeouts, 1u);
+}
+
+TEST_F(FusionTest, FlushEmitsPendingAndAISPassesThrough) {
+    feed(AIS, "Alpha");
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].ID, "366053209");
+
+    feed(GGA, "Alpha");
+    fusion.flush();
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(fusion.stats().fixesOut, 2u);
+}
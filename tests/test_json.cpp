@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "JSONUtils.h"
+#include "FixJson.h"
+#include <cmath>
 #include <iostream>
 
 TEST(JSONTest, SerializesCorrectly) {
@@ -32,4 +34,44 @@ TEST(JSONTest, StringDumpWorks) {
     
     // Check if the string actually looks like JSON
     EXPECT_TRUE(output.find("\"lat\":10.0") != std::string::npos);
-}
\ No newline at end of file
+}
+// FixJson must match the DOM path byte for byte
+TEST(JSONTest, FastWriterMatchesToJson) {
+    GPSData data;
+    data.type = "GNRMC";
+    data.ID = "Alpha";
+    data.isValid = true;
+    data.latitude = 48.1173;
+    data.longitude = -11.516666666666667;
+    data.speed = 12.5;
+    data.course = 0.1 + 0.2;    // 17 significant digits
+    data.satellites = -3;
+    data.altitude = 545.4;
+    data.timestamp = 123519.0;  // Integral: "123519.0"
+    EXPECT_EQ(FixJson::write(data), GPSDataToJson(data));
+
+    // Float layout edges: tiny, huge, -0, NaN/inf (null)
+    const double values[] = {0.0, -0.0, 1e-4, 1e-5, 0.000123, 1e15, 1e16, 123456789012345678.0, 5e-324,
+                             1.7976931348623157e308, -2.5e-7, std::nan(""), -INFINITY};
+    for (double v : values) {
+        data.latitude = v;
+        data.speed = -v;
+        EXPECT_EQ(FixJson::write(data), GPSDataToJson(data)) << v;
+    }
+
+    // Escapes (UTF-8 passes through)
+    data.ID = "Q\"\\/\b\f\n\r\t\x01\x1f\x7f Köln";
+    data.type = "";
+    EXPECT_EQ(FixJson::write(data), GPSDataToJson(data));
+}
+
+TEST(JSONTest, FastWriterBatchIsAJsonArray) {
+    GPSData fixes[3];
+    for (int i = 0; i < 3; ++i) {
+        fixes[i].ID = "V" + std::to_string(i);
+        fixes[i].latitude = i * 0.1;
+    }
+    json expected = json::array({fixes[0], fixes[1], fixes[2]});
+    EXPECT_EQ(FixJson::writeArray(fixes, 3), expected.dump());
+    EXPECT_EQ(FixJson::writeArray(fixes, 0), "[]");
+}
@@ -0,0 +1,367 @@
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SQLiteLogger.h"
+#include "TrackColumnStore.h"
+#include "TrackQuery.h"
+#include "TrackSimplify.h"
+#include "TempDir.h"
+
+namespace {
+// Runs a single-value query on a fresh connection
+std::string scalar(const std::string& path, const char* sql) {
+    sqlite3* db;
+    sqlite3_open(path.c_str(), &db);
+    sqlite3_stmt* stmt;
+    std::string out;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        out = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return out;
+}
+
+GPSData fix(int i) {
+    GPSData d;
+    d.ID = "Alpha";
+    d.latitude = 48.0 + i * 1e-5;
+    d.longitude = 11.0;
+    d.isValid = true;
+    return d;
+}
+}
+
+TEST(LoggerTest, GroupCommitsRowsFromManyThreads) {
+    TempDir dir("logger");
+    const std::string dbPath = dir.file("track.db");
+    SQLiteLogger::Config cfg;
+    cfg.path = dbPath;
+    cfg.batchRows = 100;
+    cfg.batchInterval = std::chrono::seconds(10); // Only row count (and stop) may commit
+    SQLiteLogger logger(cfg);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&logger]() {
+            for (int i = 0; i < 500; ++i) logger.log(fix(i));
+        });
+    }
+    for (auto& w : workers) w.join();
+    logger.stop(); // Flushes the final partial group
+
+    auto stats = logger.stats();
+    EXPECT_EQ(stats.rows, 2000u);
+    EXPECT_EQ(stats.dropped + stats.errors, 0u);
+    EXPECT_LE(stats.commits, 21u); // ~100 rows per transaction, not one each
+    EXPECT_EQ(scalar(dbPath, "SELECT COUNT(*) FROM fixes;"), "2000");
+    EXPECT_EQ(scalar(dbPath, "PRAGMA journal_mode;"), "wal");
+}
+
+TEST(LoggerTest, TimeBoundCommitWithoutStop) {
+    TempDir dir("logger");
+    const std::string dbPath = dir.file("track.db");
+    SQLiteLogger::Config cfg;
+    cfg.path = dbPath;
+    cfg.batchInterval = std::chrono::milliseconds(20);
+    cfg.durability = SQLiteLogger::Durability::Full;
+    SQLiteLogger logger(cfg);
+
+    for (int i = 0; i < 3; ++i) logger.log(fix(i)); // Far below batchRows
+    for (int waited = 0; logger.stats().rows < 3 && waited < 200; ++waited) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(logger.stats().rows, 3u);
+    EXPECT_EQ(scalar(dbPath, "SELECT COUNT(*) FROM fixes;"), "3"); // Visible to other readers
+}
+
+namespace {
+const int64_t DAY0 = 1700006400000; // 2023-11-15 00:00:00 UTC
+
+// RMC-style fix: explicit date, so the stored time doesn't depend on the wall clock
+GPSData fixAt(const std::string& id, int64_t timeMs, double lat, double lon) {
+    GPSData d;
+    d.ID = id;
+    d.type = "GPRMC";
+    d.talker = "GP";
+    d.isValid = true;
+    d.latitude = lat;
+    d.longitude = lon;
+    d.speed = 6.5;
+    d.course = 271.0;
+    TrackSchema::setTime(d, timeMs);
+    return d;
+}
+}
+
+TEST(LoggerTest, EpochFromDateOrNearestDay) {
+    GPSData d;
+    d.timestamp = 12 * 3600 + 35 * 60 + 19.5;
+    d.date = "151123";
+    EXPECT_EQ(TrackSchema::epochMs(d, 0), DAY0 + 45319500);
+
+    // GGA alone: fix from 23:59:59 logged just after midnight belongs to the day before
+    d.date.clear();
+    d.timestamp = 86399.0;
+    EXPECT_EQ(TrackSchema::epochMs(d, DAY0 + 2000), DAY0 - 1000);
+}
+
+TEST(LoggerTest, SetTimeWritesTwoDigitYears) {
+    GPSData d;
+    TrackSchema::setTime(d, DAY0 + 45319500);
+    EXPECT_EQ(d.date, "151123");
+    EXPECT_DOUBLE_EQ(d.timestamp, 45319.5);
+
+    TrackSchema::setTime(d, 951782400000LL); // 2000-02-29: year 00
+    EXPECT_EQ(d.date, "290200");
+    EXPECT_EQ(TrackSchema::epochMs(d, 0), 951782400000LL);
+
+    // Before year 0 (proleptic): y % 100 is negative, the date must still be 6 digits
+    TrackSchema::setTime(d, -719529LL * 86400000LL); // -0001-12-31
+    EXPECT_EQ(d.date, "311299");
+}
+
+TEST(LoggerTest, MigratesLegacyDatabase) {
+    TempDir dir("logger");
+    const std::string dbPath = dir.file("track.db");
+    {
+        sqlite3* db;
+        sqlite3_open(dbPath.c_str(), &db);
+        sqlite3_exec(db, "CREATE TABLE tracklog (id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp TEXT,"
+                         " lat REAL, lon REAL, speed REAL); INSERT INTO tracklog (lat) VALUES (1.0);",
+                     nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+    }
+    SQLiteLogger logger(dbPath);
+    logger.stop();
+    EXPECT_EQ(scalar(dbPath, "PRAGMA user_version;"), std::to_string(TrackSchema::VERSION));
+    EXPECT_EQ(scalar(dbPath, "SELECT COUNT(*) FROM tracklog;"), "1"); // Old rows kept
+
+    SQLiteLogger again(dbPath); // Already current: no-op
+    again.stop();
+    EXPECT_EQ(again.stats().errors, 0u);
+}
+
+TEST(LoggerTest, QueriesTrackBoxAndLatest) {
+    TempDir dir("logger");
+    const std::string dbPath = dir.file("track.db");
+    {
+        SQLiteLogger logger(dbPath);
+        for (int i = 0; i < 100; ++i) {
+            logger.log(fixAt("Alpha", DAY0 + i * 1000, 48.0 + i * 0.001, 11.0));  // Heading north
+            logger.log(fixAt("Bravo", DAY0 + i * 1000, 54.0, 10.0 + i * 0.001));  // Heading east
+        }
+        logger.stop();
+    }
+
+    TrackQuery query(dbPath);
+    ASSERT_TRUE(query.isOpen());
+
+    // 1. Track window, full round trip of the stored fields
+    auto track = query.track("Alpha", DAY0 + 10000, DAY0 + 19000);
+    ASSERT_EQ(track.size(), 10u);
+    EXPECT_EQ(track[0].timeMs, DAY0 + 10000);
+    EXPECT_EQ(track[0].data.date, "151123");
+    EXPECT_DOUBLE_EQ(track[0].data.latitude, 48.01);
+    EXPECT_DOUBLE_EQ(track[0].data.course, 271.0);
+    EXPECT_EQ(track[0].data.type, "GPRMC");
+    EXPECT_EQ(query.track("Alpha", DAY0, DAY0 + 99000, 5).size(), 5u);
+
+    // 2. Box around Alpha's first half: only Alpha, at its newest point inside the box
+    auto box = query.inBox(47.9, 10.9, 48.0495, 11.1, DAY0, DAY0 + 99000);
+    ASSERT_EQ(box.size(), 1u);
+    EXPECT_EQ(box[0].data.ID, "Alpha");
+    EXPECT_EQ(box[0].timeMs, DAY0 + 49000);
+
+    // 3. Latest per vessel
+    auto latest = query.latest();
+    ASSERT_EQ(latest.size(), 2u);
+    EXPECT_EQ(latest[1].data.ID, "Bravo");
+    EXPECT_EQ(latest[1].timeMs, DAY0 + 99000);
+    EXPECT_DOUBLE_EQ(latest[1].data.longitude, 10.099);
+}
+
+TEST(LoggerTest, DouglasPeuckerKeepsCornersDropsNoise) {
+    // East 1 km along a line with 1 m jitter, then a right-angle turn north
+    std::vector<TrackPoint> pts;
+    for (int i = 0; i <= 100; ++i) pts.push_back({54.0 + (i % 2 ? 9e-6 : 0.0), 10.0 + i * 1.5e-4});
+    for (int i = 1; i <= 50; ++i) pts.push_back({54.0 + i * 1e-4, 10.015});
+
+    auto keep = simplifyTrack(pts, 5.0);
+    EXPECT_TRUE(keep.front());
+    EXPECT_TRUE(keep[100]); // The corner
+    EXPECT_TRUE(keep.back());
+    EXPECT_EQ(std::count(keep.begin(), keep.end(), true), 3);
+
+    auto fine = simplifyTrack(pts, 0.5); // Below the jitter: the zigzag is kept
+    EXPECT_GT(std::count(fine.begin(), fine.end(), true), 100);
+}
+
+TEST(LoggerTest, HourlyPartitionsRetentionAndCompaction) {
+    TempDir dir("logger");
+    const std::string base = dir.path + "/track.db";
+    SQLiteLogger::Config cfg;
+    cfg.path = base;
+    cfg.partitioning = Partitioning::Hourly;
+    {
+        // 3 hours, one fix a minute per vessel, each on a straight course
+        SQLiteLogger logger(cfg);
+        for (int m = 0; m < 180; ++m) {
+            logger.log(fixAt("Alpha", DAY0 + m * 60000, 48.0 + m * 1e-4, 11.0));
+            logger.log(fixAt("Bravo", DAY0 + m * 60000, 54.0, 10.0 + m * 1e-4));
+        }
+        logger.stop();
+        EXPECT_EQ(logger.stats().errors, 0u);
+    }
+    auto files = TrackPartitions::list(base, Partitioning::Hourly);
+    ASSERT_EQ(files.size(), 3u);
+    EXPECT_EQ(files[1].path, dir.path + "/track-2023111501.db");
+
+    // 1. Fan-out: one query spans all hours, in order; a narrow one touches only its hour
+    TrackQuery query(base, Partitioning::Hourly);
+    auto all = query.track("Alpha", DAY0, DAY0 + 3 * 3600000);
+    ASSERT_EQ(all.size(), 180u);
+    EXPECT_TRUE(std::is_sorted(all.begin(), all.end(),
+                               [](const auto& a, const auto& b) { return a.timeMs < b.timeMs; }));
+    EXPECT_EQ(query.track("Alpha", DAY0 + 3600000, DAY0 + 7140000).size(), 60u);
+    EXPECT_EQ(query.track("Alpha", DAY0, DAY0 + 3 * 3600000, 70).size(), 70u);
+    auto latest = query.latest();
+    ASSERT_EQ(latest.size(), 2u);
+    EXPECT_EQ(latest[0].timeMs, DAY0 + 179 * 60000);
+
+    // 2. Maintenance an hour after the last partition ended: the first two are past
+    //    retention, the last one is downsampled to its end points
+    cfg.retention = std::chrono::hours(2);
+    cfg.compactAfter = std::chrono::hours(1);
+    cfg.maintenanceInterval = std::chrono::minutes(0); // No thread: only the explicit pass below
+    SQLiteLogger maintainer(cfg);
+    maintainer.maintain(DAY0 + 4 * 3600000);
+    maintainer.stop();
+    EXPECT_EQ(maintainer.stats().partitionsDeleted, 2u);
+    EXPECT_EQ(maintainer.stats().partitionsCompacted, 1u);
+    EXPECT_EQ(maintainer.stats().rowsCompacted, 2u * 58);
+
+    auto left = query.track("Alpha", DAY0, DAY0 + 3 * 3600000);
+    ASSERT_EQ(left.size(), 2u);
+    EXPECT_EQ(left[0].timeMs, DAY0 + 120 * 60000);
+    EXPECT_EQ(left[1].timeMs, DAY0 + 179 * 60000);
+}
+
+TEST(LoggerTest, MaintenanceLeavesPartitionsTheWriterHasOpen) {
+    TempDir dir("logger");
+    SQLiteLogger::Config cfg;
+    cfg.path = dir.file("track.db");
+    cfg.partitioning = Partitioning::Hourly;
+    cfg.retention = std::chrono::hours(2);
+    cfg.compactAfter = std::chrono::hours(1);
+    cfg.maintenanceInterval = std::chrono::minutes(0);
+    cfg.batchInterval = std::chrono::milliseconds(10);
+
+    // A replayed fix from long past retention: its partition is open in the writer
+    SQLiteLogger logger(cfg);
+    logger.log(fixAt("Alpha", DAY0, 48.0, 11.0));
+    for (int i = 0; i < 200 && logger.stats().rows < 1; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(logger.stats().rows, 1u);
+
+    logger.maintain(DAY0 + 24 * 3600000);
+    EXPECT_EQ(logger.stats().partitionsDeleted, 0u);
+    EXPECT_EQ(logger.stats().partitionsCompacted, 0u);
+
+    // Still the live file: the next fix lands next to the first one
+    logger.log(fixAt("Alpha", DAY0 + 60000, 48.1, 11.0));
+    logger.stop();
+    TrackQuery query(cfg.path, Partitioning::Hourly);
+    EXPECT_EQ(query.track("Alpha", DAY0, DAY0 + 3600000).size(), 2u);
+
+    // Closed: now it retires
+    logger.maintain(DAY0 + 24 * 3600000);
+    EXPECT_EQ(logger.stats().partitionsDeleted, 1u);
+    EXPECT_TRUE(TrackPartitions::list(cfg.path, Partitioning::Hourly).empty());
+}
+
+TEST(LoggerTest, ColumnStoreRoundTripScansAndReopens) {
+    TempDir dir("logger");
+    TrackColumnStore::Config cfg;
+    cfg.directory = dir.path + "/tracks";
+    cfg.blockFixes = 100;
+    {
+        // 10 Hz for 100 s, two vessels, through the common interface
+        TrackColumnStore store(cfg);
+        ITrackLogger& logger = store;
+        for (int i = 0; i < 1000; ++i) {
+            GPSData a = fixAt("Alpha", DAY0 + i * 100, 48.0 + i * 1e-6, 11.0);
+            a.latitudeE7 = 480000000 + i * 10;
+            a.longitudeE7 = 110000000;
+            a.altitude = 12.3;
+            a.satellites = 9;
+            a.fixQuality = 2;
+            logger.log(a);
+            logger.log(fixAt("Bravo", DAY0 + i * 100, 54.0, 10.0 + i * 1e-6));
+        }
+        logger.stop();
+
+        auto stats = store.stats();
+        EXPECT_EQ(stats.fixes, 2000u);
+        EXPECT_EQ(stats.blocks, 20u);
+        EXPECT_LT(stats.bytes, 2000u * 12); // A few bytes per fix, headers included
+
+        // Window inside one block and across blocks
+        auto t = store.track("Alpha", DAY0 + 15000, DAY0 + 34900);
+        ASSERT_EQ(t.size(), 200u);
+        EXPECT_EQ(t[0].timeMs, DAY0 + 15000);
+        EXPECT_EQ(t[0].data.latitudeE7, 480000000 + 150 * 10);
+        EXPECT_DOUBLE_EQ(t[0].data.altitude, 12.3);
+        EXPECT_DOUBLE_EQ(t[0].data.course, 271.0);
+        EXPECT_EQ(t[0].data.satellites, 9);
+        EXPECT_EQ(t[0].data.fixQuality, 2);
+        EXPECT_TRUE(t[0].data.isValid);
+    }
+
+    // Reopened: the index and vessel keys come back, appends continue
+    TrackColumnStore store(cfg);
+    store.log(fixAt("Bravo", DAY0 + 100000, 54.0, 10.001));
+    store.stop();
+    EXPECT_EQ(store.track("Bravo", DAY0, DAY0 + 200000).size(), 1001u);
+
+    size_t inBox = 0;
+    store.scanBox(53.9, 10.0, 54.1, 10.0005, DAY0, DAY0 + 200000, [&](const TrackColumnStore::StoredFix& f) {
+        EXPECT_EQ(f.data.ID, "Bravo");
+        inBox++;
+    });
+    EXPECT_EQ(inBox, 501u); // lon 10.0000 .. 10.0005
+}
+
+TEST(LoggerTest, ColumnStoreReopensCleanlyAfterTornTails) {
+    TempDir dir("logger");
+    TrackColumnStore::Config cfg;
+    cfg.directory = dir.mkdir("tracks");
+    cfg.blockFixes = 5;
+    auto logTen = [&](const std::string& id, int64_t from) {
+        TrackColumnStore store(cfg);
+        for (int i = 0; i < 10; ++i) store.log(fixAt(id, from + i * 1000, 48.0, 11.0));
+        store.stop();
+    };
+    // Crash mid-append: a partial index entry and a partial vessel line
+    auto tear = [&](const char* file, const std::string& junk) {
+        std::ofstream(cfg.directory + "/" + file, std::ios::binary | std::ios::app) << junk;
+    };
+
+    logTen("Alpha", DAY0);
+    tear("tracks.idx", "abc");
+    tear("tracks.vessels", "1 Brav");
+    logTen("Alpha", DAY0 + 10000);
+    logTen("Bravo", DAY0);
+
+    // Everything written after the restarts is found once reopened
+    TrackColumnStore store(cfg);
+    store.stop();
+    EXPECT_EQ(store.track("Alpha", DAY0, DAY0 + 100000).size(), 20u);
+    auto bravo = store.track("Bravo", DAY0, DAY0 + 100000);
+    ASSERT_EQ(bravo.size(), 10u);
+    EXPECT_EQ(bravo[0].data.ID, "Bravo");
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include "NMEANumber.h"
+#include "NMEAParser.h"
+
+// 1. Coordinate Tests (exact fixed-point results)
+// Expected values are round((DD + MM.MMMM / 60) * 1e7), computed with exact rationals.
+struct CoordinateCase {
+    const char* pos;
+    const char* hemisphere;
+    int32_t expectedE7;
+};
+
+TEST(NumberTest, CoordinatesConvertExactly) {
+    const CoordinateCase cases[] = {
+        {"4807.038", "N", 481173000},
+        {"01131.000", "E", 115166667},
+        {"4807.038", "S", -481173000},
+        {"01131.000", "W", -115166667},
+        {"0000.0000", "N", 0},
+        {"9000.0000", "S", -900000000},
+        {"18000.0000", "E", 1800000000},
+        {"3723.2475", "N", 373874583},
+        {"12158.3416", "W", -1219723600},
+        {"5130.4779", "N", 515079650},
+        {"00007.6540", "W", -1275667},
+        {"4916.45", "N", 492741667},
+        {"12311.12", "W", -1231853333},
+        {"0030.000003", "N", 5000001},
+        {"0000.000003", "N", 1},          // Exactly 0.5 units: rounds away from zero
+        {"0000.000009", "N", 2},          // Exactly 1.5 units
+        {"4530.1234567", "N", 455020576},
+        {"17959.999999", "E", 1800000000},
+        {"07.5", "N", 1250000},           // Degrees field may be empty
+    };
+
+    for (const auto& c : cases) {
+        int32_t e7 = 0;
+        ASSERT_TRUE(NMEANumber::parseCoordinateE7(c.pos, c.hemisphere, e7)) << c.pos;
+        EXPECT_EQ(e7, c.expectedE7) << c.pos << " " << c.hemisphere;
+    }
+}
+
+// Every 4-decimal minute value for one degree, against an independent long double reference.
+// (No 4-decimal input lands exactly on a rounding tie, so the reference is unambiguous.)
+TEST(NumberTest, EveryMinuteValueMatchesReference) {
+    char buf[16];
+    for (int m = 0; m < 600000; ++m) {
+        std::snprintf(buf, sizeof(buf), "48%02d.%04d", m / 10000, m % 10000);
+        int32_t e7 = 0;
+        ASSERT_TRUE(NMEANumber::parseCoordinateE7(buf, "N", e7)) << buf;
+
+        long double exact = 48.0L * 1e7L + (m / 1e4L) * 1e7L / 60.0L;
+        ASSERT_EQ(e7, static_cast<int32_t>(std::llround(exact))) << buf;
+    }
+}
+
+TEST(NumberTest, RejectsMalformedCoordinates) {
+    int32_t e7 = 12345;
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("", "N", e7));
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("48x7.038", "N", e7));
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("4860.000", "N", e7)); // 60 minutes
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("9100.000", "N", e7)); // Latitude > 90
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("18100.000", "E", e7)); // Longitude > 180
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("4807.0.38", "N", e7));
+    EXPECT_FALSE(NMEANumber::parseCoordinateE7("-4807.038", "N", e7));
+    EXPECT_EQ(e7, 12345); // Untouched on failure
+}
+
+// 2. Fixed-point Tests
+TEST(NumberTest, ParseFixedScalesAndRounds) {
+    int64_t v = 0;
+    ASSERT_TRUE(NMEANumber::parseFixed("12.345", 2, v)); EXPECT_EQ(v, 1235);
+    ASSERT_TRUE(NMEANumber::parseFixed("12.344", 2, v)); EXPECT_EQ(v, 1234);
+    ASSERT_TRUE(NMEANumber::parseFixed("-12.345", 2, v)); EXPECT_EQ(v, -1235);
+    ASSERT_TRUE(NMEANumber::parseFixed("7", 3, v)); EXPECT_EQ(v, 7000);
+    ASSERT_TRUE(NMEANumber::parseFixed(".5", 1, v)); EXPECT_EQ(v, 5);
+    ASSERT_TRUE(NMEANumber::parseFixed("000000000000000000000001", 0, v)); EXPECT_EQ(v, 1);
+    ASSERT_TRUE(NMEANumber::parseFixed("999999999999999999", 0, v)); EXPECT_EQ(v, 999999999999999999);
+
+    EXPECT_FALSE(NMEANumber::parseFixed("", 2, v));
+    EXPECT_FALSE(NMEANumber::parseFixed(".", 2, v));
+    EXPECT_FALSE(NMEANumber::parseFixed("1.2.3", 2, v));
+    EXPECT_FALSE(NMEANumber::parseFixed("1e5", 2, v));
+    EXPECT_FALSE(NMEANumber::parseFixed("9999999999999999999", 0, v)); // Overflows int64
+    EXPECT_FALSE(NMEANumber::parseFixed("99999999999", 9, v));
+}
+
+TEST(NumberTest, ParseTimeToMillis) {
+    int32_t ms = 0;
+    ASSERT_TRUE(NMEANumber::parseTimeMs("123519", ms)); EXPECT_EQ(ms, 45319000);
+    ASSERT_TRUE(NMEANumber::parseTimeMs("235959.999", ms)); EXPECT_EQ(ms, 86399999);
+    ASSERT_TRUE(NMEANumber::parseTimeMs("000000.05", ms)); EXPECT_EQ(ms, 50);
+    EXPECT_FALSE(NMEANumber::parseTimeMs("246000", ms));
+    EXPECT_FALSE(NMEANumber::parseTimeMs("12351", ms));
+    EXPECT_FALSE(NMEANumber::parseTimeMs("12a519", ms));
+}
+
+// 3. Safe Helper Tests (never throw, 0 on garbage)
+TEST(NumberTest, SafeHelpersNeverThrow) {
+    EXPECT_DOUBLE_EQ(NMEAParser::safeStod("545.4"), 545.4);
+    EXPECT_DOUBLE_EQ(NMEAParser::safeStod("+1.5"), 1.5);
+    EXPECT_DOUBLE_EQ(NMEAParser::safeStod("abc"), 0.0);
+    EXPECT_DOUBLE_EQ(NMEAParser::safeStod(""), 0.0);
+    EXPECT_EQ(NMEAParser::safeStoi("08"), 8);
+    EXPECT_EQ(NMEAParser::safeStoi("99999999999"), 0); // Out of range
+    EXPECT_EQ(NMEAParser::safeStoi("x"), 0);
+}
+
+TEST(NumberTest, DecodersFillFixedPointFields) {
+    NMEAParser parser;
+    GPSData data = parser.parse("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+    ASSERT_TRUE(data.isValid);
+    EXPECT_EQ(data.latitudeE7, 481173000);
+    EXPECT_EQ(data.longitudeE7, 115166667);
+    EXPECT_DOUBLE_EQ(data.latitude, 48.1173);
+
+    // Garbage numeric fields decode as 0 instead of throwing
+    GPSData bad = parser.parse("$GPGGA,123519,4807.038,N,01131.000,E,X,YY,0.9,ZZZ,M,46.9,M,,*52");
+    EXPECT_TRUE(bad.isValid);
+    EXPECT_EQ(bad.fixQuality, 0);
+    EXPECT_EQ(bad.satellites, 0);
+    EXPECT_EQ(bad.altitude, 0.0);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "NMEAParser.h"
+#include "NMEAScanner.h"
 
 // Fixture for setting up complex tests
 class ParserTest : public ::testing::Test {
@@ -61,4 +62,137 @@ TEST_F(ParserTest, ObserverCallbackFires) {
     parser.parse(raw);
 
     EXPECT_TRUE(callbackFired) << "Callback failed to execute on valid fix";
-}
\ No newline at end of file
+}
+
+// 4. Tokenizer Tests
+TEST_F(ParserTest, TokenizerReturnsFieldViews) {
+    std::string raw = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+    NMEATokens tokens = NMEAParser::tokenize(raw);
+
+    ASSERT_EQ(tokens.size(), 15u);
+    EXPECT_EQ(tokens[0], "$GPGGA");
+    EXPECT_EQ(tokens[2], "4807.038");
+    EXPECT_EQ(tokens[14], ""); // Empty field right before '*'
+    EXPECT_EQ(tokens[tokens.size()], "");            // Out of range reads as blank
+    EXPECT_EQ(tokens[NMEATokens::MAX_FIELDS - 1], ""); // (within the fixed storage)
+
+    // Views point into the caller's buffer, nothing was copied
+    EXPECT_EQ(tokens[2].data(), raw.data() + 14);
+}
+
+TEST_F(ParserTest, ParsesStringViewIntoLargerBuffer) {
+    // Two sentences back to back, as they arrive in one receive buffer
+    std::string buffer = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+                         "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n";
+    std::string_view view(buffer);
+    size_t split = view.find('\n') + 1;
+
+    GPSData gga = parser.parse(view.substr(0, split));
+    GPSData rmc = parser.parse(view.substr(split));
+
+    EXPECT_TRUE(gga.isValid);
+    EXPECT_EQ(gga.satellites, 8);
+    EXPECT_TRUE(rmc.isValid);
+    EXPECT_NEAR(rmc.speed, 22.4, 0.1);
+}
+
+// 5. Dispatch Table Tests (Multi-constellation talkers)
+TEST_F(ParserTest, AcceptsAnyTalkerID) {
+    GPSData gn = parser.parse("$GNGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*59");
+    EXPECT_TRUE(gn.isValid);
+    EXPECT_EQ(gn.type, "GNGGA");
+    EXPECT_EQ(gn.talker, "GN");
+    EXPECT_EQ(gn.satellites, 8);
+
+    GPSData gl = parser.parse("$GLRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*76");
+    EXPECT_TRUE(gl.isValid);
+    EXPECT_EQ(gl.talker, "GL");
+    EXPECT_NEAR(gl.speed, 22.4, 0.1);
+}
+
+TEST_F(ParserTest, RejectsUnknownFormatterAndProprietary) {
+    // Checksums are valid, the sentence types are just not decoded
+    EXPECT_FALSE(parser.parse("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39").isValid);
+    EXPECT_FALSE(parser.parse("$PGRME,15.0,M,45.0,M,25.0,M*1C").isValid);
+}
+
+// 6. Scanner Kernel Tests
+// Every SIMD kernel must agree with the scalar reference byte for byte
+TEST_F(ParserTest, ScannerKernelsMatchScalar) {
+    std::vector<std::string> inputs = {
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47",
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n",
+        "!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C",
+        "garbage before the start $GPGGA,,,,*00",
+        "no delimiters at all in this line, except commas,,,",
+        "",
+        "$",
+        "*$*",
+    };
+    // Put '*' and ',' on every offset around the 16/32-byte block edges
+    for (size_t pad = 0; pad < 70; ++pad) {
+        inputs.push_back(std::string(pad % 7, ' ') + "$" + std::string(pad, 'A') + ",B,*1F");
+        inputs.push_back("$" + std::string(pad, ',') + "*");
+    }
+
+    for (const auto& in : inputs) {
+        uint32_t refCommas[8], simdCommas[8];
+        NMEAScan ref = NMEAScanner::scanWith(NMEAScanner::Kernel::Scalar, in, refCommas, 8);
+
+        for (auto kernel : {NMEAScanner::Kernel::SSE2, NMEAScanner::Kernel::AVX2}) {
+            if (!NMEAScanner::isSupported(kernel)) continue;
+            NMEAScan got = NMEAScanner::scanWith(kernel, in, simdCommas, 8);
+
+            EXPECT_EQ(got.start, ref.start) << NMEAScanner::kernelName(kernel) << ": " << in;
+            EXPECT_EQ(got.star, ref.star) << NMEAScanner::kernelName(kernel) << ": " << in;
+            EXPECT_EQ(got.checksum, ref.checksum) << NMEAScanner::kernelName(kernel) << ": " << in;
+            ASSERT_EQ(got.commaCount, ref.commaCount) << NMEAScanner::kernelName(kernel) << ": " << in;
+            for (size_t k = 0; k < std::min<size_t>(ref.commaCount, 8); ++k) {
+                EXPECT_EQ(simdCommas[k], refCommas[k]);
+            }
+        }
+    }
+}
+
+TEST_F(ParserTest, RejectsBadHexAndTruncatedChecksum) {
+    EXPECT_FALSE(NMEAParser::validateChecksum("$GPGGA,123519,4807.038,N*Z7"));
+    EXPECT_FALSE(NMEAParser::validateChecksum("$GPGGA,123519,4807.038,N*4"));
+    EXPECT_EQ(NMEAParser::hexToDecimal("6A"), 0x6A);
+    EXPECT_EQ(NMEAParser::hexToDecimal("g1"), -1);
+}
+
+// 7. Batch (Columnar) Tests
+TEST_F(ParserTest, ParseBatchFillsColumnsAndBitmap) {
+    std::vector<std::string> lines = {
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47",
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*00", // Bad checksum
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A",
+    };
+    GPSBatch batch;
+    NMEAParser::parseBatch(lines, batch);
+
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch.validCount(), 2u);
+    EXPECT_TRUE(batch.isValid(0));
+    EXPECT_FALSE(batch.isValid(1));
+    EXPECT_TRUE(batch.isValid(2));
+
+    EXPECT_NEAR(batch.latitude[0], 48.1173, 0.0001);
+    EXPECT_EQ(batch.fixQuality[0], 1);
+    EXPECT_DOUBLE_EQ(batch.timestamp[0], 12 * 3600 + 35 * 60 + 19);
+    EXPECT_EQ(batch.latitude[1], 0.0);
+    EXPECT_NEAR(batch.speed[2], 22.4, 0.1);
+    EXPECT_NEAR(batch.course[2], 84.4, 0.1);
+}
+
+TEST_F(ParserTest, ParseBatchDoesNotNotifyListeners) {
+    bool fired = false;
+    parser.onFix([&fired](const GPSData&) { fired = true; });
+
+    std::vector<std::string> lines(200, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+    GPSBatch batch;
+    NMEAParser::parseBatch(lines, batch);
+
+    EXPECT_EQ(batch.validCount(), 200u); // Spans several bitmap words
+    EXPECT_FALSE(fired);
+}
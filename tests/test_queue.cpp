@@ -2,7 +2,15 @@
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "BatchWriter.h"
 #include "SafeQueue.h"
+#include "RingQueue.h"
+#include "ParserPool.h"
 
 TEST(ConcurrencyTest, QueueHandlesMultipleThreads) {
     SafeQueue<int> queue;
@@ -41,4 +49,141 @@ TEST(ConcurrencyTest, QueueHandlesMultipleThreads) {
     // If the queue wasn't thread safe, we would likely lose numbers or crash
     EXPECT_EQ(processed_count, NUM_THREADS * PUSHES_PER_THREAD);
     EXPECT_TRUE(queue.empty());
-}
\ No newline at end of file
+}
+// Ring Queue: bounded, lock-free, move-only items
+TEST(RingQueueTest, FifoWithMoveOnlyItemsAndBatchPop) {
+    RingQueue<std::unique_ptr<int>> ring(5); // Rounded up to 8
+    EXPECT_EQ(ring.capacity(), 8u);
+    for (int i = 0; i < 6; ++i) EXPECT_TRUE(ring.push(std::make_unique<int>(i)));
+
+    std::unique_ptr<int> out[4];
+    ASSERT_EQ(ring.popN(out, 4), 4u);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(*out[i], i);
+    ASSERT_EQ(ring.popN(out, 4), 2u);
+    EXPECT_EQ(*out[1], 5);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingQueueTest, OverflowPolicies) {
+    RingQueue<int> newest(4, OverflowPolicy::DropNewest);
+    RingQueue<int> oldest(4, OverflowPolicy::DropOldest);
+    for (int i = 0; i < 6; ++i) {
+        newest.push(int(i));
+        oldest.push(int(i));
+    }
+
+    int v;
+    newest.tryPop(v);
+    EXPECT_EQ(v, 0); // 4 and 5 were rejected
+    EXPECT_EQ(newest.stats().dropped, 2u);
+
+    oldest.tryPop(v);
+    EXPECT_EQ(v, 2); // 0 and 1 were evicted
+    EXPECT_EQ(oldest.stats().evicted, 2u);
+    EXPECT_EQ(oldest.stats().pushed, 6u);
+}
+
+TEST(RingQueueTest, BlockingProducersLoseNothing) {
+    RingQueue<int> ring(16, OverflowPolicy::Block);
+    const int NUM_PRODUCERS = 4;
+    const int PUSHES_PER_THREAD = 5000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < NUM_PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p]() {
+            for (int j = 0; j < PUSHES_PER_THREAD; ++j) ring.push(p * PUSHES_PER_THREAD + j);
+        });
+    }
+
+    // Single consumer: each producer's items must come out in its own order
+    std::vector<int> last(NUM_PRODUCERS, -1);
+    int received = 0;
+    int batch[32];
+    while (received < NUM_PRODUCERS * PUSHES_PER_THREAD) {
+        size_t n = ring.popN(batch, 32);
+        for (size_t i = 0; i < n; ++i) {
+            int p = batch[i] / PUSHES_PER_THREAD;
+            EXPECT_GT(batch[i], last[p]);
+            last[p] = batch[i];
+        }
+        received += static_cast<int>(n);
+        if (n == 0) std::this_thread::yield();
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_EQ(ring.stats().pushed, static_cast<uint64_t>(NUM_PRODUCERS * PUSHES_PER_THREAD));
+    EXPECT_EQ(ring.stats().dropped + ring.stats().evicted, 0u);
+}
+
+// Parser Pool: sharded workers must keep per-source order
+namespace {
+// GGA with a given UTC second, so every sentence is its own epoch
+std::string ggaAt(int second) {
+    char body[96];
+    std::snprintf(body, sizeof(body), "GPGGA,1235%02d,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,", second);
+    int cs = 0;
+    for (const char* p = body; *p; ++p) cs ^= *p;
+    char sentence[112];
+    std::snprintf(sentence, sizeof(sentence), "$%s*%02X", body, cs);
+    return sentence;
+}
+
+void runOrderedPool(bool workStealing) {
+    ParserPool::Config cfg;
+    cfg.workers = 4;
+    cfg.workStealing = workStealing;
+    cfg.batchSize = 3; // Force lanes through the run queues many times
+    cfg.fusionTimeout = std::chrono::milliseconds(1);
+    ParserPool pool(cfg);
+
+    std::mutex mtx;
+    std::map<std::string, std::vector<double>> seen;
+    pool.onFix([&](const GPSData& d) {
+        std::lock_guard<std::mutex> lock(mtx);
+        seen[d.ID].push_back(d.timestamp);
+    });
+    pool.start();
+
+    const int SOURCES = 8;
+    const int PER_SOURCE = 60;
+    std::vector<std::thread> producers;
+    for (int s = 0; s < SOURCES; ++s) {
+        producers.emplace_back([&pool, s]() {
+            ParserPool::Lane* lane = pool.lane("src" + std::to_string(s));
+            for (int i = 0; i < PER_SOURCE; ++i) pool.submit(lane, ggaAt(i));
+        });
+    }
+    for (auto& t : producers) t.join();
+    pool.stop();
+
+    EXPECT_EQ(pool.stats().sentences, static_cast<uint64_t>(SOURCES * PER_SOURCE));
+    ASSERT_EQ(seen.size(), static_cast<size_t>(SOURCES));
+    for (const auto& [id, times] : seen) {
+        ASSERT_EQ(times.size(), static_cast<size_t>(PER_SOURCE)) << id;
+        EXPECT_TRUE(std::is_sorted(times.begin(), times.end())) << id << " was reordered";
+    }
+}
+}
+
+TEST(BatchWriterTest, StopDeliversEverythingPushedBeforeIt) {
+    // Pushes racing the writer going idle must still arrive before onStop
+    for (int round = 0; round < 50; ++round) {
+        BatchWriter<int> writer(1024, 8);
+        int received = 0;
+        bool done = false;
+        writer.start([&received](int*, size_t n) { received += static_cast<int>(n); },
+                     [&] { done = received == 100; });
+        std::this_thread::sleep_for(std::chrono::microseconds(round * 50)); // Vary where the writer is
+        for (int i = 0; i < 100; ++i) writer.push(int(i));
+        writer.stop();
+        ASSERT_TRUE(done) << "round " << round << ": " << received << " of 100 before onStop";
+    }
+}
+
+TEST(ConcurrencyTest, ParserPoolKeepsPerSourceOrder) {
+    runOrderedPool(false);
+}
+
+TEST(ConcurrencyTest, ParserPoolWorkStealingKeepsPerSourceOrder) {
+    runOrderedPool(true);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "NMEAReactor.h"
+#include "UDPBatchSource.h"
+
+namespace {
+// Read end of a pipe: stands in for a serial port or TCP stream
+class PipeSource : public IPollableSource {
+    int fds[2] = {-1, -1};
+
+public:
+    bool open() override { return ::pipe(fds) == 0; }
+    void close() override {
+        if (fds[0] >= 0) ::close(fds[0]);
+        fds[0] = -1;
+    }
+    std::string readLine() override { return std::string(); }
+    int fd() const override { return fds[0]; }
+
+    int writer() const { return fds[1]; }
+    void closeWriter() {
+        ::close(fds[1]);
+        fds[1] = -1;
+    }
+    void write(const std::string& s) { ASSERT_EQ(::write(fds[1], s.data(), s.size()), (ssize_t)s.size()); }
+};
+
+// Collects sentences per source and lets the test wait for a count
+struct Collector {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::map<std::string, std::vector<std::string>> seen;
+    size_t total = 0;
+
+    NMEAReactor::SentenceSink sink(const std::string& id) {
+        return [this, id](std::string_view s) {
+            std::lock_guard<std::mutex> lock(mtx);
+            seen[id].emplace_back(s);
+            total++;
+            cv.notify_all();
+        };
+    }
+
+    bool waitFor(size_t n) {
+        std::unique_lock<std::mutex> lock(mtx);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return total >= n; });
+    }
+};
+}
+
+TEST(ReactorTest, FramesEachSourceSeparatelyOnFewThreads) {
+    NMEAReactor::Config cfg;
+    cfg.threads = 2;
+    NMEAReactor reactor(cfg);
+    Collector out;
+
+    // Many sources, two threads
+    const int SOURCES = 10;
+    std::vector<PipeSource*> pipes;
+    for (int s = 0; s < SOURCES; ++s) {
+        auto src = std::make_unique<PipeSource>();
+        ASSERT_TRUE(src->open());
+        pipes.push_back(src.get());
+        std::string id = "pipe" + std::to_string(s);
+        ASSERT_TRUE(reactor.add(id, std::move(src), out.sink(id)));
+    }
+    reactor.start();
+
+    // Sentences split across writes must be reassembled per source
+    for (int s = 0; s < SOURCES; ++s) pipes[s]->write("$GPTXT,A");
+    for (int s = 0; s < SOURCES; ++s) pipes[s]->write(std::to_string(s) + "*00\r\n$GPTXT,B*00\r\n");
+
+    ASSERT_TRUE(out.waitFor(2 * SOURCES));
+    reactor.stop();
+
+    for (int s = 0; s < SOURCES; ++s) {
+        const auto& got = out.seen["pipe" + std::to_string(s)];
+        ASSERT_EQ(got.size(), 2u);
+        EXPECT_EQ(got[0], "$GPTXT,A" + std::to_string(s) + "*00");
+        EXPECT_EQ(got[1], "$GPTXT,B*00");
+    }
+    EXPECT_EQ(reactor.stats().sentences, static_cast<uint64_t>(2 * SOURCES));
+}
+
+TEST(ReactorTest, StopsPromptlyWithIdleSourcesAndReportsEOF) {
+    NMEAReactor reactor(NMEAReactor::Config{});
+    Collector out;
+
+    std::mutex mtx;
+    std::vector<std::string> closed;
+    reactor.onClosed([&](const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed.push_back(id);
+    });
+
+    auto idle = std::make_unique<PipeSource>();
+    auto ending = std::make_unique<PipeSource>();
+    ASSERT_TRUE(idle->open());
+    ASSERT_TRUE(ending->open());
+    PipeSource* endingPtr = ending.get();
+    reactor.add("idle", std::move(idle), out.sink("idle"));
+    reactor.add("ending", std::move(ending), out.sink("ending"));
+    reactor.start();
+
+    endingPtr->write("$GPTXT,last*00\r\n");
+    endingPtr->closeWriter(); // EOF
+    ASSERT_TRUE(out.waitFor(1));
+    // The EOF may arrive on a later read than the data
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (reactor.stats().closedSources == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // No data on 'idle' and nobody closes it: stop() must still return
+    auto t0 = std::chrono::steady_clock::now();
+    reactor.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds(1));
+
+    std::lock_guard<std::mutex> lock(mtx);
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0], "ending");
+}
+
+TEST(ReactorTest, ServicesBatchedUDPSource) {
+    UDPBatchSource::Config ucfg;
+    ucfg.port = 0;
+    auto udp = std::make_unique<UDPBatchSource>(ucfg);
+    ASSERT_TRUE(udp->open());
+    int port = udp->boundPort();
+
+    NMEAReactor reactor(NMEAReactor::Config{});
+    Collector out;
+    reactor.add("udp", std::move(udp), out.sink("udp"));
+    reactor.start();
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(static_cast<uint16_t>(port));
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        std::string msg = "$GPTXT," + std::to_string(i); // No CR/LF: the datagram ends the sentence
+        sendto(fd, msg.data(), msg.size(), 0, (const sockaddr*)&to, sizeof(to));
+    }
+    ::close(fd);
+
+    ASSERT_TRUE(out.waitFor(100));
+    reactor.stop();
+    const auto& got = out.seen["udp"];
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(got[i], "$GPTXT," + std::to_string(i));
+}
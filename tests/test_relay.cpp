@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "NMEARelay.h"
+
+namespace {
+std::string withChecksum(const std::string& body) {
+    int cs = 0;
+    for (size_t i = 1; i < body.size(); ++i) cs ^= static_cast<unsigned char>(body[i]);
+    char tail[4];
+    std::snprintf(tail, sizeof(tail), "*%02X", cs);
+    return body + tail;
+}
+
+int connectTo(int port, int rcvbuf = 0) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvbuf > 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Reads until 'expected' bytes arrived or 2 s passed
+std::string readFor(int fd, size_t expected) {
+    std::string out;
+    timeval tv{0, 100000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    char buf[4096];
+    while (out.size() < expected && std::chrono::steady_clock::now() < deadline) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) out.append(buf, static_cast<size_t>(n));
+    }
+    return out;
+}
+
+void waitForClients(const NMEARelay& relay, uint64_t n) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (relay.stats().clients < n && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}
+
+TEST(RelayTest, FansOutValidatedFilteredDedupedSentences) {
+    // UDP receiver for the datagram target
+    int udp = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in uaddr{};
+    uaddr.sin_family = AF_INET;
+    uaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(udp, (const sockaddr*)&uaddr, sizeof(uaddr)), 0);
+    socklen_t len = sizeof(uaddr);
+    getsockname(udp, (sockaddr*)&uaddr, &len);
+
+    NMEARelay::Config cfg;
+    cfg.tcpPort = 0;
+    cfg.udpTargets = {"127.0.0.1:" + std::to_string(ntohs(uaddr.sin_port))};
+    cfg.formatters = {"GGA", "VDM"};
+    cfg.dedupWindow = std::chrono::milliseconds(1000);
+    NMEARelay relay(cfg);
+    ASSERT_TRUE(relay.start());
+
+    int a = connectTo(relay.tcpPort());
+    int b = connectTo(relay.tcpPort());
+    ASSERT_GE(a, 0);
+    ASSERT_GE(b, 0);
+    waitForClients(relay, 3); // 2 TCP + 1 UDP
+
+    std::string gga = withChecksum("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    std::string rmc = withChecksum("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W");
+    std::string vdm = withChecksum("!AIVDM,1,1,,A,13aEOK?P00PD2wVMdLDRhgvL289?,0");
+
+    relay.publish("Alpha", gga + "\r\n");
+    relay.publish("Alpha", rmc);                   // Filtered out
+    relay.publish("Bravo", gga);                   // Same sentence via another receiver: duplicate
+    relay.publish("Alpha", "$GPGGA,bad*00");       // Bad checksum
+    relay.publish(RawPacket{"Bravo", vdm});
+
+    std::string expected = gga + "\r\n" + vdm + "\r\n";
+    EXPECT_EQ(readFor(a, expected.size()), expected);
+    EXPECT_EQ(readFor(b, expected.size()), expected);
+
+    char dgram[256];
+    ssize_t n = recv(udp, dgram, sizeof(dgram), 0);
+    EXPECT_EQ(std::string(dgram, static_cast<size_t>(n)), gga + "\r\n");
+
+    auto s = relay.stats();
+    EXPECT_EQ(s.published, 2u);
+    EXPECT_EQ(s.filtered, 1u);
+    EXPECT_EQ(s.duplicates, 1u);
+    EXPECT_EQ(s.invalid, 1u);
+
+    relay.stop();
+    close(a);
+    close(b);
+    close(udp);
+}
+
+TEST(RelayTest, SlowClientDropsWithoutStallingOthers) {
+    NMEARelay::Config cfg;
+    cfg.tcpPort = 0;
+    cfg.clientQueue = 64;
+    NMEARelay relay(cfg);
+    ASSERT_TRUE(relay.start());
+
+    int slow = connectTo(relay.tcpPort(), 4096); // Never reads
+    int fast = connectTo(relay.tcpPort());
+    ASSERT_GE(slow, 0);
+    ASSERT_GE(fast, 0);
+    waitForClients(relay, 2);
+
+    std::string gga = withChecksum("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,") + "\r\n";
+    const size_t COUNT = 50000; // Several MB: far beyond the slow client's socket buffers
+
+    std::string received;
+    std::thread reader([&] { received = readFor(fast, COUNT * gga.size()); });
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < COUNT; ++i) {
+        relay.publish("Alpha", gga);
+        if (i % 32 == 31) std::this_thread::sleep_for(std::chrono::microseconds(20)); // ~Realistic pacing
+    }
+    auto publishTime = std::chrono::steady_clock::now() - t0;
+    reader.join();
+
+    EXPECT_LT(publishTime, std::chrono::seconds(5)); // publish() never blocked on the slow client
+    EXPECT_GT(relay.stats().dropped, 0u);
+    EXPECT_GT(received.size(), 0u);
+    EXPECT_EQ(received.size() % gga.size(), 0u); // Whatever arrived is whole sentences
+
+    relay.stop();
+    close(slow);
+    close(fast);
+}
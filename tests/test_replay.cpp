@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+#include "NMEAReactor.h"
+#include "ReplaySource.h"
+#include "TempDir.h"
+
+namespace {
+std::vector<std::string> drain(ReplaySource& source) {
+    std::vector<std::string> out;
+    std::string_view s;
+    while (source.next(s)) out.emplace_back(s);
+    return out;
+}
+}
+
+TEST(ReplayTest, MaxSpeedSkipsJunkLines) {
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea",
+                                      "$GPGGA,120000.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+                                      "# comment line\n"
+                                      "\n"
+                                      "!AIVDM,1,1,,A,13aEOK?P00PD2wVMdLDRhgvL289?,0*26\r\n"
+                                      "$GPRMC,120001.00,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A");
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::MaxSpeed;
+    ReplaySource source(cfg);
+    ASSERT_TRUE(source.open());
+
+    auto lines = drain(source);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[1], "!AIVDM,1,1,,A,13aEOK?P00PD2wVMdLDRhgvL289?,0*26");
+    EXPECT_EQ(lines[2].back(), 'A'); // Last line has no terminator
+    EXPECT_DOUBLE_EQ(source.position(), 1.0);
+    EXPECT_EQ(source.stats().sentences, 3u);
+}
+
+TEST(ReplayTest, ScaledPacingFollowsLogTime) {
+    // Logger-style epoch prefixes spanning 2 seconds, replayed at 20x -> ~100 ms
+    std::string contents;
+    for (int i = 0; i <= 20; ++i) {
+        contents += std::to_string(1697040000.0 + i * 0.1) + " $GPTXT,01,01,02,n" + std::to_string(i) + "*00\n";
+    }
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea", contents);
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::Scaled;
+    cfg.speed = 20.0;
+    ReplaySource source(cfg);
+    ASSERT_TRUE(source.open());
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto lines = drain(source);
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+
+    ASSERT_EQ(lines.size(), 21u);
+    EXPECT_EQ(lines[20], "$GPTXT,01,01,02,n20*00");
+    EXPECT_GE(elapsed, std::chrono::milliseconds(95));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(600));
+    EXPECT_NEAR(source.duration(), 2.0, 1e-6);
+}
+
+TEST(ReplayTest, SeekByTimeAcrossMidnight) {
+    // NMEA-only log: 23:59:58 .. 00:00:03, time comes from the UTC field
+    std::string contents;
+    const char* times[] = {"235958", "235959", "000000", "000001", "000002", "000003"};
+    for (const char* t : times) {
+        contents += std::string("$GPGGA,") + t + ",4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*00\r\n";
+        contents += "$GPGSV,1,1,00*00\r\n"; // No time field: inherits
+    }
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea", contents);
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::MaxSpeed;
+    ReplaySource source(cfg);
+    ASSERT_TRUE(source.open());
+
+    EXPECT_NEAR(source.duration(), 5.0, 1e-6);
+    ASSERT_TRUE(source.seek(3.0)); // 00:00:01
+    std::string_view s;
+    ASSERT_TRUE(source.next(s));
+    EXPECT_EQ(s.substr(0, 13), "$GPGGA,000001");
+    EXPECT_NEAR(source.position(), 3.0, 1e-6);
+}
+
+TEST(ReplayTest, ChunkReadsAndLooping) {
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea", "$GPTXT,a*00\n$GPTXT,b*00\n");
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::MaxSpeed;
+    cfg.loop = true;
+    ReplaySource source(cfg);
+    ASSERT_TRUE(source.open());
+
+    char buf[64];
+    std::string got;
+    while (got.size() < 48) {
+        size_t n = source.readChunk(buf, 24);
+        ASSERT_GT(n, 0u);
+        got.append(buf, n);
+    }
+    EXPECT_EQ(got.substr(0, 48), "$GPTXT,a*00\n$GPTXT,b*00\n$GPTXT,a*00\n$GPTXT,b*00\n");
+    EXPECT_GE(source.stats().loops, 1u);
+}
+
+TEST(ReplayTest, PacesThroughTheReactorWithoutAThread) {
+    std::string contents;
+    for (int i = 0; i < 50; ++i) {
+        contents += std::to_string(1000.0 + i * 0.01) + " $GPTXT,01,01,02,n" + std::to_string(i) + "*00\n";
+    }
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea", contents);
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::Scaled;
+    cfg.speed = 5.0; // 0.49 s of log -> ~100 ms
+    auto source = std::make_unique<ReplaySource>(cfg);
+    ASSERT_TRUE(source->open());
+
+    NMEAReactor reactor(NMEAReactor::Config{});
+    std::vector<std::string> got; // Only the reactor thread appends until 'done'
+    std::promise<void> done;
+    reactor.onClosed([&](const std::string&) { done.set_value(); });
+    reactor.add("replay", std::move(source), [&](std::string_view s) { got.emplace_back(s); });
+
+    auto t0 = std::chrono::steady_clock::now();
+    reactor.start();
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(3)), std::future_status::ready);
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    reactor.stop();
+
+    ASSERT_EQ(got.size(), 50u);
+    EXPECT_EQ(got[49], "$GPTXT,01,01,02,n49*00");
+    EXPECT_GE(elapsed, std::chrono::milliseconds(90));
+}
+
+TEST(ReplayTest, LineLongerThanTheReactorChunkIsCutNotStuck) {
+    TempDir dir("replay");
+    const std::string log = dir.write("voyage.nmea", "$GPGGA," + std::string(5000, 'x') + "\n$GPTXT,01,01,02,after*00\n");
+    ReplaySource::Config cfg;
+    cfg.path = log;
+    cfg.pacing = ReplaySource::Pacing::MaxSpeed;
+    auto source = std::make_unique<ReplaySource>(cfg);
+    ASSERT_TRUE(source->open());
+    ReplaySource* replay = source.get();
+
+    NMEAReactor::Config reactorConfig;
+    reactorConfig.chunkBytes = 4096;
+    NMEAReactor reactor(reactorConfig);
+    std::vector<std::string> got; // Only the reactor thread appends until 'done'
+    std::promise<void> done;
+    reactor.onClosed([&](const std::string&) { done.set_value(); });
+    reactor.add("replay", std::move(source), [&](std::string_view s) { got.emplace_back(s); });
+    reactor.start();
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(3)), std::future_status::ready);
+    reactor.stop();
+
+    ASSERT_FALSE(got.empty());
+    EXPECT_EQ(got.back(), "$GPTXT,01,01,02,after*00");
+    EXPECT_EQ(replay->stats().truncated, 1u);
+}
@@ -13,7 +13,11 @@ int main() {
     // Simulate the main app broadcasting data
     for (int i = 0; i < 5; i++) {
         std::this_thread::sleep_for(std::chrono::seconds(2));
-        server.broadcast("{\"lat\": 48.1, \"status\": \"ping\"}");
+        GPSData ping;
+        ping.ID = "Ping";
+        ping.isValid = true;
+        ping.latitude = 48.1;
+        server.broadcast(ping);
         std::cout << "Broadcasted Ping " << i << std::endl;
     }
 
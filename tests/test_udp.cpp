@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <ctime>
+#include <string>
+#include "UDPBatchSource.h"
+
+namespace {
+// Sends 'count' numbered sentences to 127.0.0.1:port
+void blast(int port, int count) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(static_cast<uint16_t>(port));
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < count; ++i) {
+        std::string msg = "$GPTXT," + std::to_string(i) + "\r\n";
+        sendto(fd, msg.data(), msg.size(), 0, (const sockaddr*)&to, sizeof(to));
+    }
+    close(fd);
+}
+
+uint64_t realtimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+}
+
+TEST(UDPBatchTest, ManyDatagramsPerSyscallWithKernelTimestamps) {
+    UDPBatchSource::Config cfg;
+    cfg.port = 0; // Any free port
+    cfg.batch = 16;
+    UDPBatchSource source(cfg);
+    ASSERT_TRUE(source.open());
+
+    uint64_t before = realtimeNs();
+    blast(source.boundPort(), 40); // Queued before we read: recvmmsg can take 16 at a time
+
+    int next = 0;
+    while (next < 40) {
+        size_t n = source.receiveBatch();
+        ASSERT_GT(n, 0u);
+        for (size_t i = 0; i < n; ++i, ++next) {
+            const UDPDatagram& d = source.datagrams()[i];
+            EXPECT_EQ(d.data, "$GPTXT," + std::to_string(next) + "\r\n");
+            EXPECT_FALSE(d.truncated);
+            EXPECT_GE(d.kernelTimeNs, before - 1000000); // Allow for clock granularity
+            EXPECT_LE(d.kernelTimeNs, realtimeNs());
+        }
+    }
+
+    EXPECT_EQ(source.stats().datagrams, 40u);
+    EXPECT_LT(source.stats().syscalls, 40u);
+    EXPECT_GE(source.stats().syscalls, 3u); // ceil(40 / 16)
+}
+
+TEST(UDPBatchTest, ReadChunkHandsOutOneDatagramAtATime) {
+    UDPBatchSource::Config cfg;
+    cfg.port = 0;
+    cfg.slotBytes = 8; // Force truncation
+    UDPBatchSource source(cfg);
+    ASSERT_TRUE(source.open());
+    blast(source.boundPort(), 3);
+
+    char buf[64];
+    for (int i = 0; i < 3; ++i) {
+        size_t n = source.readChunk(buf, sizeof(buf));
+        EXPECT_EQ(std::string(buf, n), "$GPTXT," + std::to_string(i)); // First 8 bytes only
+        EXPECT_NE(source.lastTimestampNs(), 0u);
+    }
+    EXPECT_EQ(source.stats().truncated, 3u);
+}
+
+TEST(UDPBatchTest, ReusePortLetsTwoReadersShareAPort) {
+    UDPBatchSource::Config cfg;
+    cfg.port = 0;
+    cfg.reusePort = true;
+    UDPBatchSource first(cfg);
+    ASSERT_TRUE(first.open());
+
+    cfg.port = first.boundPort();
+    UDPBatchSource second(cfg);
+    EXPECT_TRUE(second.open());
+}
@@ -0,0 +1,451 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "JSONUtils.h"
+#include "WebFeed.h"
+#include "WireFormat.h"
+
+namespace {
+// Stand-in for a WebSocket connection: records what the feed sends
+struct FakeClient {
+    std::mutex mtx;
+    std::vector<std::string> frames;
+    std::vector<bool> binary;
+    bool closed = false;
+    uint64_t id = 0;
+
+    void attach(WebFeed& feed) {
+        id = feed.addClient(
+            [this](const WebFeed::Buffer& frame, bool isBinary) {
+                std::lock_guard<std::mutex> lock(mtx);
+                frames.push_back(*frame);
+                binary.push_back(isBinary);
+            },
+            [this]() { closed = true; });
+    }
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return frames.size();
+    }
+};
+
+GPSData fix(const std::string& id, double lat, double speed = 0.0) {
+    GPSData d;
+    d.ID = id;
+    d.type = "GPRMC";
+    d.isValid = true;
+    d.latitude = lat;
+    d.latitudeE7 = static_cast<int32_t>(std::llround(lat * 1e7));
+    d.longitude = 11.5;
+    d.longitudeE7 = 115000000;
+    d.speed = speed;
+    d.timestamp = 43200.0;
+    return d;
+}
+}
+
+TEST(WebFeedTest, CoalescesPerVesselIntoOneSharedFrame) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0); // Manual flush()
+    WebFeed feed(cfg);
+
+    FakeClient a, b;
+    a.attach(feed);
+    b.attach(feed);
+
+    feed.publish(fix("Alpha", 48.1));
+    feed.publish(fix("Alpha", 48.2));
+    feed.publish(fix("Bravo", 50.0));
+    feed.flush();
+    feed.flush(); // Nothing new: no empty frames
+
+    ASSERT_EQ(a.frames.size(), 1u);
+    ASSERT_EQ(b.frames.size(), 1u);
+    EXPECT_EQ(a.frames[0], b.frames[0]);
+    EXPECT_FALSE(a.binary[0]);
+
+    // A JSON array of to_json objects, newest fix per vessel
+    json frame = json::parse(a.frames[0]);
+    ASSERT_TRUE(frame.is_array());
+    ASSERT_EQ(frame.size(), 2u);
+    for (const auto& v : frame) {
+        if (v["id"] == "Alpha") EXPECT_EQ(v, json(fix("Alpha", 48.2)));
+        else EXPECT_EQ(v, json(fix("Bravo", 50.0)));
+    }
+
+    auto s = feed.stats();
+    EXPECT_EQ(s.published, 3u);
+    EXPECT_EQ(s.coalesced, 1u);
+    EXPECT_EQ(s.frames, 2u);
+    EXPECT_EQ(s.clients, 2u);
+
+    feed.removeClient(b.id);
+    feed.publish(fix("Alpha", 48.3));
+    feed.flush();
+    EXPECT_EQ(a.frames.size(), 2u);
+    EXPECT_EQ(b.frames.size(), 1u);
+    EXPECT_EQ(feed.stats().clients, 1u);
+}
+
+TEST(WebFeedTest, BackloggedClientGetsNewestStateAndLaggardIsClosed) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    cfg.maxInFlight = 1;
+    cfg.laggardTimeout = std::chrono::milliseconds(50);
+    WebFeed feed(cfg);
+
+    FakeClient fast, slow, plain;
+    fast.attach(feed);
+    slow.attach(feed);
+    plain.attach(feed); // Never acknowledges and never asked to: not paced, never closed
+    feed.setFlowControl(fast.id, WebFeed::FlowControl::Ack);
+    feed.setFlowControl(slow.id, WebFeed::FlowControl::Ack);
+
+    // 1. Both get the first frame; only 'fast' acknowledges it
+    feed.publish(fix("Alpha", 1.0));
+    feed.flush();
+    feed.acknowledge(fast.id);
+    ASSERT_EQ(slow.frames.size(), 1u);
+
+    // 2. 'slow' is at its limit: updates pile up per vessel, newest wins
+    for (int n = 2; n <= 4; ++n) {
+        feed.publish(fix("Alpha", n));
+        feed.flush();
+        feed.acknowledge(fast.id);
+    }
+    EXPECT_EQ(fast.frames.size(), 4u);
+    EXPECT_EQ(slow.frames.size(), 1u);
+    EXPECT_EQ(plain.frames.size(), 4u);
+    EXPECT_EQ(feed.stats().backlogged, 1u);
+
+    // 3. Catching up delivers only the latest state
+    feed.acknowledge(slow.id);
+    feed.flush();
+    ASSERT_EQ(slow.frames.size(), 2u);
+    EXPECT_EQ(slow.frames[1], "[" + GPSDataToJson(fix("Alpha", 4.0)) + "]");
+    EXPECT_EQ(feed.stats().coalesced, 2u);
+
+    // 4. Stops acknowledging for longer than laggardTimeout: closed, no more frames
+    feed.publish(fix("Alpha", 5.0));
+    feed.flush(); // Window full: stalled from here
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    feed.flush();
+    EXPECT_TRUE(slow.closed);
+    EXPECT_FALSE(fast.closed);
+    EXPECT_FALSE(plain.closed);
+    EXPECT_EQ(plain.frames.size(), 5u);
+    EXPECT_EQ(feed.stats().disconnected, 1u);
+
+    feed.publish(fix("Alpha", 6.0));
+    feed.flush();
+    EXPECT_EQ(slow.frames.size(), 2u);
+    feed.removeClient(slow.id); // Transport reports the close
+    EXPECT_EQ(feed.stats().clients, 2u);
+}
+
+TEST(WebFeedTest, PlainClientOverItsByteBudgetCoalescesAndIsClosed) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    cfg.maxBytesPerSec = 1; // One frame a second
+    cfg.laggardTimeout = std::chrono::milliseconds(50);
+    WebFeed feed(cfg);
+
+    FakeClient plain;
+    plain.attach(feed);
+    EXPECT_EQ(feed.stats().plainClients, 1u);
+
+    // 1. The first frame spends the budget; then updates pile up per vessel, newest wins
+    for (int n = 1; n <= 5; ++n) {
+        feed.publish(fix("Alpha", n));
+        feed.flush();
+    }
+    EXPECT_EQ(plain.frames.size(), 1u);
+    EXPECT_EQ(feed.stats().backlogged, 1u);
+    EXPECT_EQ(feed.stats().coalesced, 3u);
+
+    // 2. Still over budget after laggardTimeout: closed, no more frames
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    feed.publish(fix("Alpha", 6.0));
+    feed.flush();
+    EXPECT_TRUE(plain.closed);
+    EXPECT_EQ(feed.stats().disconnected, 1u);
+    EXPECT_EQ(plain.frames.size(), 1u);
+}
+
+TEST(WebFeedTest, TickThreadDeliversWithoutFlush) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(5);
+    WebFeed feed(cfg);
+    FakeClient c;
+    c.attach(feed);
+    feed.start();
+
+    feed.publish(fix("Alpha", 1.0));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (c.count() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    feed.stop();
+    EXPECT_EQ(c.count(), 1u);
+}
+
+TEST(WebFeedTest, BinaryClientsGetNamedThenDeltaRecords) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    cfg.maxInFlight = 100;
+    WebFeed feed(cfg);
+
+    FakeClient bin, text;
+    bin.attach(feed);
+    text.attach(feed);
+    feed.setProtocol(bin.id, WebFeed::Protocol::Binary);
+    EXPECT_EQ(feed.stats().binaryClients, 1u);
+
+    std::unordered_map<uint32_t, WireFormat::Vessel> vessels;
+    std::vector<uint32_t> updated;
+
+    // 1. First sight: named records with absolute values
+    feed.publish(fix("Alpha", 48.1234567, 5.5));
+    feed.publish(fix("Bravo", -33.5));
+    feed.flush();
+    ASSERT_EQ(bin.frames.size(), 1u);
+    EXPECT_TRUE(bin.binary[0]);
+    ASSERT_TRUE(WireFormat::decode(bin.frames[0], vessels, updated));
+    EXPECT_EQ(updated.size(), 2u);
+
+    // 2. Only the latitude moved: a few bytes, everything else carried over
+    feed.publish(fix("Alpha", 48.1234600, 5.5));
+    feed.flush();
+    ASSERT_EQ(bin.frames.size(), 2u);
+    EXPECT_LE(bin.frames[1].size(), 6u);
+    EXPECT_GT(text.frames[1].size(), 100u);
+    updated.clear();
+    ASSERT_TRUE(WireFormat::decode(bin.frames[1], vessels, updated));
+    ASSERT_EQ(updated.size(), 1u);
+
+    const WireFormat::Vessel& alpha = vessels[updated[0]];
+    EXPECT_EQ(alpha.name, "Alpha");
+    EXPECT_EQ(alpha.state.latE7, 481234600);
+    EXPECT_EQ(alpha.state.lonE7, 115000000);
+    EXPECT_EQ(alpha.state.speed, 550);
+    EXPECT_EQ(alpha.state.timeMs, 43200000);
+    EXPECT_EQ(alpha.state.valid, 1);
+    EXPECT_EQ(alpha.state.type, "GPRMC");
+
+    // 3. An identical fix costs nothing
+    feed.publish(fix("Alpha", 48.1234600, 5.5));
+    feed.flush();
+    EXPECT_EQ(bin.frames.size(), 2u);
+    EXPECT_EQ(text.frames.size(), 3u);
+}
+
+TEST(WebFeedTest, SilentVesselsExpireAndTheirHandlesStartOver) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    cfg.vesselTimeout = std::chrono::milliseconds(200);
+    WebFeed feed(cfg);
+
+    FakeClient bin;
+    bin.attach(feed);
+    feed.setProtocol(bin.id, WebFeed::Protocol::Binary);
+
+    std::unordered_map<uint32_t, WireFormat::Vessel> vessels;
+    std::vector<uint32_t> updated;
+    feed.publish(fix("Alpha", 10.0));
+    feed.publish(fix("Bravo", 20.0));
+    feed.flush();
+    ASSERT_TRUE(WireFormat::decode(bin.frames.at(0), vessels, updated));
+    EXPECT_EQ(feed.stats().vessels, 2u);
+    uint32_t alpha = vessels[updated[0]].name == "Alpha" ? updated[0] : updated[1];
+
+    // 1. Only Bravo keeps reporting: Alpha's handle is freed
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    feed.publish(fix("Bravo", 20.5));
+    feed.flush();
+    EXPECT_EQ(feed.stats().vessels, 1u);
+    EXPECT_EQ(feed.stats().expired, 1u);
+
+    // 2. A newcomer reuses it: a named record with absolute values, not a delta on Alpha
+    feed.publish(fix("Charlie", 30.0));
+    feed.flush();
+    ASSERT_EQ(bin.frames.size(), 3u);
+    updated.clear();
+    ASSERT_TRUE(WireFormat::decode(bin.frames[2], vessels, updated));
+    ASSERT_EQ(updated.size(), 1u);
+    EXPECT_EQ(updated[0], alpha);
+    EXPECT_EQ(vessels[alpha].name, "Charlie");
+    EXPECT_EQ(vessels[alpha].state.latE7, 300000000);
+
+    // 3. Alpha coming back is just another new vessel
+    feed.publish(fix("Alpha", 10.1));
+    feed.flush();
+    updated.clear();
+    ASSERT_TRUE(WireFormat::decode(bin.frames.at(3), vessels, updated));
+    ASSERT_EQ(updated.size(), 1u);
+    EXPECT_EQ(vessels[updated[0]].name, "Alpha");
+    EXPECT_EQ(vessels[updated[0]].state.latE7, 101000000);
+    EXPECT_EQ(feed.stats().vessels, 3u);
+}
+
+TEST(WebFeedTest, WireFormatRejectsMalformedFrames) {
+    std::unordered_map<uint32_t, WireFormat::Vessel> vessels;
+    std::vector<uint32_t> updated;
+
+    std::string frame(1, static_cast<char>(WireFormat::VERSION));
+    ASSERT_TRUE(WireFormat::encode(frame, 7, "Alpha", WireFormat::toState(fix("Alpha", 10.0)), nullptr));
+    EXPECT_TRUE(WireFormat::decode(frame, vessels, updated));
+
+    EXPECT_FALSE(WireFormat::decode(frame.substr(0, frame.size() - 1), vessels, updated)); // Truncated
+    EXPECT_FALSE(WireFormat::decode(std::string("\x02", 1), vessels, updated));             // Unknown version
+    std::string orphan(1, static_cast<char>(WireFormat::VERSION));
+    orphan += "\x09\x01\x02"; // Delta for handle 9, never named
+    EXPECT_FALSE(WireFormat::decode(orphan, vessels, updated));
+}
+
+TEST(WebFeedTest, GeoGridQueriesBoxesAcrossCellsAndTheAntimeridian) {
+    GeoGrid grid(1.0);
+    grid.insert(1, 54.30, 10.10);  // Kiel
+    grid.insert(2, 54.35, 10.90);  // Same box, next cell
+    grid.insert(3, 51.90, 4.40);   // Rotterdam
+    grid.insert(4, -17.5, 179.9);  // Fiji, east of the antimeridian...
+    grid.insert(5, -17.5, -179.9); // ...and west of it
+
+    GeoGrid::Box kiel;
+    ASSERT_TRUE(GeoGrid::makeBox(10.0, 54.0, 11.0, 54.5, kiel));
+    std::vector<uint32_t> hits;
+    grid.query(kiel, hits);
+    std::sort(hits.begin(), hits.end());
+    EXPECT_EQ(hits, (std::vector<uint32_t>{1, 2}));
+
+    // A web map scrolled east reports longitudes past 180: wrapped into a crossing box
+    GeoGrid::Box fiji;
+    ASSERT_TRUE(GeoGrid::makeBox(179.0, -18.0, 181.0, -17.0, fiji));
+    EXPECT_GT(fiji.west, fiji.east);
+    hits.clear();
+    grid.query(fiji, hits);
+    std::sort(hits.begin(), hits.end());
+    EXPECT_EQ(hits, (std::vector<uint32_t>{4, 5}));
+
+    // Moving a point takes it out of its old cell; the whole world finds everything
+    grid.insert(1, 51.95, 4.45);
+    hits.clear();
+    grid.query(kiel, hits);
+    EXPECT_EQ(hits, (std::vector<uint32_t>{2}));
+    GeoGrid::Box world;
+    ASSERT_TRUE(GeoGrid::makeBox(-540.0, -90.0, 540.0, 90.0, world));
+    hits.clear();
+    grid.query(world, hits);
+    EXPECT_EQ(hits.size(), 5u);
+}
+
+TEST(WebFeedTest, SubscriptionsRouteByBoxVesselListAndRate) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    cfg.maxInFlight = 100;
+    WebFeed feed(cfg);
+
+    FakeClient all, harbour;
+    all.attach(feed);
+    harbour.attach(feed);
+    auto ids = [](const std::string& frame) {
+        std::vector<std::string> out;
+        for (const auto& v : json::parse(frame)) out.push_back(v["id"]);
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    // 1. Positions known before the subscription
+    feed.publish(fix("Alpha", 54.3));
+    feed.publish(fix("Bravo", 10.0));
+    feed.publish(fix("Charlie", -20.0));
+    feed.flush();
+    ASSERT_EQ(harbour.frames.size(), 1u);
+
+    // 2. Box around Alpha plus Charlie by name: the next tick sends their current state
+    WebFeed::Subscription sub;
+    ASSERT_TRUE(GeoGrid::makeBox(11.0, 54.0, 12.0, 55.0, sub.box));
+    sub.hasBox = true;
+    sub.vessels = {"Charlie"};
+    feed.subscribe(harbour.id, sub);
+    feed.flush();
+    ASSERT_EQ(harbour.frames.size(), 2u);
+    EXPECT_EQ(ids(harbour.frames[1]), (std::vector<std::string>{"Alpha", "Charlie"}));
+    EXPECT_EQ(feed.stats().subscribed, 1u);
+
+    // 3. Only matching updates from here on; the unfiltered client still gets everything
+    feed.publish(fix("Alpha", 54.31));
+    feed.publish(fix("Bravo", 10.1));
+    feed.flush();
+    ASSERT_EQ(harbour.frames.size(), 3u);
+    EXPECT_EQ(ids(harbour.frames[2]), (std::vector<std::string>{"Alpha"}));
+    EXPECT_EQ(ids(all.frames.back()), (std::vector<std::string>{"Alpha", "Bravo"}));
+
+    feed.publish(fix("Bravo", 10.2)); // Outside the box, not followed
+    feed.flush();
+    EXPECT_EQ(harbour.frames.size(), 3u);
+
+    // 4. Rate limit: updates within the interval coalesce into the next frame
+    sub.maxRate = 20; // 50 ms
+    feed.subscribe(harbour.id, sub);
+    feed.flush();     // Re-sends the matching state, starts the interval
+    size_t before = harbour.count();
+    feed.publish(fix("Alpha", 54.32));
+    feed.flush();
+    feed.publish(fix("Alpha", 54.33));
+    feed.flush();
+    EXPECT_EQ(harbour.count(), before);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    feed.flush();
+    ASSERT_EQ(harbour.count(), before + 1);
+    json last = json::parse(harbour.frames.back());
+    ASSERT_EQ(last.size(), 1u);
+    EXPECT_EQ(last[0], json(fix("Alpha", 54.33)));
+
+    // 5. An empty subscription means everything again
+    feed.subscribe(harbour.id, WebFeed::Subscription{});
+    feed.flush();
+    EXPECT_EQ(ids(harbour.frames.back()), (std::vector<std::string>{"Alpha", "Bravo", "Charlie"}));
+    EXPECT_EQ(feed.stats().subscribed, 0u);
+}
+
+TEST(WebFeedTest, UnknownFollowedVesselsTakeNoHandleUntilTheyReport) {
+    WebFeed::Config cfg;
+    cfg.tick = std::chrono::milliseconds(0);
+    WebFeed feed(cfg);
+
+    FakeClient watcher;
+    watcher.attach(feed);
+    feed.publish(fix("Alpha", 10.0));
+    feed.flush();
+
+    // 1. A long, repetitive list of IDs nobody has reported costs no feed state
+    WebFeed::Subscription sub;
+    for (int n = 0; n < 1000; ++n) sub.vessels.push_back("Ghost" + std::to_string(n % 10));
+    sub.vessels.push_back("Delta");
+    sub.vessels.push_back("Delta");
+    feed.subscribe(watcher.id, sub);
+    feed.flush();
+    EXPECT_EQ(feed.stats().vessels, 1u);
+    EXPECT_EQ(watcher.count(), 1u);
+
+    // 2. The vessel's first report resolves it: sent once, however often it was listed
+    feed.publish(fix("Alpha", 10.1));
+    feed.publish(fix("Delta", 40.0));
+    feed.flush();
+    ASSERT_EQ(watcher.count(), 2u);
+    json frame = json::parse(watcher.frames[1]);
+    ASSERT_EQ(frame.size(), 1u);
+    EXPECT_EQ(frame[0], json(fix("Delta", 40.0)));
+
+    feed.publish(fix("Delta", 40.1));
+    feed.flush();
+    ASSERT_EQ(watcher.count(), 3u);
+    EXPECT_EQ(json::parse(watcher.frames[2]).size(), 1u);
+    EXPECT_EQ(feed.stats().vessels, 2u);
+}